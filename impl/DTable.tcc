@@ -137,73 +137,111 @@ namespace mavis
     template <typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
     void DTable<InstType, AnnotationType, AnnotationTypeAllocator>::configure(
         const FileNameListType & isa_files, const MatchSet<Pattern> & inclusions,
-        const MatchSet<Pattern> & exclusions)
+        const MatchSet<Pattern> & exclusions, const OtherEntryConsumer & other_entries)
     {
-        struct parseInstInfoArgs
+        // Stream the ISA files an instruction at a time (no document is built). Only the
+        // expansions and overlays, which are deferred until all base instructions are built, are
+        // kept alive until the end of the configuration
+        std::deque<json_value> deferred_insts;
+        std::vector<DeferredInst_> expansions;
+        TagFilter filter(inclusions, exclusions);
+
+        for (const auto & isa_file : isa_files)
         {
-            const std::string jfile;
-            const json_object inst;
-            const std::string mnemonic;
-            const MatchSet<Tag> tags;
-
-            parseInstInfoArgs(const std::string & jfile, const json_object & inst,
-                              const std::string & mnemonic, const MatchSet<Tag> & tags)
-                : jfile(jfile), inst(inst), mnemonic(mnemonic), tags(tags)
-            {}
-        };
-
-        std::vector<parseInstInfoArgs> expansions;
-
-        for (const auto & jfile : isa_files)
-        {
-            const auto json = parseJSONWithException<BadISAFile>(jfile);
+            forEachJSONArrayElementWithException<BadISAFile>(
+                isa_file,
+                [&](json_value & inst_value)
+                {
 #ifdef USE_NLOHMANN_JSON
-            const auto& jobj = json;
+                    const bool is_inst = inst_value.contains("mnemonic");
+                    const bool deferrable =
+                        inst_value.contains("expand") || inst_value.contains("overlay");
 #else
-            const auto& jobj = json.as_array();
+                    const auto & inst_obj = inst_value.as_object();
+                    const bool is_inst = inst_obj.contains("mnemonic");
+                    const bool deferrable =
+                        inst_obj.contains("expand") || inst_obj.contains("overlay");
 #endif
-
-            for (const auto & inst_value : jobj)
-            {
+                    if (!is_inst)
+                    {
+                        if (other_entries)
+                        {
+                            other_entries(inst_value);
+                        }
+                        return;
+                    }
+                    const json_value & inst =
+                        deferrable ? deferred_insts.emplace_back(std::move(inst_value)) : inst_value;
 #ifdef USE_NLOHMANN_JSON
-                const auto& inst = inst_value;
+                    configureInst_(isa_file, inst, filter, expansions);
 #else
-                const auto& inst = inst_value.as_object();
+                    configureInst_(isa_file, inst.as_object(), filter, expansions);
 #endif
-                std::string mnemonic;
+                });
+        }
+
+        for (auto & exp : expansions)
+        {
+            parseInstInfo_(exp.jfile, exp.inst, exp.mnemonic, exp.tags);
+        }
+        builder_->freezeLookups();
+    }
+
+    template <typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
+    void DTable<InstType, AnnotationType, AnnotationTypeAllocator>::configureInst_(
+        const std::string & jfile, const json_object & inst, TagFilter & filter,
+        std::vector<DeferredInst_> & expansions)
+    {
+        std::string mnemonic;
 #ifdef USE_NLOHMANN_JSON
-                if (inst.contains("mnemonic"))
-                {
-                    mnemonic = inst["mnemonic"].get<std::string>();
-                    MatchSet<Tag> tags;
-                    if (inst.contains("tags"))
-                    {
-                        tags = MatchSet<Tag>(inst["tags"].get<std::vector<std::string>>());
+        if (inst.contains("mnemonic"))
+        {
+            mnemonic = inst["mnemonic"].get<std::string>();
+            MatchSet<Tag> tags;
+            if (inst.contains("tags"))
+            {
+                tags = MatchSet<Tag>(inst["tags"].get<std::vector<std::string>>());
 #else
-                if (const auto it = inst.find("mnemonic"); it != inst.end())
-                {
-                    mnemonic = boost::json::value_to<std::string>(it->value());
-                    MatchSet<Tag> tags;
-                    if (const auto tag_it = inst.find("tags"); tag_it != inst.end())
-                    {
-                        tags = MatchSet<Tag>(boost::json::value_to<std::vector<std::string>>(tag_it->value()));
+        if (const auto it = inst.find("mnemonic"); it != inst.end())
+        {
+            mnemonic = boost::json::value_to<std::string>(it->value());
+            MatchSet<Tag> tags;
+            if (const auto tag_it = inst.find("tags"); tag_it != inst.end())
+            {
+                tags = MatchSet<Tag>(boost::json::value_to<std::vector<std::string>>(tag_it->value()));
 #endif
 
-                    }
+            }
 
-                    const bool is_expansion =
+            const bool is_expansion =
 #ifdef USE_NLOHMANN_JSON
-                        inst.contains("expand");
-                    const bool is_overlay = inst.contains("overlay");
+                inst.contains("expand");
+            const bool is_overlay = inst.contains("overlay");
 #else
-                        inst.find("expand") != inst.end();
-                    const bool is_overlay = inst.find("overlay") != inst.end();
+                inst.find("expand") != inst.end();
+            const bool is_overlay = inst.find("overlay") != inst.end();
 #endif
 
-                    if ((inclusions.isEmpty() && exclusions.isEmpty())
-                        || (inclusions.isEmpty() && tags.isEmpty()))
+            if (filter.isEmpty() || (!filter.hasInclusions() && tags.isEmpty()))
+            {
+                if (!is_expansion && !is_overlay)
+                {
+                    parseInstInfo_(jfile, inst, mnemonic, tags);
+                }
+                else
+                {
+                    expansions.emplace_back(jfile, inst, mnemonic, tags);
+                }
+            }
+            else if (!tags.isEmpty())
+            {
+                bool included = !filter.hasInclusions() || filter.isIncluded(tags);
+                if (included)
+                {
+                    bool excluded = filter.hasExclusions() && filter.isExcluded(tags);
+                    if (!excluded)
                     {
-                        if (!is_expansion && !is_overlay)
+                        if (!is_expansion)
                         {
                             parseInstInfo_(jfile, inst, mnemonic, tags);
                         }
@@ -212,54 +250,30 @@ namespace mavis
                             expansions.emplace_back(jfile, inst, mnemonic, tags);
                         }
                     }
-                    else if (!tags.isEmpty())
-                    {
-                        bool included = inclusions.isEmpty() || tags.matchAnyAny(inclusions);
-                        if (included)
-                        {
-                            bool excluded = !exclusions.isEmpty() && tags.matchAnyAny(exclusions);
-                            if (!excluded)
-                            {
-                                if (!is_expansion)
-                                {
-                                    parseInstInfo_(jfile, inst, mnemonic, tags);
-                                }
-                                else
-                                {
-                                    expansions.emplace_back(jfile, inst, mnemonic, tags);
-                                }
-                            }
-                        }
-                    }
                 }
+            }
+        }
 #ifdef USE_NLOHMANN_JSON
-                else if (inst.contains("pseudo"))
+        else if (inst.contains("pseudo"))
 #else
-                else if (inst.find("pseudo") != inst.end())
+        else if (inst.find("pseudo") != inst.end())
 #endif
-                {
-                    continue;
-                }
-                else
-                {
+        {
+            return;
+        }
+        else
+        {
 #ifdef USE_NLOHMANN_JSON
-                    if (inst.contains("stencil"))
-                    {
-                        throw BuildErrorMissingMnemonic(jfile, inst["stencil"].get<std::string>());
+            if (inst.contains("stencil"))
+            {
+                throw BuildErrorMissingMnemonic(jfile, inst["stencil"].get<std::string>());
 #else
-                    if (const auto stencil_it = inst.find("stencil"); stencil_it != inst.end())
-                    {
-                        throw BuildErrorMissingMnemonic(jfile, boost::json::value_to<std::string>(stencil_it->value()));
+            if (const auto stencil_it = inst.find("stencil"); stencil_it != inst.end())
+            {
+                throw BuildErrorMissingMnemonic(jfile, boost::json::value_to<std::string>(stencil_it->value()));
 #endif
-                    }
-                    throw BuildErrorMissingMnemonic(jfile);
-                }
             }
-        }
-
-        for (auto & exp : expansions)
-        {
-            parseInstInfo_(exp.jfile, exp.inst, exp.mnemonic, exp.tags);
+            throw BuildErrorMissingMnemonic(jfile);
         }
     }
 
@@ -414,6 +428,124 @@ namespace mavis
                           override_extractor, einfo, shared_ifact);
     }
 
+    template <typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
+    std::vector<typename DTable<InstType, AnnotationType, AnnotationTypeAllocator>::DecodeRoute>
+    DTable<InstType, AnnotationType, AnnotationTypeAllocator>::getDecodeRoutes() const
+    {
+        const auto root = std::dynamic_pointer_cast<RootType>(root_);
+        assert(root != nullptr);
+
+        std::vector<DecodeRoute> routes;
+        for (uint32_t family = 0; family < PseudoForm<'*'>::NUM_FAMILIES; ++family)
+        {
+            const auto & node = (root->getMatchNode(family) != nullptr) ? root->getMatchNode(family)
+                                                                        : root->getDefault();
+            if (node != nullptr)
+            {
+                flattenRoutes_(node, family, 0, 0, routes);
+            }
+        }
+        return routes;
+    }
+
+    template <typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
+    void DTable<InstType, AnnotationType, AnnotationTypeAllocator>::flattenRoutes_(
+        const typename IFactoryIF<InstType, AnnotationType>::PtrType & node, uint32_t family,
+        Opcode mask, Opcode value, std::vector<DecodeRoute> & routes) const
+    {
+        using SpecialCaseType = IFactorySpecialCaseComposite<InstType, AnnotationType>;
+        using DenseType = IFactoryDenseComposite<InstType, AnnotationType>;
+
+        if (const auto scnode = std::dynamic_pointer_cast<SpecialCaseType>(node))
+        {
+            for (const auto & entry : scnode->getSpecialCases())
+            {
+                routes.push_back({family, mask | entry.mask, value | entry.value, entry.mnemonic,
+                                  entry.factory, entry.extractor});
+            }
+            const auto & dflt = scnode->getDefaultCase();
+            if (dflt.factory != nullptr)
+            {
+                routes.push_back({family, mask, value, dflt.mnemonic, dflt.factory, dflt.extractor});
+            }
+        }
+        else if (const auto dnode = std::dynamic_pointer_cast<DenseType>(node))
+        {
+            const Field & field = *dnode->getField();
+            const Opcode fmask = field.getShiftedMask();
+            for (uint32_t index = 0; index < field.getSize(); ++index)
+            {
+                const auto & child = dnode->getChild(index);
+                if (child != nullptr)
+                {
+                    // Place the index bits back at their opcode positions (fields may be
+                    // concatenations of sub-fields, so find where each opcode bit extracts to)
+                    Opcode fvalue = 0;
+                    for (uint32_t bit = 0; bit < (sizeof(Opcode) * 8); ++bit)
+                    {
+                        const Opcode obit = Opcode(1) << bit;
+                        if (((fmask & obit) != 0) && ((field.extract(obit) & index) != 0))
+                        {
+                            fvalue |= obit;
+                        }
+                    }
+                    flattenRoutes_(child, family, mask | fmask, value | fvalue, routes);
+                }
+            }
+            if (dnode->getDefault() != nullptr)
+            {
+                flattenRoutes_(dnode->getDefault(), family, mask, value, routes);
+            }
+        }
+        else
+        {
+            throw DTableLookupError(value, node->getName());
+        }
+    }
+
+    template <typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
+    void DTable<InstType, AnnotationType, AnnotationTypeAllocator>::shareNodes(
+        DecodeNodePool<InstType, AnnotationType> & pool)
+    {
+        const auto root = std::dynamic_pointer_cast<RootType>(root_);
+        assert(root != nullptr);
+
+        typename DecodeNodePool<InstType, AnnotationType>::ReplacementMap replaced;
+        root->replaceChildren(
+            [&pool, &replaced](const typename IFactoryIF<InstType, AnnotationType>::PtrType & node)
+            { return pool.share(node, replaced); });
+        builder_->replaceIFactories(replaced);
+    }
+
+    template <typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
+    uint64_t DTable<InstType, AnnotationType, AnnotationTypeAllocator>::getFingerprint() const
+    {
+        if (fingerprint_ == 0)
+        {
+            // FNV-1a
+            uint64_t hash = 0xcbf29ce484222325ull;
+            const auto mix = [&hash](uint64_t value)
+            {
+                for (uint32_t i = 0; i < 8; ++i, value >>= 8)
+                {
+                    hash = (hash ^ (value & 0xff)) * 0x100000001b3ull;
+                }
+            };
+            for (const auto & route : getDecodeRoutes())
+            {
+                mix(route.family);
+                mix(route.mask);
+                mix(route.value);
+                for (const char c : route.mnemonic)
+                {
+                    hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+                }
+            }
+            fingerprint_ = (hash != 0) ? hash : 1;
+        }
+        return fingerprint_;
+    }
+
 } // namespace mavis
 
 #endif // TCC_MAVIS_DTABLE
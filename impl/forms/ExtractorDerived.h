@@ -142,31 +142,28 @@ namespace mavis
             return getSourceRegs(icode);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_C0::idType::RD, icode & ~fixed_field_mask_) << ","
                << extractCompressedRegister_(Form_C0::idType::RS1, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_C0::idType::RD, InstMetaData::OperandFieldID::RD},
                        {Form_C0::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -508,31 +505,28 @@ namespace mavis
             return {};
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_C0::idType::RD, icode & ~fixed_field_mask_) << ","
                << extractCompressedRegister_(Form_C0::idType::RS1, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_C0::idType::RD, InstMetaData::OperandFieldID::RS2},
                        {Form_C0::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -837,29 +831,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_C1::idType::RD, icode & ~fixed_field_mask_) << ","
                << extractCompressedRegister_(Form_C1::idType::RS1, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_C1::idType::RD, InstMetaData::OperandFieldID::RD},
                        {Form_C1::idType::RS1, InstMetaData::OperandFieldID::RS1}});
-            return ss.str();
         }
 
         // clang-format on
@@ -1238,28 +1229,25 @@ namespace mavis
             return Swizzler::extract(imm, R{3}, R{2}, R{6, 9}, R{4, 5});
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extractCompressedRegister_(Form_CIW::idType::RD, icode)
+            os << mnemonic << "\t" << extractCompressedRegister_(Form_CIW::idType::RD, icode)
                << ", SP, IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CIW::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", SP, IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -1356,14 +1344,13 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << "x1, +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
+            os << mnemonic << "\t" << "x1, +0x" << std::hex << getSignedOffset(icode);
         }
 
       private:
@@ -1454,28 +1441,25 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t " << REGISTER_LINK << ", "
+            os << mnemonic << "\t " << REGISTER_LINK << ", "
                << extract_(Form_CJR::idType::RS1, icode) << ", IMM=" << std::dec
                << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t x" << REGISTER_LINK << ", "
+            os << mnemonic << "\t x" << REGISTER_LINK << ", "
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_CJR::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -1556,29 +1540,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_C2::idType::RS1, icode & ~fixed_field_mask_) << ","
                << extract_(Form_C2::idType::RS2, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_C2::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_C2::idType::RS1, InstMetaData::OperandFieldID::RS1},
                                       {Form_C2::idType::RS2, InstMetaData::OperandFieldID::RS2}});
-            return ss.str();
         }
 
         // clang-format on
@@ -1659,29 +1640,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode) << ", "
+            os << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode) << ", "
                << extract_(Form_C2::idType::RS2, icode); // RS2 == RS
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_C2::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", "
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_C2::idType::RS2, InstMetaData::OperandFieldID::RS2}});
-            return ss.str();
         }
 
         // clang-format on
@@ -1760,29 +1738,26 @@ namespace mavis
                    | extract_(Form_C2::idType::SHAMT5, icode);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_C2::idType::RS1, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_C2::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_C2::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -1860,27 +1835,24 @@ namespace mavis
 
         ImmediateType getImmediateType() const override { return ImmediateType::UNSIGNED; }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode)
+            os << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode)
                << ", SP, IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_C2::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", SP, IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2323,29 +2295,26 @@ namespace mavis
             return signExtend_(getImmediate(icode), 17);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extract_(Form_CI_rD_only::idType::RD, icode & ~fixed_field_mask_) << ", +0x"
                << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CI_rD_only::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2475,37 +2444,33 @@ namespace mavis
         OperandInfo getDestOperandInfo(Opcode icode, const InstMetaData::PtrType & meta,
                                        bool suppress_x0 = false) const override
         {
+            // Dests are always a0 and a1
+            const auto op_type = meta->getOperandType(InstMetaData::OperandFieldID::RD1);
+
             OperandInfo olist;
-            appendUnmaskedCompressedOperandInfo_(olist, icode, meta,
-                                                 InstMetaData::OperandFieldID::RD1,
-                                                 fixed_field_mask_, Form_CA::idType::RS1, false);
-            appendUnmaskedCompressedOperandInfo_(olist, icode, meta,
-                                                 InstMetaData::OperandFieldID::RD2,
-                                                 fixed_field_mask_, Form_CA::idType::RS2, false);
+            olist.addElement(InstMetaData::OperandFieldID::RD1, op_type, 10, false);
+            olist.addElement(InstMetaData::OperandFieldID::RD2, op_type, 11, false);
             return olist;
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_CA::idType::RS1, icode & ~fixed_field_mask_)
                << ", "
                << extractCompressedRegister_(Form_CA::idType::RS2, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CA::idType::RS1, InstMetaData::OperandFieldID::RS1},
                        {Form_CA::idType::RS2, InstMetaData::OperandFieldID::RS2}});
-            return ss.str();
         }
 
         // clang-format on
@@ -2685,33 +2650,31 @@ namespace mavis
             return {};
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << getVectorMemoryMnemonic(mnemonic, icode) << "\t"
+            os << getVectorMemoryMnemonic(mnemonic, icode) << "\t"
                << "v" << extract_(Form_VF_mem::idType::RS3, icode & ~fixed_field_mask_) << ",x"
                << extract_(Form_VF_mem::idType::RS1, icode & ~fixed_field_mask_);
             if (!isMaskedField_(Form_VF_mem::idType::RS2, fixed_field_mask_))
             {
-                ss << ",v" << extract_(Form_VF_mem::idType::RS2, icode);
+                os << ",v" << extract_(Form_VF_mem::idType::RS2, icode);
             }
             // Show the vm operand if masking mode is on
             if (!isMaskedField_(Form_VF_mem::idType::VM, fixed_field_mask_))
             {
                 if (!extract_(Form_VF_mem::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << getVectorMemoryMnemonic(mnemonic, icode) << "\t"
+            os << getVectorMemoryMnemonic(mnemonic, icode) << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_VF_mem::idType::RS3, InstMetaData::OperandFieldID::RS3},
@@ -2722,10 +2685,9 @@ namespace mavis
             {
                 if (!extract_(Form_VF_mem::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -2828,10 +2790,10 @@ namespace mavis
 
         ImmediateType getImmediateType() const override { return ImmediateType::UNSIGNED; }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
                << ",v" << extract_(Form_V::idType::RS2, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode);
             // Show the vm operand if masking mode is on
@@ -2839,18 +2801,16 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_V::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_V::idType::RS2, InstMetaData::OperandFieldID::RS2}})
@@ -2860,10 +2820,9 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -2903,10 +2862,10 @@ namespace mavis
             return signExtend_(getImmediate(icode), 4);
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
                << ",v" << extract_(Form_V::idType::RS2, icode & ~fixed_field_mask_) << ",0x"
                << std::hex << getSignedOffset(icode);
             // Show the vm operand if masking mode is on
@@ -2914,18 +2873,16 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_V::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_V::idType::RS2, InstMetaData::OperandFieldID::RS2}})
@@ -2935,10 +2892,9 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -2966,10 +2922,10 @@ namespace mavis
 
         std::string getName() const override { return Form_V_op::name; }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
                << ",v" << extract_(Form_V::idType::RS2, icode & ~fixed_field_mask_) << ",v"
                << extract_(Form_V::idType::RS1, icode & ~fixed_field_mask_);
             // Show the vm operand if masking mode is on
@@ -2977,18 +2933,16 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_V::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_V::idType::RS2, InstMetaData::OperandFieldID::RS2},
@@ -2998,10 +2952,9 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -3032,27 +2985,24 @@ namespace mavis
             return getSourceRegs(icode);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_R::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_R::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_R::idType::RS1, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_R::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_R::idType::RS1, InstMetaData::OperandFieldID::RS1}});
-            return ss.str();
         }
 
         // clang-format on
@@ -3133,29 +3083,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extract_(Form_R::idType::RS2, icode & ~fixed_field_mask_) // source data
                << ","
                << extract_(Form_R::idType::RS1, icode & ~fixed_field_mask_); // source address
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_R::idType::RS2, InstMetaData::OperandFieldID::RS2},
                                       {Form_R::idType::RS1, InstMetaData::OperandFieldID::RS1}});
-            return ss.str();
         }
 
         // clang-format on
@@ -3355,18 +3302,18 @@ namespace mavis
 
         std::string getName() const override { return Form_NTL_hint::name; }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode) const override
         {
-            return mnemonic;
+            os << mnemonic;
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            return mnemonic;
+            os << mnemonic;
         }
 
       protected:
@@ -3455,28 +3402,25 @@ namespace mavis
             return signExtend_(getImmediate(icode), 7);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extract_(Form_I::idType::RS1, icode & ~fixed_field_mask_) // base address
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_I::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
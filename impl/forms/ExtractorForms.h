@@ -11,27 +11,38 @@
 
 namespace
 {
-    std::string dasmVsetImmediate(const uint64_t immediate)
+    // vtype immediate of vsetvli/vsetivli (e.g. "e32,m1,ta,ma"), for DasmWriter
+    struct DasmVsetImmediate
+    {
+        uint64_t immediate;
+    };
+
+    mavis::DasmWriter & operator<<(mavis::DasmWriter & ss, const DasmVsetImmediate & vset)
     {
         constexpr uint64_t VTYPE_FIELD_VLMUL = 0x7;
         constexpr uint64_t VTYPE_FIELD_VSEW = 0x38;
         constexpr uint64_t VTYPE_FIELD_VTA = 0x40;
         constexpr uint64_t VTYPE_FIELD_VMA = 0x80;
 
-        std::stringstream ss;
-        ss << "e" << (1 << (3 + ((immediate & VTYPE_FIELD_VSEW) >> 3))) << ",";
+        const uint64_t immediate = vset.immediate;
+        ss << "e";
+        ss.dec(1 << (3 + ((immediate & VTYPE_FIELD_VSEW) >> 3))) << ",";
         if (const auto val = immediate & VTYPE_FIELD_VLMUL; val < 4)
         {
-            ss << "m" << (1 << val) << ",";
+            ss << "m";
+            ss.dec(1 << val) << ",";
         }
         else
         {
-            ss << "mf" << (1 << (8 - val)) << ",";
+            ss << "mf";
+            ss.dec(1 << (8 - val)) << ",";
         }
         ss << ((immediate & VTYPE_FIELD_VTA) ? "ta," : "tu,");
         ss << ((immediate & VTYPE_FIELD_VMA) ? "ma" : "mu");
-        return ss.str();
+        return ss;
     }
+
+    DasmVsetImmediate dasmVsetImmediate(const uint64_t immediate) { return {immediate}; }
 } // namespace
 
 namespace mavis
@@ -166,33 +177,30 @@ namespace mavis
             return 0;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_AMO::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_AMO::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_AMO::idType::RS1, icode & ~fixed_field_mask_) << ","
                << extract_(Form_AMO::idType::RS2, icode & ~fixed_field_mask_)
                << ", aq/wd=" << std::dec << getSpecialField(SpecialField::AQ, icode)
                << ", rl/vm=" << std::dec << getSpecialField(SpecialField::RL, icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_AMO::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_AMO::idType::RS1, InstMetaData::OperandFieldID::RS1},
                                       {Form_AMO::idType::RS2, InstMetaData::OperandFieldID::RS2}})
                << ", aq/wd=" << std::dec << getSpecialField(SpecialField::AQ, icode)
                << ", rl/vm=" << std::dec << getSpecialField(SpecialField::RL, icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -277,29 +285,26 @@ namespace mavis
             return signExtend_(getImmediate(icode), 12);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_B::idType::RS1, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_B::idType::RS1, icode & ~fixed_field_mask_)
                << "," << extract_(Form_B::idType::RS2, icode & ~fixed_field_mask_) << " +0x"
                << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_B::idType::RS1, InstMetaData::OperandFieldID::RS1},
                                       {Form_B::idType::RS2, InstMetaData::OperandFieldID::RS2}})
                << " +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -400,29 +405,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_C0::idType::RD, icode & ~fixed_field_mask_) << ","
                << extractCompressedRegister_(Form_C0::idType::RS1, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_C0::idType::RD, InstMetaData::OperandFieldID::RD},
                        {Form_C0::idType::RS1, InstMetaData::OperandFieldID::RS1}});
-            return ss.str();
         }
 
         // clang-format on
@@ -525,27 +527,24 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_C2::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_C2::idType::RS, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_C2::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_C2::idType::RS, InstMetaData::OperandFieldID::RS1}});
-            return ss.str();
         }
 
         // clang-format on
@@ -636,29 +635,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const uint64_t icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extract_(Form_C2_sp_store::idType::RS2, icode & ~fixed_field_mask_)
                << ", SP, IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_C2_sp_store::idType::RS2, InstMetaData::OperandFieldID::RS2}})
                << ", SP, IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -775,33 +771,30 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_CA::idType::RD, icode & ~fixed_field_mask_)
                << ", "
                << extractCompressedRegister_(Form_CA::idType::RS1, icode & ~fixed_field_mask_)
                << ", "
                << extractCompressedRegister_(Form_CA::idType::RS2, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CA::idType::RD, InstMetaData::OperandFieldID::RD},
                        {Form_CA::idType::RS1, InstMetaData::OperandFieldID::RS1},
                        {Form_CA::idType::RS2, InstMetaData::OperandFieldID::RS2}});
-            return ss.str();
         }
 
         // clang-format on
@@ -886,29 +879,26 @@ namespace mavis
             return signExtend_(getImmediate(icode), 8);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_CB::idType::RS1, icode & ~fixed_field_mask_)
                << ", 0, +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CB::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", x0, +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -1018,34 +1008,31 @@ namespace mavis
             return signExtend_(getImmediate(icode), 5);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_CI::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_CI::idType::RD, icode & ~fixed_field_mask_)
                << ", " << extract_(Form_CI::idType::RS1, icode & ~fixed_field_mask_) << ", +0x"
                << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_CI::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_CI::idType::RS1, InstMetaData::OperandFieldID::RS1}});
             if ((!isMaskedField_(Form_CI::idType::RD, fixed_field_mask_))
                 || (!isMaskedField_(Form_CI::idType::RS1, fixed_field_mask_)))
             {
-                ss << ", ";
+                os << ", ";
             }
-            ss << "+0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
+            os << "+0x" << std::hex << getSignedOffset(icode);
         }
 
         // clang-format on
@@ -1175,29 +1162,26 @@ namespace mavis
             return signExtend_(getImmediate(icode), 5);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extract_(Form_CI_rD_only::idType::RD, icode & ~fixed_field_mask_) << ", 0, +0x"
                << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CI_rD_only::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", x0, +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -1265,31 +1249,28 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_CIW::idType::RD, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec
                << extract_(Form_CIW::idType::IMM8, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CIW::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", IMM=" << std::dec
                << extract_(Form_CIW::idType::IMM8, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format on
@@ -1404,29 +1385,26 @@ namespace mavis
                    | extract_(Form_CIX::idType::SHAMT5, icode);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extractCompressedRegister_(Form_CIX::idType::RD, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatCompressedRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_CIX::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", IMM=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -1515,14 +1493,13 @@ namespace mavis
             return signExtend_(getImmediate(icode), 11);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << "x0, +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
+            os << mnemonic << "\t" << "x0, +0x" << std::hex << getSignedOffset(icode);
         }
 
       protected:
@@ -1626,26 +1603,23 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t0, "
+            os << mnemonic << "\t0, "
                << extract_(Form_CJR::idType::RS1, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tx0, "
+            os << mnemonic << "\tx0, "
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_CJR::idType::RS1, InstMetaData::OperandFieldID::RS1}});
-            return ss.str();
         }
 
         // clang-format on
@@ -1745,32 +1719,29 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << '\t';
-            formatRList_(ss, icode, [&ss](const uint64_t urlist) {
-                ss << getRListRangeEnd_(urlist);
+            os << mnemonic << '\t';
+            formatRList_(os, icode, [&os](const uint64_t urlist) {
+                os << getRListRangeEnd_(urlist);
             });
-            ss << ", " << getSignedOffset(icode);
-            return ss.str();
+            os << ", " << getSignedOffset(icode);
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << '\t';
-            formatRList_(ss, icode, [&ss, &meta, op_id = getFirstOperandID_()](const uint64_t urlist) mutable {
-                ss << dasmFormatReg_(meta, op_id, getRListRangeEnd_(urlist));
+            os << mnemonic << '\t';
+            formatRList_(os, icode, [&os, &meta, op_id = getFirstOperandID_()](const uint64_t urlist) mutable {
+                os << dasmFormatReg_(meta, op_id, getRListRangeEnd_(urlist));
                 op_id = incrementFieldID_(op_id);
             });
-            ss << ", " << getStackAdj_(icode, meta);
-            return ss.str();
+            os << ", " << getStackAdj_(icode, meta);
         }
 
         // clang-format on
@@ -1798,7 +1769,7 @@ namespace mavis
         }
 
         template<typename FormatFunc>
-        static void formatRList_(std::stringstream& ss, const Opcode icode, FormatFunc&& format_func)
+        static void formatRList_(DasmWriter& ss, const Opcode icode, FormatFunc&& format_func)
         {
             const auto urlist = extract_(Form_CMPP::idType::URLIST, icode);
 
@@ -1971,14 +1942,13 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << (isJALT_(icode) ? jalt_mnemonic_ : mnemonic) << '\t' << getImmediate(icode);
-            return ss.str();
+            os << (isJALT_(icode) ? jalt_mnemonic_ : mnemonic) << '\t' << getImmediate(icode);
         }
 
       protected:
@@ -2109,29 +2079,26 @@ namespace mavis
             return 0;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_CSR::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_CSR::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_CSR::idType::RS1, icode & ~fixed_field_mask_) << ", CSR=0x"
                << std::hex << getSpecialField(SpecialField::CSR, icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_CSR::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_CSR::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", CSR=0x" << std::hex << getSpecialField(SpecialField::CSR, icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2226,29 +2193,26 @@ namespace mavis
             return 0;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_CSRI::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_CSRI::idType::RD, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode) << ", CSR=0x" << std::hex
                << getSpecialField(SpecialField::CSR, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_CSRI::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", IMM=" << std::dec << getImmediate(icode) << ", CSR=0x" << std::hex
                << getSpecialField(SpecialField::CSR, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format on
@@ -2378,33 +2342,30 @@ namespace mavis
             return 0;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_FENCE::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_FENCE::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_FENCE::idType::RS1, icode & ~fixed_field_mask_) << ", fm=0x"
                << std::hex << getSpecialField(SpecialField::FM, icode) << ", pred=0x" << std::hex
                << getSpecialField(SpecialField::PRED, icode) << ", succ=0x" << std::hex
                << getSpecialField(SpecialField::SUCC, icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_FENCE::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_FENCE::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", fm=0x" << std::hex << getSpecialField(SpecialField::FM, icode) << ", pred=0x"
                << std::hex << getSpecialField(SpecialField::PRED, icode) << ", succ=0x" << std::hex
                << getSpecialField(SpecialField::SUCC, icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2513,29 +2474,26 @@ namespace mavis
             return signExtend_(getImmediate(icode), 11);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_I::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_I::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_I::idType::RS1, icode & ~fixed_field_mask_) << ", +0x"
                << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_I::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_I::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2644,35 +2602,32 @@ namespace mavis
             return extract_(Form_ISH::idType::SHAMT, icode);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_ISH::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_ISH::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_ISH::idType::RS1, icode & ~fixed_field_mask_);
             if (!isMaskedField_(Form_ISH::idType::SHAMT, fixed_field_mask_))
             {
-                ss << ", SHAMT=" << std::dec << getImmediate(icode);
+                os << ", SHAMT=" << std::dec << getImmediate(icode);
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_ISH::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_ISH::idType::RS1, InstMetaData::OperandFieldID::RS1}});
             if (!isMaskedField_(Form_ISH::idType::SHAMT, fixed_field_mask_))
             {
-                ss << ", SHAMT=" << std::dec << getImmediate(icode);
+                os << ", SHAMT=" << std::dec << getImmediate(icode);
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -2776,29 +2731,26 @@ namespace mavis
             return extract_(Form_ISHW::idType::SHAMTW, icode);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_ISHW::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_ISHW::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_ISHW::idType::RS1, icode & ~fixed_field_mask_)
                << ", SHAMTW=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_ISHW::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_ISHW::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", SHAMTW=" << std::dec << getImmediate(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2874,27 +2826,24 @@ namespace mavis
             return signExtend_(getImmediate(icode), 20);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_J::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_J::idType::RD, icode & ~fixed_field_mask_)
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_J::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -2999,29 +2948,26 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_R::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_R::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_R::idType::RS1, icode & ~fixed_field_mask_) << ","
                << extract_(Form_R::idType::RS2, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_R::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_R::idType::RS1, InstMetaData::OperandFieldID::RS1},
                                       {Form_R::idType::RS2, InstMetaData::OperandFieldID::RS2}});
-            return ss.str();
         }
 
         // clang-format on
@@ -3152,29 +3098,27 @@ namespace mavis
             return 0;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_Rfloat::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_Rfloat::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_Rfloat::idType::RS1, icode & ~fixed_field_mask_) << ","
                << extract_(Form_Rfloat::idType::RS2, icode & ~fixed_field_mask_);
             // Show the rm operand if field is not fixed (part of the encoding)
             if (!isMaskedField_(Form_Rfloat::idType::RM, fixed_field_mask_))
             {
-                ss << ", RM=" << getSpecialField(SpecialField::RM, icode);
+                os << ", RM=" << getSpecialField(SpecialField::RM, icode);
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_Rfloat::idType::RD, InstMetaData::OperandFieldID::RD},
@@ -3183,9 +3127,8 @@ namespace mavis
             // Show the rm operand if field is not fixed (part of the encoding)
             if (!isMaskedField_(Form_Rfloat::idType::RM, fixed_field_mask_))
             {
-                ss << ", RM=" << getSpecialField(SpecialField::RM, icode);
+                os << ", RM=" << getSpecialField(SpecialField::RM, icode);
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -3323,30 +3266,28 @@ namespace mavis
             return 0;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_R4::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_R4::idType::RD, icode & ~fixed_field_mask_)
                << "," << extract_(Form_R4::idType::RS1, icode & ~fixed_field_mask_) << ","
                << extract_(Form_R4::idType::RS2, icode & ~fixed_field_mask_) << ","
                << extract_(Form_R4::idType::RS3, icode & ~fixed_field_mask_);
             // Show the rm operand if field is not fixed (part of the encoding)
             if (!isMaskedField_(Form_R4::idType::RM, fixed_field_mask_))
             {
-                ss << ", RM=" << getSpecialField(SpecialField::RM, icode);
+                os << ", RM=" << getSpecialField(SpecialField::RM, icode);
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_R4::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_R4::idType::RS1, InstMetaData::OperandFieldID::RS1},
@@ -3355,9 +3296,8 @@ namespace mavis
             // Show the rm operand if field is not fixed (part of the encoding)
             if (!isMaskedField_(Form_R4::idType::RM, fixed_field_mask_))
             {
-                ss << ", RM=" << getSpecialField(SpecialField::RM, icode);
+                os << ", RM=" << getSpecialField(SpecialField::RM, icode);
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -3450,30 +3390,27 @@ namespace mavis
             return olist;
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << extract_(Form_S::idType::RS2, icode & ~fixed_field_mask_)        // source data
                << "," << extract_(Form_S::idType::RS1, icode & ~fixed_field_mask_) // base address
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_S::idType::RS2, InstMetaData::OperandFieldID::RS2},
                                       {Form_S::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -3545,27 +3482,24 @@ namespace mavis
             return signExtend_(getImmediate(icode), 31);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t" << extract_(Form_U::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\t" << extract_(Form_U::idType::RD, icode & ~fixed_field_mask_)
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_U::idType::RD, InstMetaData::OperandFieldID::RD}})
                << ", +0x" << std::hex << getSignedOffset(icode);
-            return ss.str();
         }
 
         // clang-format on
@@ -3702,10 +3636,10 @@ namespace mavis
             return 0;
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
+            os << mnemonic << "\tv" << extract_(Form_V::idType::RD, icode & ~fixed_field_mask_)
                << ",v" << extract_(Form_V::idType::RS1, icode & ~fixed_field_mask_) << ",v"
                << extract_(Form_V::idType::RS2, icode & ~fixed_field_mask_);
             // Show the vm operand if masking mode is on
@@ -3713,18 +3647,16 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(meta, icode, fixed_field_mask_,
                                      {{Form_V::idType::RD, InstMetaData::OperandFieldID::RD},
                                       {Form_V::idType::RS1, InstMetaData::OperandFieldID::RS1},
@@ -3734,10 +3666,9 @@ namespace mavis
             {
                 if (!extract_(Form_V::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -3891,7 +3822,27 @@ namespace mavis
             return 0;
         }
 
-        std::string getVectorMemoryMnemonic(const std::string & mnemonic, const Opcode icode) const
+        // Mnemonic with the segment count (if any) inserted, for DasmWriter
+        struct VectorMemoryMnemonic
+        {
+            const std::string & mnemonic;
+            const size_t seg_pos; // std::string::npos if not a segment access
+            const uint64_t nf;
+
+            friend DasmWriter & operator<<(DasmWriter & os, const VectorMemoryMnemonic & vmm)
+            {
+                if (vmm.seg_pos == std::string::npos)
+                {
+                    return os << vmm.mnemonic;
+                }
+                const std::string_view mnemonic(vmm.mnemonic);
+                os << mnemonic.substr(0, vmm.seg_pos) << "seg";
+                return os.dec(vmm.nf + 1) << mnemonic.substr(vmm.seg_pos);
+            }
+        };
+
+        VectorMemoryMnemonic getVectorMemoryMnemonic(const std::string & mnemonic,
+                                                     const Opcode icode) const
         {
             constexpr auto MEWOP_UNITSTRIDE = 0;
             constexpr auto MEWOP_UNORDERED_INDEX = 1;
@@ -3905,30 +3856,27 @@ namespace mavis
                     switch (extract_(Form_VF_mem::idType::MEWOP, icode))
                     {
                         case MEWOP_UNITSTRIDE:
-                            return mnemonic.substr(0, 2) + "seg" + std::to_string(nf + 1)
-                                   + mnemonic.substr(2, std::string::npos);
+                            return {mnemonic, 2, nf};
                         case MEWOP_UNORDERED_INDEX:
                         case MEWOP_ORDERED_INDEX:
-                            return mnemonic.substr(0, 4) + "seg" + std::to_string(nf + 1)
-                                   + mnemonic.substr(4, std::string::npos);
+                            return {mnemonic, 4, nf};
                         case MEWOP_STRIDE:
-                            return mnemonic.substr(0, 3) + "seg" + std::to_string(nf + 1)
-                                   + mnemonic.substr(3, std::string::npos);
+                            return {mnemonic, 3, nf};
                         default:
                             throw UnsupportedExtractorSpecialFieldID("MEWOP", icode);
                     }
                 }
             }
-            return mnemonic;
+            return {mnemonic, std::string::npos, 0};
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << getVectorMemoryMnemonic(mnemonic, icode) << "\tv"
+            os << getVectorMemoryMnemonic(mnemonic, icode) << "\tv"
                << extract_(Form_VF_mem::idType::RD, icode & ~fixed_field_mask_) << ",v"
                << extract_(Form_VF_mem::idType::RS1, icode & ~fixed_field_mask_) << ",v"
                << extract_(Form_VF_mem::idType::RS2, icode & ~fixed_field_mask_);
@@ -3937,18 +3885,16 @@ namespace mavis
             {
                 if (!extract_(Form_VF_mem::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << getVectorMemoryMnemonic(mnemonic, icode) << "\t"
+            os << getVectorMemoryMnemonic(mnemonic, icode) << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_VF_mem::idType::RD, InstMetaData::OperandFieldID::RD},
@@ -3959,10 +3905,9 @@ namespace mavis
             {
                 if (!extract_(Form_VF_mem::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -4095,28 +4040,25 @@ namespace mavis
             return extract_(Form_V_vsetvli::idType::IMM11, icode & ~fixed_field_mask_);
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tx"
+            os << mnemonic << "\tx"
                << extract_(Form_V_vsetvli::idType::RD, icode & ~fixed_field_mask_) << ",x"
                << extract_(Form_V_vsetvli::idType::RS1, icode & ~fixed_field_mask_) << ", "
                << dasmVsetImmediate(getImmediate(icode));
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_V_vsetvli::idType::RD, InstMetaData::OperandFieldID::RD},
                        {Form_V_vsetvli::idType::RS1, InstMetaData::OperandFieldID::RS1}})
                << ", " << dasmVsetImmediate(getImmediate(icode));
-            return ss.str();
         }
 
         // clang-format on
@@ -4209,17 +4151,16 @@ namespace mavis
             return extract_(Form_V_vsetivli::idType::IMM10, icode & ~fixed_field_mask_);
         }
 
-        using ExtractorIF::dasmString; // tell the compiler all dasmString
+        using ExtractorIF::dasmTo;     // tell the compiler all dasmTo
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tx"
+            os << mnemonic << "\tx"
                << extract_(Form_V_vsetivli::idType::RD, icode & ~fixed_field_mask_)
                << ",avl=" << std::dec << getSpecialField(SpecialField::AVL, icode) << ", "
                << dasmVsetImmediate(getImmediate(icode));
-            return ss.str();
         }
 
       private:
@@ -4351,28 +4292,25 @@ namespace mavis
             return 0;
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tx"
+            os << mnemonic << "\tx"
                << extract_(Form_V_vsetvl::idType::RD, icode & ~fixed_field_mask_) << ",x"
                << extract_(Form_V_vsetvl::idType::RS1, icode & ~fixed_field_mask_) << ",x"
                << extract_(Form_V_vsetvl::idType::RS2, icode & ~fixed_field_mask_);
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_V_vsetvl::idType::RD, InstMetaData::OperandFieldID::RD},
                        {Form_V_vsetvl::idType::RS1, InstMetaData::OperandFieldID::RS1},
                        {Form_V_vsetvl::idType::RS2, InstMetaData::OperandFieldID::RS2}});
-            return ss.str();
         }
 
         // clang-format on
@@ -4505,10 +4443,10 @@ namespace mavis
             return 0;
         }
 
-        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\tv"
+            os << mnemonic << "\tv"
                << extract_(Form_V_uimm6::idType::RD, icode & ~fixed_field_mask_) << ",v"
                << extract_(Form_V_uimm6::idType::RS2, icode & ~fixed_field_mask_)
                << ", IMM=" << std::dec << getImmediate(icode);
@@ -4517,18 +4455,16 @@ namespace mavis
             {
                 if (!extract_(Form_V_uimm6::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format off
-        std::string dasmString(const std::string & mnemonic, const Opcode icode,
-                               const InstMetaData::PtrType & meta) const override
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType & meta) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t"
+            os << mnemonic << "\t"
                << dasmFormatRegList_(
                       meta, icode, fixed_field_mask_,
                       {{Form_V_uimm6::idType::RD, InstMetaData::OperandFieldID::RD},
@@ -4539,10 +4475,9 @@ namespace mavis
             {
                 if (!extract_(Form_V_uimm6::idType::VM, icode))
                 {
-                    ss << ",v0.t";
+                    os << ",v0.t";
                 }
             }
-            return ss.str();
         }
 
         // clang-format on
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <set>
+#include <string_view>
+#include <vector>
 #include <fstream>
 #include <algorithm>
 #include <cctype>
@@ -25,6 +28,19 @@
 
 namespace mavis {
 
+/**
+ * \brief When AnnotationRegistry constructs the AnnotationType objects
+ *
+ * EAGER: every annotation in the files is constructed (and updated) at load
+ * LAZY:  the annotation JSON is indexed by mnemonic at load, and the AnnotationType object is
+ *        constructed (and updated) on its first findAnnotation()
+ */
+enum class AnnotationLoadMode
+{
+    EAGER,
+    LAZY
+};
+
 template<typename AnnotationType, typename AnnotationTypeAllocator>
 class AnnotationRegistry
 {
@@ -33,55 +49,43 @@ public:
 
     explicit AnnotationRegistry(const FileNameListType &anno_files,
                                 AnnotationTypeAllocator & annotation_allocator,
-                                const AnnotationOverrides & anno_overrides)
+                                const AnnotationOverrides & anno_overrides,
+                                AnnotationLoadMode mode = AnnotationLoadMode::EAGER)
         : anno_file_list_(anno_files),
-          not_found_(nullptr)
+          not_found_(nullptr),
+          mode_(mode),
+          annotation_allocator_(annotation_allocator)
     {
-        for (const auto &afile : anno_file_list_) {
-            if (afile.empty()) continue;
-
-            json_value json;
-            try {
-                json = parseJSON(afile);
-            } catch (const std::ifstream::failure &) {
-                throw BadAnnotationFile(afile);
-            } catch (const std::exception &ex) {
-                std::cerr << __FUNCTION__ << ": ERROR parsing '" << afile << "': " << ex.what() << std::endl;
+        std::map<std::string, json_object> jobj_annotations;
+        for (const auto &ann : anno_overrides) {
+            const std::string mnemonic  = string_ws_trim(ann.first);
+            const std::string attribute = string_ws_trim(ann.second);
+            if (attribute.find(':') == std::string::npos) {
+                std::cerr << __FUNCTION__ << ": ERROR: Bad annotation override format: " << attribute
+                          << " (expected name:value)" << std::endl;
+                throw;
+            }
+            const std::string attr_name  = string_ws_trim(attribute.substr(0, attribute.find(':')));
+            const std::string attr_value = string_ws_trim(attribute.substr(attribute.find(':') + 1));
+            if (attr_name.empty() || attr_value.empty()) {
+                std::cerr << __FUNCTION__ << ": ERROR: Bad annotation override format: " << attribute
+                          << " (expected name:value)" << std::endl;
                 throw;
             }
-
             #ifdef USE_NLOHMANN_JSON
-            auto &jobj = json;
+            jobj_annotations[mnemonic][attr_name] = nlohmann::json::parse(attr_value);
             #else
-            auto &jobj = json.as_array();
+            jobj_annotations[mnemonic][attr_name] = boost::json::parse(attr_value);
             #endif
+        }
 
-            std::map<std::string, json_object> jobj_annotations;
-            for (const auto &ann : anno_overrides) {
-                const std::string mnemonic  = string_ws_trim(ann.first);
-                const std::string attribute = string_ws_trim(ann.second);
-                if (attribute.find(':') == std::string::npos) {
-                    std::cerr << __FUNCTION__ << ": ERROR: Bad annotation override format: " << attribute
-                              << " (expected name:value)" << std::endl;
-                    throw;
-                }
-                const std::string attr_name  = string_ws_trim(attribute.substr(0, attribute.find(':')));
-                const std::string attr_value = string_ws_trim(attribute.substr(attribute.find(':') + 1));
-                if (attr_name.empty() || attr_value.empty()) {
-                    std::cerr << __FUNCTION__ << ": ERROR: Bad annotation override format: " << attribute
-                              << " (expected name:value)" << std::endl;
-                    throw;
-                }
-                #ifdef USE_NLOHMANN_JSON
-                jobj_annotations[mnemonic][attr_name] = nlohmann::json::parse(attr_value);
-                #else
-                jobj_annotations[mnemonic][attr_name] = boost::json::parse(attr_value);
-                #endif
-            }
+        for (const auto &afile : anno_file_list_) {
+            if (afile.empty()) continue;
 
             std::set<std::string> processed;
 
-            for (auto &inst_value : jobj)
+            // Annotations are built one instruction at a time, straight from the (mapped) file
+            const auto add_annotation = [&](json_value &inst_value)
             {
                 #ifdef USE_NLOHMANN_JSON
                 auto &inst = inst_value;
@@ -102,6 +106,17 @@ public:
                     #endif
                 }
 
+                if (mode_ == AnnotationLoadMode::LAZY) {
+                    // Same ordering as below: the first file's JSON constructs the annotation,
+                    // and later files update it
+                    if (processed.find(mnemonic) != processed.end()) {
+                        throw AnnotationNotUniqueInFile(mnemonic, afile);
+                    }
+                    pending_[mnemonic].emplace_back(std::move(inst));
+                    processed.insert(mnemonic);
+                    return;
+                }
+
                 const typename AnnotationType::PtrType &anno = privateFindAnnotation_(mnemonic);
                 if (anno == not_found_) {
                     typename AnnotationType::PtrType new_anno = annotation_allocator(inst);
@@ -112,14 +127,25 @@ public:
                     throw AnnotationNotUniqueInFile(mnemonic, afile);
                 }
                 processed.insert(mnemonic);
+            };
+
+            try {
+                forEachJSONArrayElementWithException<BadAnnotationFile>(afile, add_annotation);
+            } catch (const BaseException &) {
+                throw;
+            } catch (const std::exception &ex) {
+                std::cerr << __FUNCTION__ << ": ERROR parsing '" << afile << "': " << ex.what() << std::endl;
+                throw;
             }
         }
     }
 
-    const typename AnnotationType::PtrType &findAnnotation(const std::string &mnemonic,
+    const typename AnnotationType::PtrType &findAnnotation(const std::string_view mnemonic,
                                                            bool suppress_exception = false) const
     {
-        const typename AnnotationType::PtrType &anno = privateFindAnnotation_(mnemonic);
+        const typename AnnotationType::PtrType &anno = (mode_ == AnnotationLoadMode::LAZY) ?
+                                                       lazyFindAnnotation_(mnemonic) :
+                                                       privateFindAnnotation_(mnemonic);
         if (anno == not_found_) {
             if (anno_file_list_.empty() || suppress_exception) {
                 return not_found_;
@@ -132,7 +158,13 @@ public:
 
     bool isVacant() const
     {
-        return registry_.empty();
+        std::lock_guard<std::mutex> lock(lazy_mutex_);
+        return registry_.empty() && pending_.empty();
+    }
+
+    AnnotationLoadMode getLoadMode() const
+    {
+        return mode_;
     }
 
     bool isPopulated() const
@@ -142,10 +174,37 @@ public:
 
 private:
     const FileNameListType anno_file_list_;
-    std::map<std::string, typename AnnotationType::PtrType> registry_;
+    mutable std::map<std::string, typename AnnotationType::PtrType, std::less<>> registry_;
     const typename AnnotationType::PtrType not_found_;
+    const AnnotationLoadMode mode_;
+
+    // LAZY mode: annotation JSON (overrides applied) per mnemonic, in annotation file order, for
+    // the annotations not constructed yet. The registry may be shared by contexts that are being
+    // built concurrently, so construction is serialized
+    mutable AnnotationTypeAllocator annotation_allocator_;
+    mutable std::map<std::string, std::vector<json_object>, std::less<>> pending_;
+    mutable std::mutex lazy_mutex_;
+
+    const typename AnnotationType::PtrType &lazyFindAnnotation_(const std::string_view mnemonic) const
+    {
+        std::lock_guard<std::mutex> lock(lazy_mutex_);
+        const typename AnnotationType::PtrType &anno = privateFindAnnotation_(mnemonic);
+        if (anno != not_found_) {
+            return anno;
+        }
+        const auto elem = pending_.find(mnemonic);
+        if (elem == pending_.end()) {
+            return not_found_;
+        }
+        typename AnnotationType::PtrType new_anno = annotation_allocator_(elem->second.front());
+        for (auto inst = std::next(elem->second.begin()); inst != elem->second.end(); ++inst) {
+            new_anno->update(*inst);
+        }
+        pending_.erase(elem);
+        return registry_[std::string(mnemonic)] = new_anno;
+    }
 
-    const typename AnnotationType::PtrType &privateFindAnnotation_(const std::string &mnemonic) const
+    const typename AnnotationType::PtrType &privateFindAnnotation_(const std::string_view mnemonic) const
     {
         const auto elem = registry_.find(mnemonic);
         if (elem == registry_.end()) {
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "CacheFilter.h"
+#include "DecoderTypes.h"
+#include "Symbol.hpp"
+
+namespace mavis
+{
+
+    /**
+     * \brief A run of decoded instructions, from a PC up to (and including) the next control
+     * flow instruction (see Mavis::getBlock)
+     */
+    template <typename InstType> struct DecodedBlock
+    {
+        struct Inst
+        {
+            typename InstType::PtrType inst; // Decoded template: copy it before modifying it
+            Opcode icode;
+            uint32_t offset; // From the block's pc
+            uint32_t size;   // 2 or 4 bytes
+            InstructionUniqueID uid;
+        };
+
+        uint64_t pc = 0;
+        std::vector<Inst> insts;
+
+        // Offset of the instruction after the block (its size, in bytes)
+        uint64_t fall_through_offset = 0;
+
+        // Whether the block ends in a branch, jump, or system instruction (rather than at
+        // BlockCache::MAX_BLOCK_INSTS or an undecodable opcode)
+        bool ends_in_control_flow = false;
+
+        // Whether the last instruction has a direct (PC-relative) target, and its offset from pc
+        bool has_target = false;
+        int64_t target_offset = 0;
+
+        uint64_t getFallThrough() const { return pc + fall_through_offset; }
+
+        uint64_t getTarget() const { return pc + target_offset; }
+
+        // Whether any byte of the block is in [start, end)
+        bool overlaps(const uint64_t start, const uint64_t end) const
+        {
+            return (pc < end) && (start < pc + fall_through_offset);
+        }
+    };
+
+    /**
+     * \brief Decoded blocks keyed by (context, PC)
+     *
+     * Hits cost a single direct-mapped lookup. Blocks stay put (and references to them valid)
+     * until they are invalidated or the cache is cleared.
+     */
+    template <typename InstType> class BlockCache
+    {
+      public:
+        using BlockType = DecodedBlock<InstType>;
+
+        // Longest block (in instructions); longer runs are split
+        constexpr static inline uint32_t MAX_BLOCK_INSTS = 64;
+        constexpr static inline uint64_t MAX_BLOCK_BYTES = MAX_BLOCK_INSTS * 4;
+
+        const BlockType* find(const Symbol & context, const uint64_t pc)
+        {
+            const Key key = makeKey_(context, pc);
+            Line & line = lines_[lineIndex_(pc)];
+            if ((line.block != nullptr) && (line.key == key))
+            {
+                return line.block;
+            }
+
+            const auto iter = blocks_.find(key);
+            if (iter == blocks_.end())
+            {
+                return nullptr;
+            }
+            line = {key, &iter->second};
+            return line.block;
+        }
+
+        const BlockType & insert(const Symbol & context, BlockType && block)
+        {
+            const Key key = makeKey_(context, block.pc);
+            auto & entry = blocks_[key];
+            entry = std::move(block);
+            lines_[lineIndex_(entry.pc)] = {key, &entry};
+            return entry;
+        }
+
+        // Drop the blocks (of every context) that overlap [start, end)
+        void invalidate(const uint64_t start, const uint64_t end)
+        {
+            // Blocks are ordered by pc, and none is longer than MAX_BLOCK_BYTES
+            const uint64_t first_pc = (start > MAX_BLOCK_BYTES) ? (start - MAX_BLOCK_BYTES) : 0;
+            for (auto iter = blocks_.lower_bound({first_pc, 0});
+                 (iter != blocks_.end()) && (iter->first.first < end);)
+            {
+                if (iter->second.overlaps(start, end))
+                {
+                    iter = blocks_.erase(iter);
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+            lines_.fill(Line());
+        }
+
+        // Drop the blocks (of every context) containing an instruction selected by filter
+        void invalidateIf(const CacheFilter & filter)
+        {
+            for (auto iter = blocks_.begin(); iter != blocks_.end();)
+            {
+                const auto & insts = iter->second.insts;
+                const bool selected =
+                    std::any_of(insts.begin(), insts.end(), [&filter](const auto & inst)
+                                { return filter.matches(inst.icode, inst.uid); });
+                iter = selected ? blocks_.erase(iter) : std::next(iter);
+            }
+            lines_.fill(Line());
+        }
+
+        void clear()
+        {
+            blocks_.clear();
+            lines_.fill(Line());
+        }
+
+        size_t size() const { return blocks_.size(); }
+
+      private:
+        // (pc, address of the interned context name)
+        using Key = std::pair<uint64_t, uintptr_t>;
+
+        static Key makeKey_(const Symbol & context, const uint64_t pc)
+        {
+            return {pc, reinterpret_cast<uintptr_t>(&context.str())};
+        }
+
+        constexpr static inline uint32_t CACHE_SIZE = 1023;
+
+        static uint32_t lineIndex_(const uint64_t pc) { return (pc >> 1) % CACHE_SIZE; }
+
+        struct Line
+        {
+            Key key{0, 0};
+            const BlockType* block = nullptr;
+        };
+
+        std::map<Key, BlockType> blocks_;
+        std::array<Line, CACHE_SIZE> lines_{};
+    };
+
+} // namespace mavis
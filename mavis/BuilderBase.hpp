@@ -7,6 +7,7 @@
 #include "AnnotationRegistry.hpp"
 #include "DualKeyRegistry.hpp"
 #include "DecoderExceptions.h"
+#include "PerfectHash.hpp"
 
 namespace mavis
 {
@@ -15,24 +16,34 @@ template<typename FactoryType, typename InstType, typename AnnotationType, typen
 class FactoryBuilderBase
 {
     typedef std::shared_ptr<FactoryBuilderBase<FactoryType, InstType, AnnotationType, AnnotationTypeAllocator>>     PtrType;
-    typedef AnnotationRegistry<AnnotationType,AnnotationTypeAllocator>          AnnotationRegistryType;
     typedef DualKeyRegistry<typename FactoryType::PtrType>                UIDStashType;
 
 public:
+    typedef AnnotationRegistry<AnnotationType,AnnotationTypeAllocator>          AnnotationRegistryType;
+
     FactoryBuilderBase(const FileNameListType& anno_files,
                        AnnotationTypeAllocator & annotation_allocator,
                        const InstUIDList& uid_list = {},
                        const AnnotationOverrides & anno_overrides = {}) :
-        inst_registry_(uid_list),
-        anno_registry_(anno_files, annotation_allocator, anno_overrides)
+        FactoryBuilderBase(std::make_shared<AnnotationRegistryType>(anno_files, annotation_allocator, anno_overrides),
+                           uid_list)
     {}
 
+    // Construct with an existing (possibly shared) annotation registry
+    FactoryBuilderBase(const typename AnnotationRegistryType::PtrType& anno_registry,
+                       const InstUIDList& uid_list = {}) :
+        inst_registry_(uid_list),
+        anno_registry_(anno_registry)
+    {
+        assert(anno_registry_ != nullptr);
+    }
+
     InstructionUniqueID registerInst(const std::string& mnemonic)
     {
         return inst_registry_.registerInst(mnemonic);
     }
 
-    InstructionUniqueID findInstructionUID(const std::string& mnemonic) const
+    InstructionUniqueID findInstructionUID(const std::string_view mnemonic) const
     {
         return inst_registry_.lookupUID(mnemonic);
     }
@@ -42,13 +53,29 @@ public:
         return inst_registry_.lookupMnemonic(uid);
     }
 
+    InstUIDList getInstUIDList() const
+    {
+        return inst_registry_.getUIDList();
+    }
+
     const typename AnnotationType::PtrType& findAnnotation(const std::string& mnemonic,
                                                            bool suppress_exception = false) const
     {
-        return anno_registry_.findAnnotation(mnemonic, suppress_exception);
+        return anno_registry_->findAnnotation(mnemonic, suppress_exception);
+    }
+
+    // Annotation lookup for factories that defer it to their first decode (the lookup keeps
+    // the registry alive)
+    const typename IFactoryIF<InstType, AnnotationType>::AnnotationLookup& getAnnotationLookup()
+    {
+        if (!anno_lookup_) {
+            anno_lookup_ = [anno_registry = anno_registry_](const std::string& name)
+                           { return anno_registry->findAnnotation(name, true); };
+        }
+        return anno_lookup_;
     }
 
-    InstMetaData::PtrType findMetaData(const std::string& mnemonic) const
+    InstMetaData::PtrType findMetaData(const std::string_view mnemonic) const
     {
         return meta_registry_.lookup(mnemonic);
     }
@@ -59,8 +86,11 @@ public:
         return meta_registry_.makeInstMetaData(std::forward<ArgTypes>(args)...);
     }
 
-    const typename FactoryType::PtrType& findIFact(const std::string& mnemonic) const
+    const typename FactoryType::PtrType& findIFact(const std::string_view mnemonic) const
     {
+        if (const auto ifact = ifact_index_.find(mnemonic)) {
+            return *ifact;
+        }
         const auto elem = registry_.find(mnemonic);
         if (elem == registry_.end()) {
             return not_found_;
@@ -84,12 +114,43 @@ public:
         }
     }
 
+    /**
+     * \brief Use the factories that replaced the registered ones in the decode tree (see
+     * DecodeNodePool), so that lookups by name find the shared factories
+     */
+    template<typename ReplacementMapType>
+    void replaceIFactories(const ReplacementMapType& replaced)
+    {
+        for (auto& [name, ifact] : registry_) {
+            const auto iter = replaced.find(ifact.get());
+            if ((iter != replaced.end()) && (iter->second != ifact)) {
+                const auto shared = std::dynamic_pointer_cast<FactoryType>(iter->second);
+                assert(shared != nullptr);
+                ifact = shared;
+            }
+        }
+        freezeLookups();
+    }
+
+    /**
+     * \brief Index the factory and UID registries with perfect hashes, once the context is
+     * configured. Factories registered later (e.g. by makeInstFromTrace) are still found, through
+     * the maps
+     */
+    void freezeLookups()
+    {
+        ifact_index_.build(registry_);
+        inst_registry_.freezeLookups();
+    }
+
 protected:
-    std::map<std::string, typename FactoryType::PtrType>    registry_;
-    typename FactoryType::PtrType                           not_found_;
+    std::map<std::string, typename FactoryType::PtrType, std::less<>>  registry_;
+    PerfectHashIndex<typename FactoryType::PtrType>                    ifact_index_;
+    typename FactoryType::PtrType                                      not_found_;
 
     InstructionRegistry                                     inst_registry_;
-    AnnotationRegistryType                                  anno_registry_;
+    typename AnnotationRegistryType::PtrType                anno_registry_;
+    typename IFactoryIF<InstType, AnnotationType>::AnnotationLookup anno_lookup_;
     InstMetaDataRegistry                                    meta_registry_;
     UIDStashType                                            uid_stash_;
 };
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "DecoderTypes.h"
+#include "DecoderConsts.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Selects the cached decodes dropped by a selective invalidation (see
+     * DTable::invalidate): opcodes with (icode & mask) == value and, if uid is valid, only those
+     * that decode to uid
+     */
+    struct CacheFilter
+    {
+        Opcode mask = 0;
+        Opcode value = 0;
+        InstructionUniqueID uid = INVALID_UID;
+
+        static CacheFilter opcode(const Opcode icode) { return {~Opcode(0), icode, INVALID_UID}; }
+
+        static CacheFilter opcodes(const Opcode mask, const Opcode value)
+        {
+            return {mask, value & mask, INVALID_UID};
+        }
+
+        static CacheFilter inst(const InstructionUniqueID uid) { return {0, 0, uid}; }
+
+        static CacheFilter all() { return {0, 0, INVALID_UID}; }
+
+        bool matchesOpcode(const Opcode icode) const { return (icode & mask) == value; }
+
+        // Whether the UID of an opcode is needed to decide (i.e. matchesOpcode() is not enough)
+        bool needsUID() const { return uid != INVALID_UID; }
+
+        bool matches(const Opcode icode, const InstructionUniqueID icode_uid) const
+        {
+            return matchesOpcode(icode) && (!needsUID() || (icode_uid == uid));
+        }
+    };
+
+} // namespace mavis
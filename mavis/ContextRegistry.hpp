@@ -5,10 +5,42 @@
 #include "mavis/IFactoryBuilder.h"
 #include "mavis/PseudoBuilder.hpp"
 #include "mavis/DTable.h"
+#include "mavis/DecodeNodePool.hpp"
+#include "mavis/JSONUtils.hpp"
+#include "mavis/Symbol.hpp"
+#include <chrono>
+#include <future>
 #include <map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace mavis {
 
+/**
+ * \brief How a context's decode tables are built by ContextRegistry::makeContext
+ */
+enum class ContextBuildMode
+{
+    EAGER,  // Built before makeContext returns (default)
+    LAZY,   // Built on the first switchContext to it (in the calling thread)
+    ASYNC   // Built on a background thread; switchContext waits for it to finish
+};
+
+/**
+ * \brief Small integer ID of a context, for switching to it or decoding in it without a name lookup
+ */
+struct ContextHandle
+{
+    static constexpr uint32_t INVALID = ~0u;
+
+    uint32_t id = INVALID;
+
+    bool isValid() const { return id != INVALID; }
+    bool operator==(const ContextHandle& other) const { return id == other.id; }
+    bool operator!=(const ContextHandle& other) const { return id != other.id; }
+};
+
 template<typename InstType, typename AnnotationType, typename AnnotationTypeAllocator>
 class ContextRegistry
 {
@@ -17,8 +49,9 @@ class ContextRegistry
     using DTableType = mavis::DTable<InstType, AnnotationType, AnnotationTypeAllocator>;
 
 public:
-    explicit ContextRegistry(const AnnotationTypeAllocator& anno_allocator) :
-        annotation_allocator_(anno_allocator)
+    explicit ContextRegistry(const AnnotationTypeAllocator& anno_allocator,
+                             AnnotationLoadMode anno_mode = AnnotationLoadMode::EAGER) :
+        shared_(std::make_shared<SharedState>(anno_allocator, anno_mode))
     {}
 
     ContextRegistry(const ContextRegistry&) = delete;
@@ -28,22 +61,67 @@ public:
     void makeContext(const std::string& name, const FileNameListType& isa_files, const FileNameListType& anno_files,
                      const InstUIDList& uid_list = {}, const AnnotationOverrides & anno_overrides = {},
                      const MatchSet<Pattern>& inclusions = MatchSet<Pattern>(),
-                     const MatchSet<Pattern>& exclusions = MatchSet<Pattern>())
+                     const MatchSet<Pattern>& exclusions = MatchSet<Pattern>(),
+                     ContextBuildMode mode = ContextBuildMode::EAGER)
     {
         if (registry_.find(name) != registry_.end()) {
             throw ContextAlreadyExists(name);
         }
 
-        registry_[name] = {annotation_allocator_, isa_files, anno_files, uid_list, anno_overrides, inclusions, exclusions};
+        if (mode == ContextBuildMode::EAGER) {
+            // Build before registering, so that a failed build leaves no trace of the context
+            Context ctx = buildContext_(*shared_, isa_files, anno_files, uid_list, anno_overrides,
+                                        inclusions, exclusions);
+            addEntry_(name).ctx = ctx;
+            return;
+        }
+
+        // Build errors for LAZY/ASYNC contexts are reported by switchContext (or waitForContext)
+        addEntry_(name).pending = std::async(mode == ContextBuildMode::ASYNC ? std::launch::async : std::launch::deferred,
+                                             &ContextRegistry::buildContextAsync_, shared_, isa_files, anno_files, uid_list,
+                                             anno_overrides, inclusions, exclusions).share();
     }
 
     void switchContext(const std::string& name)
+    {
+        switchContext(getContextHandle(name));
+    }
+
+    void switchContext(ContextHandle handle)
+    {
+        ContextEntry& entry = getEntry_(handle);
+        resolve_(entry);
+        current_ = &entry;
+    }
+
+    /**
+     * \brief Handle of the named context (waits for it to be built, like switchContext)
+     */
+    ContextHandle getContextHandle(const std::string& name)
     {
         const auto iter = registry_.find(name);
         if (iter == registry_.end()) {
             throw UnknownContext(name);
         }
-        current_ = &iter->second;
+        resolve_(iter->second);
+        return iter->second.handle;
+    }
+
+    ContextHandle getCurrentContext() const
+    {
+        assert(current_ != nullptr);
+        return current_->handle;
+    }
+
+    const std::string& getContextName(ContextHandle handle) const
+    {
+        return getEntry_(handle).name;
+    }
+
+    // Interned name of the context (made once, when the context is registered)
+    const Symbol& getContextSymbol(ContextHandle handle) const
+    {
+        return getEntry_(handle).symbol;
     }
 
     bool hasContext(const std::string& name)
@@ -52,55 +130,263 @@ public:
         return iter != registry_.end();
     }
 
-    typename BuilderType::PtrType getBuilder() const
+    /**
+     * \brief Whether the named context has been built (always true for EAGER contexts; LAZY
+     * contexts are not ready until they are first switched to)
+     */
+    bool isContextReady(const std::string& name) const
+    {
+        const auto iter = registry_.find(name);
+        if (iter == registry_.end()) {
+            throw UnknownContext(name);
+        }
+        const auto& pending = iter->second.pending;
+        return !pending.valid() || (pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    }
+
+    // Block until the named context is built (builds a LAZY context in the calling thread)
+    void waitForContext(const std::string& name)
+    {
+        const auto iter = registry_.find(name);
+        if (iter == registry_.end()) {
+            throw UnknownContext(name);
+        }
+        resolve_(iter->second);
+    }
+
+    const typename BuilderType::PtrType& getBuilder() const
     {
         assert(current_ != nullptr);
-        assert(current_->builder != nullptr);
-        return current_->builder;
+        assert(current_->ctx.builder != nullptr);
+        return current_->ctx.builder;
     }
 
-    typename PseudoBuilderType::PtrType getPseudoBuilder() const
+    const typename PseudoBuilderType::PtrType& getPseudoBuilder() const
     {
         assert(current_ != nullptr);
-        assert(current_->pseudo_builder != nullptr);
-        return current_->pseudo_builder;
+        assert(current_->ctx.pseudo_builder != nullptr);
+        return current_->ctx.pseudo_builder;
     }
 
-    typename DTableType::PtrType getDTable() const
+    const typename DTableType::PtrType& getDTable() const
     {
         assert(current_ != nullptr);
-        assert(current_->dtrie != nullptr);
-        return current_->dtrie;
+        assert(current_->ctx.dtrie != nullptr);
+        return current_->ctx.dtrie;
+    }
+
+    // Tables of a context by handle. Handles come from getContextHandle(), so the context is built.
+    BuilderType& getBuilder(ContextHandle handle) const
+    {
+        return *getEntry_(handle).ctx.builder;
+    }
+
+    PseudoBuilderType& getPseudoBuilder(ContextHandle handle) const
+    {
+        return *getEntry_(handle).ctx.pseudo_builder;
+    }
+
+    DTableType& getDTable(ContextHandle handle) const
+    {
+        return *getEntry_(handle).ctx.dtrie;
+    }
+
+    // Handles of the contexts built so far (LAZY contexts that were never switched to are not)
+    std::vector<ContextHandle> getBuiltContexts() const
+    {
+        std::vector<ContextHandle> handles;
+        for (const ContextEntry* entry : handles_) {
+            if (entry->ctx.dtrie != nullptr) {
+                handles.push_back(entry->handle);
+            }
+        }
+        return handles;
+    }
+
+    // Number of decode tree nodes and metadata objects that contexts share with contexts built
+    // before them, rather than keep their own (see DecodeNodePool)
+    size_t getNumSharedNodes() const
+    {
+        const std::lock_guard<std::mutex> lock(shared_->build_mutex);
+        size_t num_shared = 0;
+        for (const auto& [registry, pool] : shared_->node_pools) {
+            num_shared += pool.getNumShared();
+        }
+        return num_shared;
     }
 
 private:
-    AnnotationTypeAllocator annotation_allocator_;
+    using AnnotationRegistryType = typename BuilderType::AnnotationRegistryType;
 
     struct Context {
         typename BuilderType::PtrType           builder;
         typename PseudoBuilderType::PtrType     pseudo_builder;
         typename DTableType::PtrType            dtrie;
+    };
 
-        Context() = default;
-        Context(const Context&) = default;
-        Context& operator=(const Context&) = default;
-
-        Context(AnnotationTypeAllocator& anno_allocator, const FileNameListType& isa_files, const FileNameListType& anno_files,
-                const InstUIDList& uid_list = {}, const AnnotationOverrides & anno_overrides = {},
-                const MatchSet<Pattern>& inclusions = MatchSet<Pattern>(),
-                const MatchSet<Pattern>& exclusions = MatchSet<Pattern>())
-        {
-            builder = std::make_shared<BuilderType>(anno_files, anno_allocator, uid_list, anno_overrides);
-            dtrie   = std::make_shared<DTableType>(builder);
-            dtrie->configure(isa_files, inclusions, exclusions);
-
-            pseudo_builder = std::make_shared<PseudoBuilderType>(anno_files, anno_allocator, uid_list);
-            pseudo_builder->configure(isa_files);
-        }
+    struct ContextEntry {
+        std::string                     name;
+        Symbol                          symbol;     // Interned name
+        ContextHandle                   handle;
+        Context                         ctx;
+        std::shared_future<Context>     pending;    // Valid until a LAZY/ASYNC context is resolved
+    };
+
+    // State used while building contexts. It is held by shared pointer so that background builds
+    // are unaffected by the registry being moved; builds are serialized by build_mutex.
+    struct SharedState {
+        SharedState(const AnnotationTypeAllocator& anno_allocator, AnnotationLoadMode anno_mode) :
+            annotation_allocator(anno_allocator),
+            anno_load_mode(anno_mode)
+        {}
+
+        AnnotationTypeAllocator                                             annotation_allocator;
+        const AnnotationLoadMode                                            anno_load_mode;
+        std::mutex                                                          build_mutex;
+
+        // Structures shared between contexts (immutable once built)
+        std::map<std::string, typename AnnotationRegistryType::PtrType>     anno_registry_cache;
+        std::map<std::string, Context>                                      built_contexts;   // By signature
+
+        // Decode tree nodes and metadata, by annotation registry (the nodes' caches are not
+        // immutable: contexts sharing nodes share their caches too)
+        std::map<const AnnotationRegistryType*, DecodeNodePool<InstType, AnnotationType>> node_pools;
     };
 
-    std::map<std::string, Context>     registry_;
-    Context                            *current_ = nullptr;
+    std::shared_ptr<SharedState>       shared_;
+    std::map<std::string, ContextEntry> registry_;
+    std::vector<ContextEntry*>         handles_;        // By handle ID (map nodes do not move)
+    ContextEntry                       *current_ = nullptr;
+
+    ContextEntry& addEntry_(const std::string& name)
+    {
+        ContextEntry& entry = registry_[name];
+        entry.name = name;
+        entry.symbol = Symbol(name);
+        entry.handle.id = static_cast<uint32_t>(handles_.size());
+        handles_.push_back(&entry);
+        return entry;
+    }
+
+    ContextEntry& getEntry_(ContextHandle handle) const
+    {
+        if (handle.id >= handles_.size()) {
+            throw UnknownContext("#" + std::to_string(handle.id));
+        }
+        return *handles_[handle.id];
+    }
+
+    static void resolve_(ContextEntry& entry)
+    {
+        if (entry.pending.valid()) {
+            // Rethrows any build error (and keeps doing so on later attempts)
+            entry.ctx = entry.pending.get();
+            entry.pending = {};
+        }
+    }
+
+    static Context buildContext_(SharedState& state, const FileNameListType& isa_files,
+                                 const FileNameListType& anno_files, const InstUIDList& uid_list,
+                                 const AnnotationOverrides & anno_overrides,
+                                 const MatchSet<Pattern>& inclusions, const MatchSet<Pattern>& exclusions)
+    {
+        const std::lock_guard<std::mutex> lock(state.build_mutex);
+
+        // A context built from exactly the same inputs as an existing one shares its decode
+        // tables (and therefore its UIDs) rather than rebuilding them
+        const std::string signature = makeSignature_(isa_files, anno_files, uid_list, anno_overrides,
+                                                     inclusions, exclusions);
+        if (const auto iter = state.built_contexts.find(signature); iter != state.built_contexts.end()) {
+            return iter->second;
+        }
+
+        Context ctx;
+
+        // Stream the ISA files once: the DTable builds the instructions, and passes on the other
+        // entries (pseudo instructions), which are built after them
+        std::vector<json_value> other_entries;
+        const auto anno_registry = getAnnotationRegistry_(state, anno_files, anno_overrides);
+        ctx.builder = std::make_shared<BuilderType>(anno_registry, uid_list);
+        ctx.dtrie   = std::make_shared<DTableType>(ctx.builder);
+        ctx.dtrie->configure(isa_files, inclusions, exclusions,
+                             [&other_entries](json_value& entry) { other_entries.push_back(std::move(entry)); });
+
+        // Share what this context's decode tree has in common with the contexts built before it
+        ctx.dtrie->shareNodes(state.node_pools[anno_registry.get()]);
+
+        ctx.pseudo_builder = std::make_shared<PseudoBuilderType>(getAnnotationRegistry_(state, anno_files, {}), uid_list);
+        ctx.pseudo_builder->configureInsts(other_entries);
+
+        state.built_contexts[signature] = ctx;
+        return ctx;
+    }
+
+    // Entry point for std::async (holds the shared state alive for the duration of the build)
+    static Context buildContextAsync_(std::shared_ptr<SharedState> state, FileNameListType isa_files,
+                                 FileNameListType anno_files, InstUIDList uid_list,
+                                 AnnotationOverrides anno_overrides,
+                                 MatchSet<Pattern> inclusions, MatchSet<Pattern> exclusions)
+    {
+        return buildContext_(*state, isa_files, anno_files, uid_list, anno_overrides, inclusions, exclusions);
+    }
+
+    // Contexts using the same annotation files and overrides share one registry
+    static typename AnnotationRegistryType::PtrType getAnnotationRegistry_(SharedState& state,
+                                                                           const FileNameListType& anno_files,
+                                                                           const AnnotationOverrides& anno_overrides)
+    {
+        std::string key;
+        appendField_(key, anno_files);
+        for (const auto& [mnemonic, value] : anno_overrides) {
+            appendField_(key, mnemonic);
+            appendField_(key, value);
+        }
+
+        auto iter = state.anno_registry_cache.find(key);
+        if (iter == state.anno_registry_cache.end()) {
+            iter = state.anno_registry_cache.emplace(key, std::make_shared<AnnotationRegistryType>(
+                                                     anno_files, state.annotation_allocator, anno_overrides,
+                                                     state.anno_load_mode)).first;
+        }
+        return iter->second;
+    }
+
+    static void appendField_(std::string& sig, const std::string& field)
+    {
+        sig += field;
+        sig += '\0';
+    }
+
+    template<typename ContainerType>
+    static void appendField_(std::string& sig, const ContainerType& fields)
+    {
+        for (const auto& f : fields) {
+            appendField_(sig, f);
+        }
+        sig += '\1';
+    }
+
+    static std::string makeSignature_(const FileNameListType& isa_files, const FileNameListType& anno_files,
+                                      const InstUIDList& uid_list, const AnnotationOverrides & anno_overrides,
+                                      const MatchSet<Pattern>& inclusions, const MatchSet<Pattern>& exclusions)
+    {
+        std::string sig;
+        appendField_(sig, isa_files);
+        appendField_(sig, anno_files);
+        for (const auto& elem : uid_list) {
+            appendField_(sig, elem.mnemonic);
+            appendField_(sig, std::to_string(elem.uid));
+        }
+        sig += '\1';
+        for (const auto& [mnemonic, value] : anno_overrides) {
+            appendField_(sig, mnemonic);
+            appendField_(sig, value);
+        }
+        sig += '\1';
+        appendField_(sig, inclusions.getS());
+        appendField_(sig, exclusions.getS());
+        return sig;
+    }
 };
 
 } // namespace mavis
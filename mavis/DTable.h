@@ -1,10 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <set>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <array>
+#include <unordered_set>
 
 #ifdef USE_NLOHMANN_JSON
 #include <nlohmann/json.hpp>
@@ -29,8 +36,16 @@ using json_object = boost::json::object;
 #include "DecoderTypes.h"
 #include "DecoderExceptions.h"
 #include "Tag.hpp"
+#include "TagFilter.hpp"
 #include "Pattern.hpp"
 #include "MatchSet.hpp"
+#include "JSONUtils.hpp"
+#include "DecodeNodePool.hpp"
+#include "DecodedView.h"
+#include "OpcodeClass.h"
+#include "PreparedInst.h"
+#include "DasmWriter.h"
+#include "CacheFilter.h"
 
 namespace mavis
 {
@@ -99,8 +114,22 @@ class DTable
             table_[hash].tag = icode;
             table_[hash].handle = handle;
         }
+
+        // Drop the lines for which pred(icode, handle) is true
+        template <typename Predicate> void invalidateIf(const Predicate &pred)
+        {
+            for (auto &line : table_)
+            {
+                if ((line.handle != nullptr) && pred(line.tag, line.handle))
+                {
+                    line = Line();
+                }
+            }
+        }
     };
 
+    using RootType = IFactoryMatchListComposite<InstType, AnnotationType, PseudoForm<'*'>::NUM_FAMILIES>;
+
     constexpr static inline uint32_t CACHE_SIZE = 1023;
     using InstCache = Cache<InstType, CACHE_SIZE>;
     using IFactoryCache =
@@ -113,40 +142,154 @@ class DTable
           icache_(new InstCache()),
           ocache_(new IFactoryCache())
     {
-        root_.reset(new IFactoryMatchListComposite<InstType, AnnotationType, 6>(
-            PseudoForm<'*'>::getField(PseudoForm<'*'>::FAMILY),
+        using RootForm = PseudoForm<'*'>;
+        root_.reset(new RootType(
+            RootForm::getField(RootForm::FAMILY),
             {
-                [](uint32_t icode) { return (icode & 0x3ul) != 0x3ul; },
-                [](uint32_t icode)
-                { return ((icode & 0x3ul) == 3ul) && ((icode & 0x1cul) != 0x1cul); },
-                [](uint32_t icode) { return (icode & 0x3ful) == 0x1ful; },
-                [](uint32_t icode) { return (icode & 0x7ful) == 0x3ful; },
-                [](uint32_t icode)
-                { return ((icode & 0x7ful) == 0x7ful) && ((icode & 0x7000ul) != 0x7000ul); },
-                [](uint32_t icode) { return (icode & 0x707ful) == 0x707ful; },
+                [](uint32_t fval) { return RootForm::isFamily(0, fval); },
+                [](uint32_t fval) { return RootForm::isFamily(1, fval); },
+                [](uint32_t fval) { return RootForm::isFamily(2, fval); },
+                [](uint32_t fval) { return RootForm::isFamily(3, fval); },
+                [](uint32_t fval) { return RootForm::isFamily(4, fval); },
+                [](uint32_t fval) { return RootForm::isFamily(5, fval); },
             }));
     }
 
+    // Receives the ISA file entries that are not instructions (e.g. pseudo instructions), and
+    // may move from them
+    using OtherEntryConsumer = std::function<void(json_value &)>;
+
+    /**
+     * \brief Configure from the ISA files, streamed an instruction at a time (see
+     * forEachJSONArrayElement). Entries without a "mnemonic" are handed to other_entries, so that
+     * another builder can use the same pass over the files
+     */
     void configure(const FileNameListType & isa_files,
                    const MatchSet<Pattern> & inclusions = MatchSet<Pattern>(),
-                   const MatchSet<Pattern> & exclusions = MatchSet<Pattern>());
+                   const MatchSet<Pattern> & exclusions = MatchSet<Pattern>(),
+                   const OtherEntryConsumer & other_entries = nullptr);
+
+    /**
+     * \brief A decode route: the opcodes (value under mask, in an instruction family) the
+     * decode tree leads to an instruction, with the factory and extractor it leads to
+     */
+    struct DecodeRoute
+    {
+        uint32_t family;
+        Opcode mask;
+        Opcode value;
+        std::string mnemonic;
+        typename IFactoryIF<InstType, AnnotationType>::PtrType factory;
+        ExtractorIF::PtrType extractor;
+    };
+
+    /**
+     * \brief Flatten the decode tree into its routes
+     *
+     * Within a family, the first route matching an opcode is the one the tree would take
+     * (explicit branches precede defaults, special cases precede the general case)
+     */
+    std::vector<DecodeRoute> getDecodeRoutes() const;
+
+    /**
+     * \brief Replace the decode tree's leaves, subtrees and metadata with equal ones in pool
+     * (adding the others to it), once the table is configured and before it decodes
+     */
+    void shareNodes(DecodeNodePool<InstType, AnnotationType> & pool);
+
+    /**
+     * \brief Hash of the decode routes (family, mask, value and mnemonic): two tables with the
+     * same fingerprint decode every opcode to the same instruction
+     *
+     * UIDs are left out: they depend on the order in which contexts are built (which varies
+     * with ASYNC builds), and a warm cache file stores only opcodes.
+     */
+    uint64_t getFingerprint() const;
+
+    /**
+     * \brief Record the opcodes decoded from now on (see getRecordedOpcodes), e.g. to save them
+     * for warming up the next run
+     *
+     * Opcodes are recorded on front-end cache misses, so enabling recording empties the
+     * front-end caches (the leaf factories stay warm). Recording then costs a set insertion per
+     * miss.
+     */
+    void enableOpcodeRecording(const bool enable)
+    {
+        if (!enable)
+        {
+            recorded_.reset();
+        }
+        else if (recorded_ == nullptr)
+        {
+            recorded_.reset(new std::unordered_set<Opcode>());
+            icache_.reset(new InstCache());
+            ocache_.reset(new IFactoryCache());
+            class_cache_.fill(ClassLine());
+            trace_cache_.fill(TraceLine());
+            if (dasm_cache_ != nullptr)
+            {
+                dasm_cache_->fill(DasmLine());
+            }
+            // Views handed out so far go stale, so that the next ones are decoded (and recorded)
+            releaseDecodedViews();
+        }
+    }
 
+    std::vector<Opcode> getRecordedOpcodes() const
+    {
+        std::vector<Opcode> icodes;
+        if (recorded_ != nullptr)
+        {
+            icodes.assign(recorded_->begin(), recorded_->end());
+            std::sort(icodes.begin(), icodes.end());
+        }
+        return icodes;
+    }
+
+    // Undecodable opcodes are cached too (they throw again without a walk of the decode tree),
+    // until evicted, flushCaches() or invalidate()
     typename IFactoryIF<InstType, AnnotationType>::IFactoryInfo::PtrType
     getInfo(const Opcode icode)
     {
         const auto &ohandle = ocache_->lookup(icode);
         if (ohandle == nullptr)
         {
-            const auto &new_ohandle = root_->getInfo(icode);
-            if (new_ohandle != nullptr)
+            if (illegal_ != nullptr)
             {
-                ocache_->allocate(icode, new_ohandle);
-                return new_ohandle;
+                if (const IllegalLine &line = (*illegal_)[icode % CACHE_SIZE];
+                    (line.error != nullptr) && (line.icode == icode))
+                {
+                    std::rethrow_exception(line.error);
+                }
             }
-            else
+
+            typename IFactoryIF<InstType, AnnotationType>::IFactoryInfo::PtrType new_ohandle;
+            try
             {
-                throw UnknownOpcode(icode);
+                new_ohandle = root_->getInfo(icode);
+                if (new_ohandle == nullptr)
+                {
+                    throw UnknownOpcode(icode);
+                }
+            }
+            catch (const UnknownOpcode &)
+            {
+                cacheIllegal_(icode);
+                throw;
+            }
+            catch (const IllegalOpcode &)
+            {
+                cacheIllegal_(icode);
+                throw;
+            }
+
+            ocache_->allocate(icode, new_ohandle);
+            if (recorded_ != nullptr)
+            {
+                recorded_->insert(icode);
             }
+            return new_ohandle;
         }
         else
         {
@@ -154,6 +297,106 @@ class DTable
         }
     }
 
+    /**
+     * \brief Classify icode (UID and type bits) -- see mavis/OpcodeClass.h
+     *
+     * Hits cost a single direct-mapped lookup; misses decode icode through getInfo()
+     */
+    const OpcodeClass &getOpcodeClass(const Opcode icode)
+    {
+        ClassLine &line = class_cache_[icode % CACHE_SIZE];
+        if (!line.valid || (line.oclass.icode != icode))
+        {
+            const auto info = getInfo(icode);
+            line.oclass.icode = icode;
+            line.oclass.uid = info->opinfo->getInstructionUniqueID();
+            line.oclass.inst_types = info->opinfo->getInstType();
+            line.oclass.ext_inst_types = info->opinfo->getExtractedInstTypes();
+            line.valid = true;
+        }
+        return line.oclass;
+    }
+
+    /**
+     * \brief Disassemble icode into buf without allocating (see OpcodeInfo::dasmTo)
+     *
+     * With the disassembly cache enabled, the text of each opcode is rendered once, and hits
+     * are a copy of the cached text
+     * \return Length of the complete disassembly, as with snprintf
+     */
+    size_t dasmTo(const Opcode icode, char *buf, const size_t cap)
+    {
+        if (dasm_cache_ == nullptr)
+        {
+            return getInfo(icode)->opinfo->dasmTo(buf, cap);
+        }
+
+        DasmLine &line = (*dasm_cache_)[icode % CACHE_SIZE];
+        if (!line.valid || (line.icode != icode))
+        {
+            line.len = getInfo(icode)->opinfo->dasmTo(line.text.data(), line.text.size());
+            line.icode = icode;
+            line.valid = true;
+        }
+        if (line.len >= line.text.size())
+        {
+            // Too long to cache
+            return getInfo(icode)->opinfo->dasmTo(buf, cap);
+        }
+        DasmWriter os(buf, cap);
+        os << std::string_view(line.text.data(), line.len);
+        return line.len;
+    }
+
+    // The disassembly cache is off by default (it takes DASM_CACHE_LINE_SIZE bytes per line)
+    void enableDasmCache(const bool enable)
+    {
+        if (!enable)
+        {
+            dasm_cache_.reset();
+        }
+        else if (dasm_cache_ == nullptr)
+        {
+            dasm_cache_.reset(new DasmCache());
+        }
+    }
+
+    bool isDasmCacheEnabled() const { return dasm_cache_ != nullptr; }
+
+    using DecodedViewType = DecodedView<AnnotationType>;
+    static_assert(std::is_trivially_copyable_v<DecodedViewType>);
+
+    /**
+     * \brief Decode icode into a DecodedView (a handle to the line of this table's view cache
+     * that holds the decode)
+     *
+     * A hit costs one direct-mapped lookup; there is no allocation or reference counting. The
+     * view reports itself stale (isValid()) once its line is reused for another opcode, or after
+     * flushCaches() or releaseDecodedViews(), and must not be used once this table is destroyed.
+     */
+    DecodedViewType getDecodedView(const Opcode icode)
+    {
+        if (view_cache_ != nullptr)
+        {
+            const ViewLine &line = (*view_cache_)[icode % CACHE_SIZE];
+            if ((line.data.generation != 0) && (line.data.icode == icode))
+            {
+                return DecodedViewType(&line.data, line.data.generation);
+            }
+        }
+        return buildDecodedView_(icode);
+    }
+
+    // Mark all the DecodedViews handed out so far stale (the view cache itself stays allocated,
+    // since they point into it)
+    void releaseDecodedViews()
+    {
+        if (view_cache_ != nullptr)
+        {
+            view_cache_->fill(ViewLine());
+        }
+    }
+
     template <class InstTypeAllocator, typename... ArgTypes>
     typename InstType::PtrType makeInst(const Opcode icode, InstTypeAllocator &allocator,
                                         ArgTypes &&... args)
@@ -185,19 +428,22 @@ class DTable
                                                  InstTypeAllocator &allocator,
                                                  ArgTypes &&... args)
     {
-        auto inst = makeInst(tinfo.getOpcode(), allocator, std::forward<ArgTypes>(args)...);
-
-        if (std::string(inst->getMnemonic()) != tinfo.getMnemonic())
+        const Opcode icode = tinfo.getOpcode();
+        TraceLine &line = trace_cache_[icode % CACHE_SIZE];
+        // A pointer compare when the trace carries its mnemonic as a Symbol
+        if (!line.valid || (line.icode != icode) || (line.mnemonic != tinfo.getMnemonic()))
         {
-            InstMetaData::PtrType einfo(new InstMetaData(InstMetaData::ISA::RV32I));
-            auto ifact = builder_->build(tinfo.getMnemonic(), tinfo.getMnemonic(), "", 0, einfo);
-            ExtractorIF::PtrType extractor(new ExtractorTraceInfo<TraceInfoType>(tinfo));
-            const auto &info = ifact->getInfo(tinfo.getMnemonic(), tinfo.getOpcode(), extractor);
-            inst = allocator(info->opinfo, info->uinfo, std::forward<ArgTypes>(args)...);
-            icache_->allocate(tinfo.getOpcode(), inst);
+            resolveTrace_(tinfo, line);
         }
 
-        return inst;
+        if (!line.mismatch)
+        {
+            return makeInst(icode, allocator, std::forward<ArgTypes>(args)...);
+        }
+        // The operands are this record's
+        const ExtractorIF::PtrType extractor(new ExtractorTraceInfo<TraceInfoType>(tinfo));
+        return allocator(line.mismatch_inst.makeOpcodeInfo(extractor, icode),
+                         line.mismatch_inst.anno, std::forward<ArgTypes>(args)...);
     }
 
     template <class InstTypeAllocator, typename... ArgTypes>
@@ -233,6 +479,43 @@ class DTable
         return inst;
     }
 
+    using PreparedInstType = PreparedInst<AnnotationType>;
+
+    /**
+     * \brief Resolve the factory, UID, meta data and annotation of an instruction once, for
+     * repeated makeInstDirectly(prepared, ...) calls (see mavis/PreparedInst.h)
+     */
+    PreparedInstType prepareInstDirectly(const std::string &mnemonic) const
+    {
+        const auto &ifact = builder_->findIFact(mnemonic);
+        if (ifact == nullptr)
+        {
+            throw UnknownMnemonic(mnemonic);
+        }
+        return ifact->prepare(mnemonic);
+    }
+
+    PreparedInstType prepareInstDirectly(const InstructionUniqueID uid) const
+    {
+        const std::string &mnemonic = builder_->findInstructionMnemonic(uid);
+        const auto ifact = builder_->findIFact(uid);
+        if (ifact == nullptr)
+        {
+            throw UnknownMnemonic(mnemonic);
+        }
+        return ifact->prepare(mnemonic);
+    }
+
+    template <class InstTypeAllocator, typename... ArgTypes>
+    typename InstType::PtrType makeInstDirectly(const PreparedInstType &prepared,
+                                                const ExtractorDirectInfoIF &ex_info,
+                                                InstTypeAllocator &allocator,
+                                                ArgTypes &&... args)
+    {
+        return allocator(prepared.makeOpcodeInfo(ex_info), prepared.anno,
+                         std::forward<ArgTypes>(args)...);
+    }
+
     void morphInst(typename InstType::PtrType inst, const ExtractorDirectInfoIF &ex_info) const
     {
         auto ifact = builder_->findIFact(ex_info.getMnemonic());
@@ -252,6 +535,94 @@ class DTable
         icache_.reset(new InstCache());
         ocache_.reset(new IFactoryCache());
         root_->flushCaches();
+        releaseDecodedViews();
+        class_cache_.fill(ClassLine());
+        trace_cache_.fill(TraceLine());
+        if (dasm_cache_ != nullptr)
+        {
+            dasm_cache_->fill(DasmLine());
+        }
+        illegal_.reset();
+    }
+
+    /**
+     * \brief Drop the cached decodes (at every level, down to the leaf factories) of the opcodes
+     * selected by filter, leaving the others warm
+     *
+     * DecodedViews already handed out for the dropped opcodes go stale; the next
+     * getDecodedView() of a dropped opcode decodes it again.
+     */
+    void invalidate(const CacheFilter &filter)
+    {
+        const auto selected = [this, &filter](const Opcode icode)
+        { return isSelected_(filter, icode); };
+
+        // Everything that needs the UID of an opcode goes before ocache_ and the leaves
+        icache_->invalidateIf([&selected](const Opcode icode, const auto &) { return selected(icode); });
+        for (auto &line : class_cache_)
+        {
+            if (line.valid && filter.matches(line.oclass.icode, line.oclass.uid))
+            {
+                line = ClassLine();
+            }
+        }
+        for (auto &line : trace_cache_)
+        {
+            if (line.valid
+                && (selected(line.icode)
+                    || (line.mismatch && filter.matches(line.icode, line.mismatch_inst.uid))))
+            {
+                line = TraceLine();
+            }
+        }
+        if (dasm_cache_ != nullptr)
+        {
+            for (auto &line : *dasm_cache_)
+            {
+                if (line.valid && selected(line.icode))
+                {
+                    line.valid = false;
+                }
+            }
+        }
+        if (view_cache_ != nullptr)
+        {
+            for (auto &line : *view_cache_)
+            {
+                if ((line.data.generation != 0) && filter.matches(line.data.icode, line.data.uid))
+                {
+                    line = ViewLine();
+                }
+            }
+        }
+
+        ocache_->invalidateIf(
+            [&filter](const Opcode icode, const auto &info)
+            { return filter.matches(icode, info->opinfo->getInstructionUniqueID()); });
+        root_->flushCachesIf(filter);
+
+        // Undecodable opcodes have no UID to match
+        if (!filter.needsUID() && (illegal_ != nullptr))
+        {
+            for (auto &line : *illegal_)
+            {
+                if ((line.error != nullptr) && filter.matchesOpcode(line.icode))
+                {
+                    line = IllegalLine();
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief Drop only the cached instructions (made from the annotations) of the opcodes
+     * selected by filter, e.g. after changing their annotations in place. Decodes, classes,
+     * disassembly, and DecodedViews (which refer to the annotations) are kept.
+     */
+    void invalidateAnnotations(const CacheFilter &filter)
+    {
+        icache_->invalidateIf([this, &filter](const Opcode icode, const auto &)
+                              { return isSelected_(filter, icode); });
     }
 
     void print(std::ostream &os) const { root_->print(os); }
@@ -264,6 +635,144 @@ class DTable
     std::unique_ptr<InstCache> icache_;
     std::unique_ptr<IFactoryCache> ocache_;
 
+    // Resolution of a (trace opcode, trace mnemonic) pair: either the decode of the opcode
+    // agrees with the trace, or mismatch_inst holds the factory, UID, meta data and annotation of
+    // the trace mnemonic (each record still supplies its own operands)
+    struct TraceLine
+    {
+        Opcode icode = 0;
+        Symbol mnemonic;
+        PreparedInstType mismatch_inst;
+        bool mismatch = false;
+        bool valid = false;
+    };
+    std::array<TraceLine, CACHE_SIZE> trace_cache_;
+
+    template <typename TraceInfoType>
+    void resolveTrace_(const TraceInfoType &tinfo, TraceLine &line)
+    {
+        const Opcode icode = tinfo.getOpcode();
+        const std::string &mnemonic = tinfo.getMnemonic();
+        line = TraceLine();
+        if (getInfo(icode)->opinfo->getMnemonic() != mnemonic)
+        {
+            InstMetaData::PtrType einfo(new InstMetaData(InstMetaData::ISA::RV32I));
+            builder_->build(mnemonic, mnemonic, "", 0, einfo);
+            line.mismatch_inst = prepareInstDirectly(mnemonic);
+            line.mismatch = true;
+        }
+        line.icode = icode;
+        line.mnemonic = Symbol(mnemonic);
+        line.valid = true;
+    }
+
+    struct ClassLine
+    {
+        OpcodeClass oclass;
+        bool valid = false;
+    };
+    std::array<ClassLine, CACHE_SIZE> class_cache_{};
+
+    // Rendered disassembly per opcode (see dasmTo)
+    constexpr static inline size_t DASM_CACHE_LINE_SIZE = 64;
+    struct DasmLine
+    {
+        Opcode icode = 0;
+        size_t len = 0;
+        bool valid = false;
+        std::array<char, DASM_CACHE_LINE_SIZE> text{};
+    };
+    using DasmCache = std::array<DasmLine, CACHE_SIZE>;
+    std::unique_ptr<DasmCache> dasm_cache_;
+
+    // Direct-mapped DecodedView cache (allocated on first use, and kept until this table is
+    // destroyed); info keeps the annotation a view points to alive. Every fill of a line gets a
+    // new generation, which is how the views of its previous opcode go stale.
+    struct ViewLine
+    {
+        typename IFactoryIF<InstType, AnnotationType>::IFactoryInfo::PtrType info;
+        typename DecodedViewType::DataType data;
+    };
+    using ViewCache = std::array<ViewLine, CACHE_SIZE>;
+    std::unique_ptr<ViewCache> view_cache_;
+    uint64_t view_generation_ = 0;
+
+    DecodedViewType buildDecodedView_(const Opcode icode)
+    {
+        const auto info = getInfo(icode);
+        if (view_cache_ == nullptr)
+        {
+            view_cache_.reset(new ViewCache());
+        }
+        ViewLine &line = (*view_cache_)[icode % CACHE_SIZE];
+        line.data = typename DecodedViewType::DataType(*info->opinfo, info->uinfo.get(),
+                                                       ++view_generation_);
+        line.info = info;
+        return DecodedViewType(&line.data, line.data.generation);
+    }
+
+    // UID of an already decoded opcode, without caching anything new in ocache_
+    InstructionUniqueID lookupUID_(const Opcode icode)
+    {
+        if (const auto &ohandle = ocache_->lookup(icode); ohandle != nullptr)
+        {
+            return ohandle->opinfo->getInstructionUniqueID();
+        }
+        return root_->getInfo(icode)->opinfo->getInstructionUniqueID();
+    }
+
+    bool isSelected_(const CacheFilter &filter, const Opcode icode)
+    {
+        return filter.matchesOpcode(icode)
+               && (!filter.needsUID() || (lookupUID_(icode) == filter.uid));
+    }
+
+    // Negative cache: the exception an undecodable opcode threw, rethrown without another walk
+    // of the decode tree. Direct mapped like the other caches, so that data swept as text cannot
+    // grow it without bound; allocated on the first undecodable opcode
+    struct IllegalLine
+    {
+        Opcode icode = 0;
+        std::exception_ptr error; // nullptr if the line is empty
+    };
+    using IllegalCache = std::array<IllegalLine, CACHE_SIZE>;
+    std::unique_ptr<IllegalCache> illegal_;
+
+    // Called in the handler of the opcode's exception
+    void cacheIllegal_(const Opcode icode)
+    {
+        if (illegal_ == nullptr)
+        {
+            illegal_.reset(new IllegalCache());
+        }
+        (*illegal_)[icode % CACHE_SIZE] = {icode, std::current_exception()};
+    }
+
+    // Opcodes decoded while recording (see enableOpcodeRecording)
+    std::unique_ptr<std::unordered_set<Opcode>> recorded_;
+    mutable uint64_t fingerprint_ = 0;
+
+    void flattenRoutes_(const typename IFactoryIF<InstType, AnnotationType>::PtrType &node,
+                        uint32_t family, Opcode mask, Opcode value,
+                        std::vector<DecodeRoute> &routes) const;
+
+    // Expansions and overlays are deferred until all base instructions are built
+    struct DeferredInst_
+    {
+        const std::string &jfile;
+        const json_object &inst;
+        const std::string mnemonic;
+        const MatchSet<Tag> tags;
+
+        DeferredInst_(const std::string &jfile, const json_object &inst,
+                      const std::string &mnemonic, const MatchSet<Tag> &tags)
+            : jfile(jfile), inst(inst), mnemonic(mnemonic), tags(tags)
+        {}
+    };
+
+    void configureInst_(const std::string &jfile, const json_object &inst,
+                        TagFilter &filter, std::vector<DeferredInst_> &expansions);
+
     void parseInstInfo_(const std::string &jfile, const json_object &inst,
                         const std::string &mnemonic, const MatchSet<Tag> &tags);
 
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace mavis
+{
+
+    /**
+     * \brief Non-allocating text appender for disassembly (see ExtractorIF::dasmTo)
+     *
+     * Writes into a caller-provided buffer, with the subset of std::ostream formatting that the
+     * extractors use (strings, characters, integers, and the std::hex / std::dec manipulators).
+     * Output that does not fit is dropped, but still counted: like snprintf, required() is the
+     * length of the complete text, and the buffer is always NUL terminated (when cap > 0).
+     */
+    class DasmWriter
+    {
+      public:
+        DasmWriter(char* buf, const size_t cap) : buf_(buf), cap_(cap)
+        {
+            if (cap_ > 0)
+            {
+                buf_[0] = '\0';
+            }
+        }
+
+        DasmWriter(const DasmWriter &) = delete;
+
+        // Characters in the buffer (excluding the NUL)
+        size_t size() const { return (required_ < cap_) ? required_ : ((cap_ > 0) ? cap_ - 1 : 0); }
+
+        // Length of the complete text
+        size_t required() const { return required_; }
+
+        bool truncated() const { return required_ >= cap_; }
+
+        std::string_view view() const { return std::string_view(buf_, size()); }
+
+        DasmWriter & operator<<(const std::string_view s)
+        {
+            const size_t start = size();
+            required_ += s.size();
+            if (cap_ > 0)
+            {
+                const size_t end = size();
+                std::memcpy(buf_ + start, s.data(), end - start);
+                buf_[end] = '\0';
+            }
+            return *this;
+        }
+
+        DasmWriter & operator<<(const std::string & s) { return *this << std::string_view(s); }
+
+        DasmWriter & operator<<(const char* s) { return *this << std::string_view(s); }
+
+        DasmWriter & operator<<(const char c) { return *this << std::string_view(&c, 1); }
+
+        DasmWriter & operator<<(const signed char c) { return *this << static_cast<char>(c); }
+
+        DasmWriter & operator<<(const unsigned char c) { return *this << static_cast<char>(c); }
+
+        // As with std::ostream, hex output of a signed value is of its two's complement
+        template <typename T>
+        std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, DasmWriter &>
+        operator<<(const T val)
+        {
+            return writeInt_(val, hex_);
+        }
+
+        // Decimal output, regardless of (and without changing) the current base
+        template <typename T> DasmWriter & dec(const T val) { return writeInt_(val, false); }
+
+        DasmWriter & operator<<(const bool val) { return *this << (val ? '1' : '0'); }
+
+        // std::hex and std::dec (other manipulators are ignored)
+        DasmWriter & operator<<(std::ios_base & (*manip)(std::ios_base &))
+        {
+            if (manip == static_cast<std::ios_base & (*)(std::ios_base &)>(std::hex))
+            {
+                hex_ = true;
+            }
+            else if (manip == static_cast<std::ios_base & (*)(std::ios_base &)>(std::dec))
+            {
+                hex_ = false;
+            }
+            return *this;
+        }
+
+      private:
+        template <typename T> DasmWriter & writeInt_(const T val, const bool hex)
+        {
+            using UnsignedT = std::make_unsigned_t<T>;
+            char digits[24];
+            char* p = digits + sizeof(digits);
+            if (hex)
+            {
+                UnsignedT u = static_cast<UnsignedT>(val);
+                do
+                {
+                    *--p = "0123456789abcdef"[u & 0xf];
+                    u >>= 4;
+                } while (u != 0);
+            }
+            else
+            {
+                bool negative = false;
+                UnsignedT u = static_cast<UnsignedT>(val);
+                if constexpr (std::is_signed_v<T>)
+                {
+                    negative = val < 0;
+                    u = negative ? UnsignedT(0) - u : u;
+                }
+                do
+                {
+                    *--p = static_cast<char>('0' + (u % 10));
+                    u /= 10;
+                } while (u != 0);
+                if (negative)
+                {
+                    *--p = '-';
+                }
+            }
+            return *this << std::string_view(p, (digits + sizeof(digits)) - p);
+        }
+
+        char* const buf_;
+        const size_t cap_;
+        size_t required_ = 0;
+        bool hex_ = false;
+    };
+
+    /**
+     * \brief Register name for disassembly: prefix character ('x', 'f', 'v', or none) and number
+     */
+    struct DasmReg
+    {
+        char prefix;
+        uint32_t regnum;
+    };
+
+    inline DasmWriter & operator<<(DasmWriter & out, const DasmReg & reg)
+    {
+        if (reg.prefix != '\0')
+        {
+            out << reg.prefix;
+        }
+        return out.dec(reg.regnum);
+    }
+
+    /**
+     * \brief Render with a writer into a std::string (for the std::string disassembly API)
+     *
+     * \param render Callable that writes the text to the DasmWriter passed to it. It is called a
+     * second time, with a buffer of the required size, only if the text does not fit on the stack
+     */
+    template <typename RenderFunc> std::string dasmToString(RenderFunc && render)
+    {
+        char buf[256];
+        DasmWriter out(buf, sizeof(buf));
+        render(out);
+        if (!out.truncated())
+        {
+            return std::string(out.view());
+        }
+
+        std::string str(out.required() + 1, '\0');
+        DasmWriter full(str.data(), str.size());
+        render(full);
+        str.resize(full.size());
+        return str;
+    }
+
+} // namespace mavis
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+
+#include "IFactory.h"
+#include "InstMetaData.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Decode tree nodes and metadata shared between the contexts of a ContextRegistry
+     *
+     * After a context's DTable is built, share() replaces each of its leaves (IFactory), and each
+     * of its subtrees (special-case and dense composites), with an equal one already in the pool,
+     * bottom up; nodes with no equal are added to the pool. InstMetaData is shared the same way,
+     * by value. Contexts with different ISA files therefore share what they have in common, e.g.
+     * the leaves and subtrees of the base ISA.
+     *
+     * Leaves are equal when they make the same instructions, with the same UIDs, metadata,
+     * overlays and annotations. UIDs are per context unless contexts are given the same UID
+     * list, so leaves (and the subtrees above them) are only shared between such contexts;
+     * metadata is always shared. A pool serves contexts using one annotation registry.
+     *
+     * Shared nodes keep their (per-leaf) decode caches, so flushing one context's caches flushes
+     * those of the nodes it shares too.
+     */
+    template <typename InstType, typename AnnotationType> class DecodeNodePool
+    {
+      public:
+        using NodePtrType = typename IFactoryIF<InstType, AnnotationType>::PtrType;
+
+        // Node of the tree being shared -> the node that replaces it
+        using ReplacementMap = std::map<const IFactoryIF<InstType, AnnotationType>*, NodePtrType>;
+
+        /**
+         * \brief Share node and its subtree; returns the node to use in its place
+         *
+         * Nodes of other types (and their subtrees) are kept as they are.
+         */
+        NodePtrType share(const NodePtrType & node, ReplacementMap & replaced)
+        {
+            if (const auto iter = replaced.find(node.get()); iter != replaced.end())
+            {
+                return iter->second;
+            }
+
+            using LeafType = IFactory<InstType, AnnotationType>;
+            using SpecialCaseType = IFactorySpecialCaseComposite<InstType, AnnotationType>;
+            using DenseType = IFactoryDenseComposite<InstType, AnnotationType>;
+
+            std::string sig;
+            if (const auto leaf = std::dynamic_pointer_cast<LeafType>(node))
+            {
+                leaf->shareMetaData([this](const std::string & name, const InstMetaData::PtrType & meta)
+                                    { return shareMetaData(name, meta); });
+                sig = "L";
+                leaf->appendSignature(sig);
+            }
+            else if (const auto scnode = std::dynamic_pointer_cast<SpecialCaseType>(node))
+            {
+                scnode->replaceChildren([this, &replaced](const NodePtrType & child)
+                                        { return share(child, replaced); });
+                sig = "S" + getSignature_(*scnode);
+            }
+            else if (const auto dnode = std::dynamic_pointer_cast<DenseType>(node))
+            {
+                dnode->replaceChildren([this, &replaced](const NodePtrType & child)
+                                       { return share(child, replaced); });
+                sig = "D" + getSignature_(*dnode);
+            }
+            else
+            {
+                return replaced[node.get()] = node;
+            }
+
+            const auto [iter, added] = nodes_.try_emplace(std::move(sig), node);
+            if (!added)
+            {
+                ++num_shared_;
+            }
+            return replaced[node.get()] = iter->second;
+        }
+
+        /**
+         * \brief Equal metadata already in the pool, or meta (now in the pool)
+         * \param name Instruction (or factory) the metadata belongs to: only metadata with the
+         * same name is compared
+         */
+        InstMetaData::PtrType shareMetaData(const std::string & name, const InstMetaData::PtrType & meta)
+        {
+            if (meta == nullptr)
+            {
+                return meta;
+            }
+            const auto range = metas_.equal_range(name);
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                if (iter->second == meta)
+                {
+                    return meta;
+                }
+                if (*iter->second == *meta)
+                {
+                    ++num_shared_;
+                    return iter->second;
+                }
+            }
+            metas_.emplace(name, meta);
+            return meta;
+        }
+
+        // Number of nodes and metadata objects replaced by ones already in the pool
+        size_t getNumShared() const { return num_shared_; }
+
+      private:
+        std::map<std::string, NodePtrType> nodes_;          // By signature
+        std::multimap<std::string, InstMetaData::PtrType> metas_; // By instruction name
+        size_t num_shared_ = 0;
+
+        // Children are compared by identity (they are shared first). Special-case extractors are
+        // clones of the form's extractor, restricted to the entry's fields: they are compared by
+        // type, mask and field set
+        static std::string
+        getSignature_(const IFactorySpecialCaseComposite<InstType, AnnotationType> & node)
+        {
+            std::ostringstream ss;
+            ss << std::hex;
+            for (const auto & entry : node.getSpecialCases())
+            {
+                ss << entry.mnemonic << '\0' << entry.mask << '\0' << entry.field_set << '\0'
+                   << entry.value << '\0' << entry.nfixed << '\0' << entry.factory.get() << '\0'
+                   << typeid(*entry.extractor).name() << '\0';
+            }
+            const auto & dflt = node.getDefaultCase();
+            if (dflt.factory != nullptr)
+            {
+                ss << "default" << '\0' << dflt.mnemonic << '\0' << dflt.value << '\0'
+                   << dflt.factory.get() << '\0' << dflt.extractor.get() << '\0';
+            }
+            return ss.str();
+        }
+
+        static std::string getSignature_(const IFactoryDenseComposite<InstType, AnnotationType> & node)
+        {
+            const Field & field = *node.getField();
+            std::ostringstream ss;
+            ss << std::hex << field.getName() << '\0' << field.getShiftedMask() << '\0'
+               << field.getSize() << '\0';
+            for (uint32_t index = 0; index < field.getSize(); ++index)
+            {
+                if (node.getChild(index) != nullptr)
+                {
+                    ss << index << '\0' << node.getChild(index).get() << '\0';
+                }
+            }
+            ss << "default" << '\0' << node.getDefault().get() << '\0';
+            return ss.str();
+        }
+    };
+
+} // namespace mavis
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "DecoderTypes.h"
+#include "DecoderExceptions.h"
+#include "SPSCRing.hpp"
+
+namespace mavis
+{
+
+    /**
+     * \brief Decodes batches of opcodes on worker threads, overlapping decode with the stages
+     * that produce the opcodes and consume the instructions
+     *
+     * One thread submits batches and one thread takes the decoded batches back, in submission
+     * order. A single thread doing both must use trySubmit() and tryNext(): the blocking
+     * submit() waits for room in a worker's input ring, which never comes while its output
+     * ring is full and nobody takes from it. A DTable is not thread safe, so each worker decodes with its
+     * own decoder (as mavis_objdump does), made by the make_decoder callable on the worker's
+     * thread. Batches are dealt to the workers round-robin, over one SPSC ring per worker in
+     * each direction, so every ring has a single producer and a single consumer and the output
+     * order needs no reordering. Full rings push back on submit(); see SPSCRing for the wait
+     * policies.
+     *
+     * UIDs are handed out by a process-wide counter, so separately built decoders number the
+     * same instruction differently unless they are given the same InstUIDList. Every worker's
+     * decoder is built with Options::uid_list, or else with the UIDs of the first worker's
+     * decoder (built before the others): an instruction has one UID whichever worker decoded
+     * it. Pass the UIDs of the decoder the consumer uses (Mavis::getInstUIDList) to have the
+     * pipeline's UIDs match it too.
+     *
+     * \tparam MavisType Decoder (e.g. a Mavis instance per worker)
+     */
+    template <typename MavisType> class DecodePipeline
+    {
+      public:
+        using InstPtrType = typename MavisType::InstPtrType;
+
+        struct DecodedBatch
+        {
+            std::vector<Opcode> icodes;
+            std::vector<InstPtrType> insts; // nullptr for an opcode that does not decode
+            std::exception_ptr error;       // Any other failure, rethrown by next()
+        };
+
+        struct Options
+        {
+            uint32_t workers = 1;
+            size_t ring_capacity = 16; // Batches in flight per worker, each way
+            WaitPolicy wait = WaitPolicy::BLOCK;
+            uint32_t spin_count = 1024; // Polls before sleeping (WaitPolicy::BLOCK)
+            InstUIDList uid_list;       // UIDs of every worker's decoder (empty: the first's)
+        };
+
+        // Build a decoder with the given UIDs (e.g. as the uid_list Mavis constructor argument)
+        using MakeDecoderFunc = std::function<std::unique_ptr<MavisType>(const InstUIDList &)>;
+
+        // Decode one opcode (e.g. [](MavisType & m, Opcode icode) { return m.makeInst(icode); })
+        using DecodeFunc = std::function<InstPtrType(MavisType &, Opcode)>;
+
+        DecodePipeline(const MakeDecoderFunc & make_decoder, const DecodeFunc & decode,
+                       const Options & options = Options()) :
+            decode_(decode)
+        {
+            const uint32_t n_workers = std::max<uint32_t>(options.workers, 1);
+            for (uint32_t w = 0; w < n_workers; ++w)
+            {
+                workers_.emplace_back(new Worker(options));
+            }
+
+            // The decoders are built on the workers' threads, in parallel once the UIDs are known
+            std::promise<InstUIDList> first_uids;
+            const std::shared_future<InstUIDList> uids = first_uids.get_future().share();
+            if (!options.uid_list.empty())
+            {
+                first_uids.set_value(options.uid_list);
+            }
+            std::vector<std::future<void>> built;
+            for (uint32_t w = 0; w < n_workers; ++w)
+            {
+                Worker & worker = *workers_[w];
+                built.emplace_back(worker.built.get_future());
+                std::promise<InstUIDList>* uids_from =
+                    ((w == 0) && options.uid_list.empty()) ? &first_uids : nullptr;
+                worker.thread = std::thread(&DecodePipeline::run_, this, std::ref(worker),
+                                            std::cref(make_decoder), uids_from, uids);
+            }
+
+            // Report the first build error, once every worker is done with make_decoder
+            std::exception_ptr error;
+            for (auto & status : built)
+            {
+                try
+                {
+                    status.get();
+                }
+                catch (...)
+                {
+                    if (error == nullptr)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error != nullptr)
+            {
+                shutdown_();
+                std::rethrow_exception(error);
+            }
+        }
+
+        DecodePipeline(const DecodePipeline &) = delete;
+
+        ~DecodePipeline() { shutdown_(); }
+
+        /**
+         * \brief Submit a batch of opcodes (producer thread). Waits while the next worker's
+         * input ring is full.
+         * \return false if the pipeline was closed
+         */
+        bool submit(std::vector<Opcode> && icodes)
+        {
+            Worker & worker = *workers_[submitted_ % workers_.size()];
+            if (!worker.input.push(std::move(icodes)))
+            {
+                return false;
+            }
+            ++submitted_;
+            return true;
+        }
+
+        // As submit(), but fail instead of waiting (icodes is left as it was)
+        bool trySubmit(std::vector<Opcode> & icodes)
+        {
+            Worker & worker = *workers_[submitted_ % workers_.size()];
+            std::vector<Opcode> batch(std::move(icodes));
+            if (!worker.input.tryPush(std::move(batch)))
+            {
+                icodes = std::move(batch);
+                return false;
+            }
+            ++submitted_;
+            return true;
+        }
+
+        /**
+         * \brief The next decoded batch, in submission order (consumer thread). Waits until it
+         * is decoded.
+         * \return false once the pipeline is closed and every batch has been taken
+         */
+        bool next(DecodedBatch & batch)
+        {
+            if (!workers_[taken_ % workers_.size()]->output.pop(batch))
+            {
+                return false;
+            }
+            ++taken_;
+            if (batch.error != nullptr)
+            {
+                std::rethrow_exception(batch.error);
+            }
+            return true;
+        }
+
+        // As next(), but fail instead of waiting
+        bool tryNext(DecodedBatch & batch)
+        {
+            if (!workers_[taken_ % workers_.size()]->output.tryPop(batch))
+            {
+                return false;
+            }
+            ++taken_;
+            if (batch.error != nullptr)
+            {
+                std::rethrow_exception(batch.error);
+            }
+            return true;
+        }
+
+        // No more batches (producer thread): the workers finish those already submitted
+        void close()
+        {
+            for (auto & worker : workers_)
+            {
+                worker->input.close();
+            }
+        }
+
+      private:
+        struct Worker
+        {
+            explicit Worker(const Options & options) :
+                input(options.ring_capacity, options.wait, options.spin_count),
+                output(options.ring_capacity, options.wait, options.spin_count)
+            {
+            }
+
+            std::unique_ptr<MavisType> decoder;
+            SPSCRing<std::vector<Opcode>> input;
+            SPSCRing<DecodedBatch> output;
+            std::promise<void> built;
+            std::thread thread;
+        };
+
+        void shutdown_()
+        {
+            close();
+            for (auto & worker : workers_)
+            {
+                // Unblock workers waiting on a full output ring nobody will drain
+                worker->output.close();
+                if (worker->thread.joinable())
+                {
+                    worker->thread.join();
+                }
+            }
+        }
+
+        // uids_from: set to the UIDs of this worker's decoder, for the others
+        void run_(Worker & worker, const MakeDecoderFunc & make_decoder,
+                  std::promise<InstUIDList>* uids_from, std::shared_future<InstUIDList> uids)
+        {
+            try
+            {
+                worker.decoder = make_decoder(uids_from ? InstUIDList() : uids.get());
+                if (uids_from != nullptr)
+                {
+                    uids_from->set_value(worker.decoder->getInstUIDList());
+                }
+                worker.built.set_value();
+            }
+            catch (...)
+            {
+                if (uids_from != nullptr)
+                {
+                    uids_from->set_exception(std::current_exception());
+                }
+                worker.built.set_exception(std::current_exception());
+                worker.output.close();
+                return;
+            }
+
+            std::vector<Opcode> icodes;
+            while (worker.input.pop(icodes))
+            {
+                DecodedBatch batch;
+                batch.insts.reserve(icodes.size());
+                try
+                {
+                    for (const Opcode icode : icodes)
+                    {
+                        try
+                        {
+                            batch.insts.emplace_back(decode_(*worker.decoder, icode));
+                        }
+                        catch (const BaseException &)
+                        {
+                            batch.insts.emplace_back(nullptr);
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    batch.error = std::current_exception();
+                }
+                batch.icodes = std::move(icodes);
+                if (!worker.output.push(std::move(batch)))
+                {
+                    break;
+                }
+            }
+            worker.output.close();
+        }
+
+        const DecodeFunc decode_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+
+        // Batch counts, each touched by one side only
+        uint64_t submitted_ = 0;
+        uint64_t taken_ = 0;
+    };
+
+} // namespace mavis
@@ -8,6 +8,7 @@
 
 #include "DecoderConsts.h"
 #include "Extractor.h"
+#include "Symbol.hpp"
 
 namespace mavis
 {
@@ -161,15 +162,12 @@ namespace mavis
 
       public:
         // Architectural information
-        const std::string mnemonic;
+        const Symbol mnemonic;
         const InstructionUniqueID unique_id;
 
         const OperandInfo source_opinfo;
         const OperandInfo dest_opinfo;
 
-        const OperandInfo::ElementList source_opinfo_list;
-        const OperandInfo::ElementList dest_opinfo_list;
-
         const uint64_t sources;
         // const OperandArray source_vals;
         const uint32_t n_sources;
@@ -276,15 +274,19 @@ namespace mavis
         DecodedInstructionInfo(const std::string & iname, const InstructionUniqueID uid,
                                const ExtractorIF::PtrType & extractor,
                                const InstMetaData::PtrType & meta, const Opcode icode) :
+            DecodedInstructionInfo(Symbol(iname), uid, extractor, meta, icode)
+        {
+        }
+
+        DecodedInstructionInfo(const Symbol & iname, const InstructionUniqueID uid,
+                               const ExtractorIF::PtrType & extractor,
+                               const InstMetaData::PtrType & meta, const Opcode icode) :
             mnemonic(iname),
             unique_id(uid),
 
             source_opinfo(extractor->getSourceOperandInfo(icode, meta)),
             dest_opinfo(extractor->getDestOperandInfo(icode, meta)),
 
-            source_opinfo_list(source_opinfo.getElements()),
-            dest_opinfo_list(dest_opinfo.getElements()),
-
             sources(extractor->getSourceRegs(icode)),
             // source_vals(extractor->getSourceList(icode)),
             n_sources(source_opinfo.getNOpers()),
@@ -480,32 +482,34 @@ namespace mavis
                 // assert(agree_(addr_source_vals, addr_sources, "addr_sources", form_name));
                 // assert(agree_(data_source_vals, data_sources, "data_sources", form_name));
 
-                assert(agree_opinfo_(source_opinfo_list, sources, "sources", form_name));
-                assert(agree_opinfo_(source_opinfo_list, word_sources, "word_sources", form_name,
+                [[maybe_unused]] const auto & source_elems = source_opinfo.getElements();
+                [[maybe_unused]] const auto & dest_elems = dest_opinfo.getElements();
+                assert(agree_opinfo_(source_elems, sources, "sources", form_name));
+                assert(agree_opinfo_(source_elems, word_sources, "word_sources", form_name,
                                      InstMetaData::OperandTypes::WORD));
-                assert(agree_opinfo_(source_opinfo_list, long_sources, "long_sources", form_name,
+                assert(agree_opinfo_(source_elems, long_sources, "long_sources", form_name,
                                      InstMetaData::OperandTypes::LONG));
-                assert(agree_opinfo_(source_opinfo_list, single_sources, "single_sources",
+                assert(agree_opinfo_(source_elems, single_sources, "single_sources",
                                      form_name, InstMetaData::OperandTypes::SINGLE));
-                assert(agree_opinfo_(source_opinfo_list, double_sources, "double_sources",
+                assert(agree_opinfo_(source_elems, double_sources, "double_sources",
                                      form_name, InstMetaData::OperandTypes::DOUBLE));
-                assert(agree_opinfo_(source_opinfo_list, quad_sources, "quad_sources", form_name,
+                assert(agree_opinfo_(source_elems, quad_sources, "quad_sources", form_name,
                                      InstMetaData::OperandTypes::QUAD));
-                assert(agree_opinfo_(source_opinfo_list, vector_sources, "vector_sources",
+                assert(agree_opinfo_(source_elems, vector_sources, "vector_sources",
                                      form_name, InstMetaData::OperandTypes::VECTOR));
 
-                assert(agree_opinfo_(dest_opinfo_list, dests, "dests", form_name));
-                assert(agree_opinfo_(dest_opinfo_list, word_dests, "word_dests", form_name,
+                assert(agree_opinfo_(dest_elems, dests, "dests", form_name));
+                assert(agree_opinfo_(dest_elems, word_dests, "word_dests", form_name,
                                      InstMetaData::OperandTypes::WORD));
-                assert(agree_opinfo_(dest_opinfo_list, long_dests, "long_dests", form_name,
+                assert(agree_opinfo_(dest_elems, long_dests, "long_dests", form_name,
                                      InstMetaData::OperandTypes::LONG));
-                assert(agree_opinfo_(dest_opinfo_list, single_dests, "single_dests", form_name,
+                assert(agree_opinfo_(dest_elems, single_dests, "single_dests", form_name,
                                      InstMetaData::OperandTypes::SINGLE));
-                assert(agree_opinfo_(dest_opinfo_list, double_dests, "double_dests", form_name,
+                assert(agree_opinfo_(dest_elems, double_dests, "double_dests", form_name,
                                      InstMetaData::OperandTypes::DOUBLE));
-                assert(agree_opinfo_(dest_opinfo_list, quad_dests, "quad_dests", form_name,
+                assert(agree_opinfo_(dest_elems, quad_dests, "quad_dests", form_name,
                                      InstMetaData::OperandTypes::QUAD));
-                assert(agree_opinfo_(dest_opinfo_list, vector_dests, "vector_dests", form_name,
+                assert(agree_opinfo_(dest_elems, vector_dests, "vector_dests", form_name,
                                      InstMetaData::OperandTypes::VECTOR));
             }
 #endif
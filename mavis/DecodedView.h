@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#include "DecoderTypes.h"
+#include "OpcodeInfo.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Decode information flattened out of an OpcodeInfo, held once per line of a decoder's
+     * view cache (see DecodedView)
+     */
+    template <typename AnnotationType> struct DecodedViewData
+    {
+        using InstructionTypes = InstMetaData::InstructionTypes;
+        using ISAExtension = InstMetaData::ISAExtension;
+
+        DecodedViewData() = default;
+
+        DecodedViewData(const OpcodeInfo & opinfo, const AnnotationType* anno,
+                        const uint64_t gen) :
+            icode(opinfo.getOpcode()),
+            uid(opinfo.getInstructionUniqueID()),
+            sources(opinfo.getSourceRegs().to_ullong()),
+            dests(opinfo.getDestRegs().to_ullong()),
+            int_sources(opinfo.getIntSourceRegs().to_ullong()),
+            int_dests(opinfo.getIntDestRegs().to_ullong()),
+            float_sources(opinfo.getFloatSourceRegs().to_ullong()),
+            float_dests(opinfo.getFloatDestRegs().to_ullong()),
+            vector_sources(opinfo.getVectorSourceRegs().to_ullong()),
+            vector_dests(opinfo.getVectorDestRegs().to_ullong()),
+            immediate(opinfo.getImmediate()),
+            signed_offset(opinfo.getSignedOffset()),
+            inst_types(opinfo.getInstType()),
+            ext_inst_types(opinfo.getExtractedInstTypes()),
+            isa(opinfo.getISA()),
+            immediate_type(opinfo.getImmediateType()),
+            data_size(opinfo.getDataSize()),
+            has_immediate(opinfo.hasImmediate()),
+            is_hint(opinfo.isHint()),
+            sources_list(opinfo.getSourceOpInfoList()),
+            dests_list(opinfo.getDestOpInfoList()),
+            annotation(anno),
+            generation(gen)
+        {
+        }
+
+        Opcode icode = 0;
+        InstructionUniqueID uid = INVALID_UID;
+        uint64_t sources = 0;
+        uint64_t dests = 0;
+        uint64_t int_sources = 0;
+        uint64_t int_dests = 0;
+        uint64_t float_sources = 0;
+        uint64_t float_dests = 0;
+        uint64_t vector_sources = 0;
+        uint64_t vector_dests = 0;
+        uint64_t immediate = 0;
+        int64_t signed_offset = 0;
+        std::underlying_type_t<InstructionTypes> inst_types = 0;
+        uint64_t ext_inst_types = 0;
+        std::underlying_type_t<ISAExtension> isa = 0;
+        ImmediateType immediate_type = ImmediateType::NONE;
+        uint32_t data_size = 0;
+        bool has_immediate = false;
+        bool is_hint = false;
+        OperandInfo::ElementList sources_list;
+        OperandInfo::ElementList dests_list;
+        const AnnotationType* annotation = nullptr;
+        uint64_t generation = 0; // 0: the line holds no decode
+    };
+
+    /**
+     * \brief Non-owning, trivially copyable decode result (see DTable::getDecodedView)
+     *
+     * A handle (pointer and generation) to the DecodedViewData in one line of the decoder's view
+     * cache: getting a view allocates nothing, touches no reference counts, and copies two words.
+     * The view reports itself stale (isValid()) once its line is reused for another opcode, or
+     * dropped by flushCaches() or invalidate(); debug builds assert on use of a stale view.
+     */
+    template <typename AnnotationType> class DecodedView
+    {
+      public:
+        using DataType = DecodedViewData<AnnotationType>;
+        using ExtractedInstTypes = DecodedInstructionInfo::ExtractedInstTypes;
+        using InstructionTypes = InstMetaData::InstructionTypes;
+        using ISAExtension = InstMetaData::ISAExtension;
+
+        DecodedView(const DataType* data, const uint64_t generation) :
+            data_ptr_(data),
+            generation_(generation)
+        {
+        }
+
+        Opcode getOpcode() const { return data_().icode; }
+
+        InstructionUniqueID getInstructionUniqueID() const { return data_().uid; }
+
+        uint64_t getSourceRegs() const { return data_().sources; }
+
+        uint64_t getDestRegs() const { return data_().dests; }
+
+        uint64_t getIntSourceRegs() const { return data_().int_sources; }
+
+        uint64_t getIntDestRegs() const { return data_().int_dests; }
+
+        uint64_t getFloatSourceRegs() const { return data_().float_sources; }
+
+        uint64_t getFloatDestRegs() const { return data_().float_dests; }
+
+        uint64_t getVectorSourceRegs() const { return data_().vector_sources; }
+
+        uint64_t getVectorDestRegs() const { return data_().vector_dests; }
+
+        bool hasImmediate() const { return data_().has_immediate; }
+
+        ImmediateType getImmediateType() const { return data_().immediate_type; }
+
+        uint64_t getImmediate() const { return data_().immediate; }
+
+        int64_t getSignedOffset() const { return data_().signed_offset; }
+
+        bool isHint() const { return data_().is_hint; }
+
+        uint32_t getDataSize() const { return data_().data_size; }
+
+        std::underlying_type_t<InstructionTypes> getInstType() const
+        {
+            return data_().inst_types;
+        }
+
+        bool isInstType(InstructionTypes itype) const
+        {
+            const auto bits = static_cast<std::underlying_type_t<InstructionTypes>>(itype);
+            return (data_().inst_types & bits) == bits;
+        }
+
+        bool isExtractedInstType(ExtractedInstTypes itype) const
+        {
+            const auto bits = static_cast<std::underlying_type_t<ExtractedInstTypes>>(itype);
+            return (data_().ext_inst_types & bits) == bits;
+        }
+
+        std::underlying_type_t<ISAExtension> getISA() const { return data_().isa; }
+
+        uint32_t numSourceOperands() const
+        {
+            return static_cast<uint32_t>(data_().sources_list.size());
+        }
+
+        uint32_t numDestOperands() const
+        {
+            return static_cast<uint32_t>(data_().dests_list.size());
+        }
+
+        const OperandInfo::Element & getSourceOperand(uint32_t i) const
+        {
+            assert(i < data_().sources_list.size());
+            return data_().sources_list[i];
+        }
+
+        const OperandInfo::Element & getDestOperand(uint32_t i) const
+        {
+            assert(i < data_().dests_list.size());
+            return data_().dests_list[i];
+        }
+
+        const AnnotationType* getAnnotation() const { return data_().annotation; }
+
+        // False once the line of the view cache this view came from has been reused or dropped
+        bool isValid() const { return data_ptr_->generation == generation_; }
+
+      private:
+        const DataType & data_() const
+        {
+            assert(isValid() && "DecodedView used after its decode was evicted or flushed");
+            return *data_ptr_;
+        }
+
+        const DataType* data_ptr_;
+        uint64_t generation_;
+    };
+
+} // namespace mavis
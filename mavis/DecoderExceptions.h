@@ -777,4 +777,106 @@ namespace mavis
         }
     };
 
+    /**
+     * Exception thrown when a JSON fusion file will not open
+     */
+    class BadFusionFile : public BaseException
+    {
+      public:
+        explicit BadFusionFile(const std::string & fname) : BaseException()
+        {
+            std::stringstream ss;
+            ss << "Cannot open JSON fusion file '" << fname << "'";
+            why_ = ss.str();
+        }
+    };
+
+    /**
+     * Exception thrown when a fusion rule is malformed
+     */
+    class BadFusionRule : public BaseException
+    {
+      public:
+        BadFusionRule(const std::string & rule_name, const std::string & reason) : BaseException()
+        {
+            std::stringstream ss;
+            ss << "Fusion rule '" << rule_name << "': " << reason;
+            why_ = ss.str();
+        }
+    };
+
+    /**
+     * Exception thrown when a JSON crack file will not open
+     */
+    class BadCrackFile : public BaseException
+    {
+      public:
+        explicit BadCrackFile(const std::string & fname) : BaseException()
+        {
+            std::stringstream ss;
+            ss << "Cannot open JSON crack file '" << fname << "'";
+            why_ = ss.str();
+        }
+    };
+
+    /**
+     * Exception thrown when a micro-op cracking rule is malformed
+     */
+    class BadCrackRule : public BaseException
+    {
+      public:
+        BadCrackRule(const std::string & mnemonic, const std::string & reason) : BaseException()
+        {
+            std::stringstream ss;
+            ss << "Crack rule for '" << mnemonic << "': " << reason;
+            why_ = ss.str();
+        }
+    };
+
+    /**
+     * Exception thrown when a warm decode cache file cannot be read or written, or is malformed
+     */
+    class BadWarmCacheFile : public BaseException
+    {
+      public:
+        BadWarmCacheFile(const std::string & fname, const std::string & reason) : BaseException()
+        {
+            std::stringstream ss;
+            ss << "Warm cache file '" << fname << "': " << reason;
+            why_ = ss.str();
+        }
+    };
+
+    /**
+     * Exception thrown when a warm decode cache file was saved from a different decode table
+     */
+    class StaleWarmCacheFile : public BaseException
+    {
+      public:
+        StaleWarmCacheFile(const std::string & fname, const uint64_t fingerprint,
+                           const uint64_t expected) :
+            BaseException()
+        {
+            std::stringstream ss;
+            ss << "Warm cache file '" << fname << "' is stale: fingerprint 0x" << std::hex
+               << fingerprint << ", expected 0x" << expected
+               << " (was it saved from a context with the same ISA files and tag filters?)";
+            why_ = ss.str();
+        }
+    };
+
+    /**
+     * Exception thrown when an ELF file cannot be loaded (see mavis/ELFText.hpp)
+     */
+    class BadELFFile : public BaseException
+    {
+      public:
+        explicit BadELFFile(const std::string & fname) : BaseException()
+        {
+            std::stringstream ss;
+            ss << "Cannot load ELF file '" << fname << "'";
+            why_ = ss.str();
+        }
+    };
+
 } // namespace mavis
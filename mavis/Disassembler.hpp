@@ -21,6 +21,12 @@ public:
     {
         return extractor->dasmString(mnemonic, icode, meta);
     }
+
+    void toBuffer(DasmWriter &os, const std::string &mnemonic, Opcode icode,
+                  const InstMetaData::PtrType& meta, const ExtractorIF::PtrType& extractor) const override
+    {
+        extractor->dasmTo(os, mnemonic, icode, meta);
+    }
 };
 
 } // namespace mavis
\ No newline at end of file
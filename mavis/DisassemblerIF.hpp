@@ -22,6 +22,15 @@ public:
     virtual std::string toString(const std::string &mnemonic, Opcode icode,
                                  const InstMetaData::PtrType& meta,
                                  const ExtractorIF::PtrType& extractor) const = 0;
+
+    // Non-allocating version of toString(). Disassemblers that don't implement it fall back to
+    // toString()
+    virtual void toBuffer(DasmWriter &os, const std::string &mnemonic, Opcode icode,
+                          const InstMetaData::PtrType& meta,
+                          const ExtractorIF::PtrType& extractor) const
+    {
+        os << toString(mnemonic, icode, meta, extractor);
+    }
 };
 
 } // namespace mavis
@@ -3,6 +3,8 @@
 #include "DecoderTypes.h"
 #include "DecoderExceptions.h"
 #include <map>
+#include <stdexcept>
+#include <string_view>
 
 namespace mavis {
 
@@ -57,7 +59,7 @@ public:
     };
 
 private:
-    typedef std::map<const std::string, T>      MapType;
+    typedef std::map<std::string, T, std::less<>> MapType;
     struct Wrapper {
         T                                       obj;
         typename MapType::const_iterator        m_iter;         // For debugging and sanity checks
@@ -81,7 +83,7 @@ public:
         return vect_.size();
     }
 
-    bool contains(const std::string& key) const
+    bool contains(const std::string_view key) const
     {
         return (map_.find(key) != map_.end());
     }
@@ -91,9 +93,13 @@ public:
         return ((key < vect_.size()) && vect_[key].valid);
     }
 
-    const T& lookup(const std::string& key) const
+    const T& lookup(const std::string_view key) const
     {
-        return map_.at(key);
+        const auto iter = map_.find(key);
+        if (iter == map_.end()) {
+            throw std::out_of_range(std::string(key));
+        }
+        return iter->second;
     }
 
     const T& lookup(uint32_t key) const
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "elfio/elfio.hpp"
+#include "DecoderExceptions.h"
+#include "TextScanner.hpp"
+
+namespace mavis
+{
+
+    /**
+     * \brief Code and data of an executable section, from its mapping symbols: $d starts data
+     * and $x (or $x.<any>, $x<ISA>) starts code. A section with no mapping symbols is all code
+     */
+    class SectionMap
+    {
+      public:
+        /**
+         * \brief Whether name is a mapping symbol ($d, $d.<any>, $x, $x.<any> or $x<ISA>), and
+         * if so, whether it starts data
+         */
+        static bool isMappingSymbol(const std::string & name, bool & data)
+        {
+            if ((name.size() < 2) || (name[0] != '$'))
+            {
+                return false;
+            }
+            data = (name[1] == 'd') && ((name.size() == 2) || (name[2] == '.'));
+            return data || (name[1] == 'x');
+        }
+
+        void add(const uint64_t addr, const bool data) { starts_[addr] = data; }
+
+        bool isData(const uint64_t addr) const
+        {
+            auto iter = starts_.upper_bound(addr);
+            return (iter != starts_.begin()) && (--iter)->second;
+        }
+
+        // Address at which the code or data containing addr ends (~0 for the last)
+        uint64_t getEnd(const uint64_t addr) const
+        {
+            const auto iter = starts_.upper_bound(addr);
+            return (iter == starts_.end()) ? ~uint64_t(0) : iter->first;
+        }
+
+      private:
+        std::map<uint64_t, bool> starts_; // Start address -> is data
+    };
+
+    /**
+     * \brief Calls func(section, name, value) for each named function or untyped symbol (such
+     * as a label or a mapping symbol) defined in an executable section
+     */
+    template <typename FuncType>
+    void forEachTextSymbol(const ELFIO::elfio & reader, FuncType && func)
+    {
+        for (ELFIO::Elf_Half i = 0; i < reader.sections.size(); ++i)
+        {
+            const ELFIO::section* sec = reader.sections[i];
+            if (sec->get_type() != ELFIO::SHT_SYMTAB)
+            {
+                continue;
+            }
+
+            const ELFIO::const_symbol_section_accessor accessor(reader, sec);
+            for (ELFIO::Elf_Xword s = 0; s < accessor.get_symbols_num(); ++s)
+            {
+                std::string name;
+                ELFIO::Elf64_Addr value = 0;
+                ELFIO::Elf_Xword size = 0;
+                unsigned char bind = 0;
+                unsigned char type = 0;
+                ELFIO::Elf_Half section_index = 0;
+                unsigned char other = 0;
+                accessor.get_symbol(s, name, value, size, bind, type, section_index, other);
+                if (name.empty() || (section_index == ELFIO::SHN_UNDEF)
+                    || (section_index >= reader.sections.size())
+                    || ((reader.sections[section_index]->get_flags() & ELFIO::SHF_EXECINSTR) == 0)
+                    || ((type != ELFIO::STT_FUNC) && (type != ELFIO::STT_NOTYPE)))
+                {
+                    continue;
+                }
+                func(static_cast<const ELFIO::section*>(reader.sections[section_index]), name,
+                     static_cast<uint64_t>(value));
+            }
+        }
+    }
+
+    /**
+     * \brief The code of the executable sections of an ELF file, as text regions for
+     * Mavis::prewarm()
+     *
+     * Data in an executable section (from a $d mapping symbol to the next $x) is left out, so a
+     * section can give several regions. Needs the ELFIO submodule (like RISCVExtensionManager),
+     * so it is not included by Mavis.h. The regions point into this object, which must outlive
+     * their use.
+     */
+    class ELFText
+    {
+      public:
+        // An executable section, and its code regions (regions [first_region, end_region) of
+        // getRegions())
+        struct Section
+        {
+            const ELFIO::section* section;
+            SectionMap map;
+            size_t first_region;
+            size_t end_region;
+        };
+
+        explicit ELFText(const std::string & path)
+        {
+            if (!reader_.load(path))
+            {
+                throw BadELFFile(path);
+            }
+
+            std::map<const ELFIO::section*, SectionMap> maps;
+            forEachTextSymbol(reader_,
+                              [&maps](const ELFIO::section* sec, const std::string & name,
+                                      const uint64_t value)
+                              {
+                                  bool data = false;
+                                  if (SectionMap::isMappingSymbol(name, data))
+                                  {
+                                      maps[sec].add(value, data);
+                                  }
+                              });
+
+            for (ELFIO::Elf_Half i = 0; i < reader_.sections.size(); ++i)
+            {
+                const ELFIO::section* sec = reader_.sections[i];
+                if ((sec->get_type() != ELFIO::SHT_PROGBITS)
+                    || ((sec->get_flags() & ELFIO::SHF_EXECINSTR) == 0) || (sec->get_size() == 0))
+                {
+                    continue;
+                }
+
+                Section section{sec, std::move(maps[sec]), regions_.size(), 0};
+                const auto* data = reinterpret_cast<const uint8_t*>(sec->get_data());
+                const uint64_t base = sec->get_address();
+                const uint64_t size = sec->get_size();
+                for (uint64_t off = 0; off < size;)
+                {
+                    const uint64_t end = std::min(section.map.getEnd(base + off) - base, size);
+                    if (!section.map.isData(base + off))
+                    {
+                        regions_.push_back({data + off, end - off, base + off});
+                    }
+                    off = end;
+                }
+                section.end_region = regions_.size();
+                sections_.push_back(std::move(section));
+            }
+        }
+
+        ELFText(const ELFText &) = delete;
+
+        const std::vector<TextRegion> & getRegions() const { return regions_; }
+
+        const std::vector<Section> & getSections() const { return sections_; }
+
+        const ELFIO::elfio & getReader() const { return reader_; }
+
+      private:
+        ELFIO::elfio reader_;
+        std::vector<Section> sections_;
+        std::vector<TextRegion> regions_;
+    };
+
+    /**
+     * \brief Prewarm the current context of mavis from the code of the ELF file at path (see
+     * Mavis::prewarm)
+     */
+    template <typename MavisType, typename... ArgTypes>
+    PrewarmStats prewarmFromELF(MavisType & mavis, const std::string & path,
+                                const PrewarmOptions & options, ArgTypes &&... args)
+    {
+        const ELFText text(path);
+        return mavis.prewarm(text.getRegions(), options, std::forward<ArgTypes>(args)...);
+    }
+
+} // namespace mavis
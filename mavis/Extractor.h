@@ -4,8 +4,12 @@
 #include "OperandInfo.hpp"
 #include "DecoderConsts.h"
 #include "Swizzler.hpp"
+#include "DasmWriter.h"
 #include <map>
 #include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <vector>
 
 namespace mavis
 {
@@ -20,7 +24,7 @@ namespace mavis
         using OpcodeFieldValueType = OperandInfo::OpcodeFieldValueType;
 
         typedef std::shared_ptr<ExtractorIF> PtrType;
-        typedef std::vector<OpcodeFieldValueType> RegListType;
+        typedef InlineVector<OpcodeFieldValueType, OperandInfo::MAX_OPERANDS> RegListType;
         typedef std::vector<uint32_t> ValueListType;
 
         // TODO: Maybe make SpecialField into its own class (for string name <--> enum conversions)
@@ -137,6 +141,19 @@ namespace mavis
             return dasmString(mnemonic, icode);
         }
 
+        // Non-allocating versions of dasmString(), writing to a caller-provided buffer. Extractors
+        // that don't implement them fall back to dasmString()
+        virtual void dasmTo(DasmWriter & os, const std::string & mnemonic, Opcode icode) const
+        {
+            os << dasmString(mnemonic, icode);
+        }
+
+        virtual void dasmTo(DasmWriter & os, const std::string & mnemonic, Opcode icode,
+                            const InstMetaData::PtrType & meta) const
+        {
+            os << dasmString(mnemonic, icode, meta);
+        }
+
         virtual void dasmAnnotate(const std::string & txt) = 0;
         virtual const std::string & getDasmAnnotation() const = 0;
 
@@ -248,6 +265,28 @@ namespace mavis
 
         ImmediateType getImmediateType() const override { return FormType::immediate_type; }
 
+        // Forms implement disassembly with dasmTo() only; the std::string versions render it
+        std::string dasmString(const std::string & mnemonic, const Opcode icode) const override
+        {
+            return dasmToString([&](DasmWriter & os) { dasmTo(os, mnemonic, icode); });
+        }
+
+        std::string dasmString(const std::string & mnemonic, const Opcode icode,
+                               const InstMetaData::PtrType & meta) const override
+        {
+            return dasmToString([&](DasmWriter & os) { dasmTo(os, mnemonic, icode, meta); });
+        }
+
+        void dasmTo(DasmWriter & os, const std::string & mnemonic,
+                    const Opcode icode) const override = 0;
+
+        // Forms without operand type information in their disassembly use the version above
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const Opcode icode,
+                    const InstMetaData::PtrType &) const override
+        {
+            dasmTo(os, mnemonic, icode);
+        }
+
         // TODO: If we need annotations for disassembly for normal extractors, we
         // can add it here. See the implementation in ExtractorDirectInfoBase as a
         // reference
@@ -423,29 +462,24 @@ namespace mavis
             return static_cast<int64_t>(uval) << sign_shift >> sign_shift;
         }
 
-        static inline std::string dasmFormatReg_(const InstMetaData::PtrType & meta,
-                                                 InstMetaData::OperandFieldID mid, uint32_t regnum)
+        static inline DasmReg dasmFormatReg_(const InstMetaData::PtrType & meta,
+                                             InstMetaData::OperandFieldID mid, uint32_t regnum)
         {
-            std::stringstream ss;
             switch (meta->getOperandType(mid))
             {
                 case InstMetaData::OperandTypes::WORD:
                 case InstMetaData::OperandTypes::LONG:
-                    ss << "x" << std::dec << regnum;
-                    break;
+                    return {'x', regnum};
                 case InstMetaData::OperandTypes::SINGLE:
                 case InstMetaData::OperandTypes::DOUBLE:
                 case InstMetaData::OperandTypes::QUAD:
-                    ss << "f" << std::dec << regnum;
-                    break;
+                    return {'f', regnum};
                 case InstMetaData::OperandTypes::VECTOR:
-                    ss << "v" << std::dec << regnum;
-                    break;
+                    return {'v', regnum};
                 case InstMetaData::OperandTypes::NONE:
-                    ss << std::dec << regnum;
                     break;
             }
-            return ss.str();
+            return {'\0', regnum};
         }
 
         struct RegType_
@@ -454,55 +488,76 @@ namespace mavis
             InstMetaData::OperandFieldID mid;
         };
 
-        typedef std::vector<RegType_> RegTypeList_;
-
-        static inline std::string dasmFormatRegList_(const InstMetaData::PtrType & meta,
-                                                     const Opcode icode, uint64_t fixed_field_mask,
-                                                     const RegTypeList_ & rtlist)
+        // Fixed capacity (no allocation): forms have at most 4 register operands
+        class RegTypeList_
         {
-            bool first = true;
-            std::stringstream ss;
-            for (const auto & r : rtlist)
+          public:
+            RegTypeList_(std::initializer_list<RegType_> rtlist) : size_(rtlist.size())
             {
-                if (!isMaskedField_(r.fid, fixed_field_mask))
-                {
-                    if (!first)
-                    {
-                        ss << ",";
-                    }
-                    else
-                    {
-                        first = false;
-                    }
-                    ss << dasmFormatReg_(meta, r.mid, extract_(r.fid, icode));
-                }
+                assert(rtlist.size() <= regs_.size());
+                std::copy(rtlist.begin(), rtlist.end(), regs_.begin());
             }
-            return ss.str();
-        }
 
-        static inline std::string dasmFormatCompressedRegList_(const InstMetaData::PtrType & meta,
-                                                               const Opcode icode,
-                                                               uint64_t fixed_field_mask,
-                                                               const RegTypeList_ & rtlist)
+            const RegType_* begin() const { return regs_.data(); }
+
+            const RegType_* end() const { return regs_.data() + size_; }
+
+          private:
+            std::array<RegType_, 4> regs_;
+            size_t size_;
+        };
+
+        // Comma separated list of the unmasked registers in a RegTypeList_, for DasmWriter
+        struct DasmRegList_
         {
-            bool first = true;
-            std::stringstream ss;
-            for (const auto & r : rtlist)
+            const InstMetaData::PtrType & meta;
+            const Opcode icode;
+            const uint64_t fixed_field_mask;
+            const RegTypeList_ rtlist;
+            const bool compressed;
+
+            void write(DasmWriter & os) const
             {
-                if (!isMaskedField_(r.fid, fixed_field_mask))
+                bool first = true;
+                for (const auto & r : rtlist)
                 {
-                    if (!first)
+                    if (!isMaskedField_(r.fid, fixed_field_mask))
                     {
-                        ss << ",";
+                        if (!first)
+                        {
+                            os << ",";
+                        }
+                        else
+                        {
+                            first = false;
+                        }
+                        const uint32_t regnum = compressed ? extractCompressedRegister_(r.fid, icode)
+                                                           : extract_(r.fid, icode);
+                        os << dasmFormatReg_(meta, r.mid, regnum);
                     }
-                    else
-                    {
-                        first = false;
-                    }
-                    ss << dasmFormatReg_(meta, r.mid, extractCompressedRegister_(r.fid, icode));
                 }
             }
-            return ss.str();
+
+            friend DasmWriter & operator<<(DasmWriter & os, const DasmRegList_ & list)
+            {
+                list.write(os);
+                return os;
+            }
+        };
+
+        static inline DasmRegList_ dasmFormatRegList_(const InstMetaData::PtrType & meta,
+                                                      const Opcode icode, uint64_t fixed_field_mask,
+                                                      const RegTypeList_ & rtlist)
+        {
+            return {meta, icode, fixed_field_mask, rtlist, false};
+        }
+
+        static inline DasmRegList_ dasmFormatCompressedRegList_(const InstMetaData::PtrType & meta,
+                                                                const Opcode icode,
+                                                                uint64_t fixed_field_mask,
+                                                                const RegTypeList_ & rtlist)
+        {
+            return {meta, icode, fixed_field_mask, rtlist, true};
         }
     };
 
@@ -40,7 +40,7 @@ public:
 
     ExtractorIF::PtrType clone() const override
     {
-        return std::make_shared<ExtractorPseudoInfo>(*this);
+        return makeRecycled<ExtractorPseudoInfo>(*this);
     }
 
     std::string getName() const override
@@ -116,20 +116,24 @@ public:
         return dests_;
     }
 
+    using ExtractorIF::dasmTo;
     using ExtractorIF::dasmString; // tell the compiler all dasmString
                                    // overloads are considered
-    std::string dasmString(const std::string &mnemonic, const uint64_t) const override
+    std::string dasmString(const std::string &mnemonic, const uint64_t icode) const override
     {
-        std::stringstream ss;
-        ss << mnemonic << "\t";
+        return dasmToString([&](DasmWriter &os) { dasmTo(os, mnemonic, icode); });
+    }
+
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const uint64_t) const override
+    {
+        os << mnemonic << "\t";
         for (const auto reg : dests_.getElements()) {
-            ss << static_cast<uint32_t>(reg.field_value) << ",";
+            os << static_cast<uint32_t>(reg.field_value) << ",";
         }
         for (const auto reg : sources_.getElements()) {
-            ss << static_cast<uint32_t>(reg.field_value) << ",";
+            os << static_cast<uint32_t>(reg.field_value) << ",";
         }
-        ss << " 0x" << std::hex << immediate_;
-        return ss.str();
+        os << " 0x" << std::hex << immediate_;
     }
 
 private:
@@ -160,7 +164,7 @@ public:
 
     ExtractorIF::PtrType clone() const override
     {
-        return std::make_shared<ExtractorDirectInfoBitMask>(*this);
+        return makeRecycled<ExtractorDirectInfoBitMask>(*this);
     }
 
     std::string getName() const override
@@ -214,16 +218,20 @@ public:
         return olist;
     }
 
+    using ExtractorIF::dasmTo;
     using ExtractorIF::dasmString; // tell the compiler all dasmString
                                    // overloads are considered
-    std::string dasmString(const std::string &mnemonic, const uint64_t) const override
+    std::string dasmString(const std::string &mnemonic, const uint64_t icode) const override
+    {
+        return dasmToString([&](DasmWriter &os) { dasmTo(os, mnemonic, icode); });
+    }
+
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const uint64_t) const override
     {
-        std::stringstream ss;
-        ss << mnemonic << "\t";
-        ss << bitmaskToStringVals_(dests_) << ",";
-        ss << bitmaskToStringVals_(sources_);
-        ss << " 0x" << std::hex << immediate_;
-        return ss.str();
+        os << mnemonic << "\t";
+        os << bitmaskToStringVals_(dests_) << ",";
+        os << bitmaskToStringVals_(sources_);
+        os << " 0x" << std::hex << immediate_;
     }
 
 private:
@@ -264,7 +272,7 @@ public:
 
     ExtractorIF::PtrType clone() const override
     {
-        return std::make_shared<ExtractorDirectInfo_Stores>(*this);
+        return makeRecycled<ExtractorDirectInfo_Stores>(*this);
     }
 
     std::string getName() const override
@@ -320,20 +328,24 @@ public:
         return olist;
     }
 
+    using ExtractorIF::dasmTo;
     using ExtractorIF::dasmString; // tell the compiler all dasmString
                                    // overloads are considered
-    std::string dasmString(const std::string &mnemonic, const uint64_t) const override
+    std::string dasmString(const std::string &mnemonic, const uint64_t icode) const override
     {
-        std::stringstream ss;
-        ss << mnemonic << "\t";
+        return dasmToString([&](DasmWriter &os) { dasmTo(os, mnemonic, icode); });
+    }
+
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const uint64_t) const override
+    {
+        os << mnemonic << "\t";
         for (const auto reg : data_sources_) {
-            ss << static_cast<uint32_t>(reg) << "(D),";
+            os << static_cast<uint32_t>(reg) << "(D),";
         }
         for (const auto reg : addr_sources_) {
-            ss << static_cast<uint32_t>(reg) << "(A),";
+            os << static_cast<uint32_t>(reg) << "(A),";
         }
-        ss << " 0x" << std::hex << immediate_;
-        return ss.str();
+        os << " 0x" << std::hex << immediate_;
     }
 
 private:
@@ -372,7 +384,7 @@ public:
 
     ExtractorIF::PtrType clone() const override
     {
-        return std::make_shared<ExtractorDirectInfoBitMask_Stores>(*this);
+        return makeRecycled<ExtractorDirectInfoBitMask_Stores>(*this);
     }
 
     std::string getName() const override
@@ -430,16 +442,20 @@ public:
         return olist;
     }
 
+    using ExtractorIF::dasmTo;
     using ExtractorIF::dasmString; // tell the compiler all dasmString
                                    // overloads are considered
-    std::string dasmString(const std::string &mnemonic, const uint64_t) const override
+    std::string dasmString(const std::string &mnemonic, const uint64_t icode) const override
+    {
+        return dasmToString([&](DasmWriter &os) { dasmTo(os, mnemonic, icode); });
+    }
+
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const uint64_t) const override
     {
-        std::stringstream ss;
-        ss << mnemonic << "\t D:";
-        ss << bitmaskToStringVals_(data_sources_) << ", A:";
-        ss << bitmaskToStringVals_(addr_sources_);
-        ss << " 0x" << std::hex << immediate_;
-        return ss.str();
+        os << mnemonic << "\t D:";
+        os << bitmaskToStringVals_(data_sources_) << ", A:";
+        os << bitmaskToStringVals_(addr_sources_);
+        os << " 0x" << std::hex << immediate_;
     }
 
 private:
@@ -472,7 +488,7 @@ public:
 
     ExtractorIF::PtrType clone() const override
     {
-        return std::make_shared<ExtractorDirectInfoBitMask_DestStores>(*this);
+        return makeRecycled<ExtractorDirectInfoBitMask_DestStores>(*this);
     }
 
     std::string getName() const override
@@ -529,16 +545,20 @@ public:
         return olist;
     }
 
+    using ExtractorIF::dasmTo;
     using ExtractorIF::dasmString; // tell the compiler all dasmString
     // overloads are considered
-    std::string dasmString(const std::string &mnemonic, const uint64_t) const override
+    std::string dasmString(const std::string &mnemonic, const uint64_t icode) const override
+    {
+        return dasmToString([&](DasmWriter &os) { dasmTo(os, mnemonic, icode); });
+    }
+
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const uint64_t) const override
     {
-        std::stringstream ss;
-        ss << mnemonic << "\t " << bitmaskToStringVals_(dests_)
+        os << mnemonic << "\t " << bitmaskToStringVals_(dests_)
            << ", D:" << bitmaskToStringVals_(data_sources_)
            << ", A:" << bitmaskToStringVals_(addr_sources_)
            << " 0x" << std::hex << immediate_;
-        return ss.str();
     }
 
 private:
@@ -3,6 +3,7 @@
 #include "DecoderConsts.h"
 #include "DecoderExceptions.h"
 #include "Extractor.h"
+#include "RecyclingAllocator.hpp"
 #include <string>
 
 namespace mavis
@@ -173,30 +174,31 @@ namespace mavis
             return x & 0x7Full;
         }
 
-        static inline std::string bitmaskToStringVals_(uint64_t bits)
+        // Comma separated positions of the 1-bits in a mask, for DasmWriter
+        struct DasmBitmaskVals_
         {
-            // Iterate through the combined mask, adding 1-bit positions to the
-            // returned vector
-            std::stringstream ss;
-            const uint32_t bitcnt = count1Bits_(bits);
-            if (bitcnt > 0)
+            uint64_t bits;
+
+            friend DasmWriter & operator<<(DasmWriter & os, const DasmBitmaskVals_ & vals)
             {
-                uint32_t found_bits = 0;
-                for (uint32_t i = 0; (found_bits != bitcnt); ++i)
+                bool first = true;
+                for (uint32_t i = 0; (i < 64) && ((vals.bits >> i) != 0); ++i)
                 {
-                    if (bits & (0x1ull << i))
+                    if (vals.bits & (0x1ull << i))
                     {
-                        if (found_bits != 0)
+                        if (!first)
                         {
-                            ss << ",";
+                            os << ",";
                         }
-                        ++found_bits;
-                        ss << i;
+                        first = false;
+                        os.dec(i);
                     }
                 }
+                return os;
             }
-            return ss.str();
-        }
+        };
+
+        static inline DasmBitmaskVals_ bitmaskToStringVals_(uint64_t bits) { return {bits}; }
 
         static inline RegListType bitmaskToRegList_(uint64_t bits)
         {
@@ -305,7 +307,7 @@ namespace mavis
 
         ExtractorIF::PtrType clone() const override
         {
-            return std::make_shared<ExtractorDirectInfo>(*this);
+            return makeRecycled<ExtractorDirectInfo>(*this);
         }
 
         std::string getName() const override { return name_; }
@@ -408,13 +410,18 @@ namespace mavis
             return olist;
         }
 
+        using ExtractorIF::dasmTo;
         using ExtractorIF::dasmString; // tell the compiler all dasmString
                                        // overloads are considered
 
-        std::string dasmString(const std::string & mnemonic, const uint64_t) const override
+        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        {
+            return dasmToString([&](DasmWriter & os) { dasmTo(os, mnemonic, icode); });
+        }
+
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const uint64_t) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t";
+            os << mnemonic << "\t";
             bool first = true;
             for (const auto reg : dests_)
             {
@@ -424,9 +431,9 @@ namespace mavis
                 }
                 else
                 {
-                    ss << ",";
+                    os << ",";
                 }
-                ss << static_cast<uint32_t>(reg);
+                os << static_cast<uint32_t>(reg);
             }
             for (const auto reg : sources_)
             {
@@ -436,15 +443,14 @@ namespace mavis
                 }
                 else
                 {
-                    ss << ",";
+                    os << ",";
                 }
-                ss << static_cast<uint32_t>(reg);
+                os << static_cast<uint32_t>(reg);
             }
             if (hasImmediate())
             {
-                ss << ", 0x" << std::hex << immediate_;
+                os << ", 0x" << std::hex << immediate_;
             }
-            return ss.str();
         }
 
       private:
@@ -540,7 +546,7 @@ namespace mavis
 
         ExtractorIF::PtrType clone() const override
         {
-            return std::make_shared<ExtractorDirectOpInfoList>(*this);
+            return makeRecycled<ExtractorDirectOpInfoList>(*this);
         }
 
         std::string getName() const override { return name_; }
@@ -591,13 +597,18 @@ namespace mavis
             return dests_;
         }
 
+        using ExtractorIF::dasmTo;
         using ExtractorIF::dasmString; // tell the compiler all dasmString
 
         // overloads are considered
-        std::string dasmString(const std::string & mnemonic, const uint64_t) const override
+        std::string dasmString(const std::string & mnemonic, const uint64_t icode) const override
+        {
+            return dasmToString([&](DasmWriter & os) { dasmTo(os, mnemonic, icode); });
+        }
+
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, const uint64_t) const override
         {
-            std::stringstream ss;
-            ss << mnemonic << "\t";
+            os << mnemonic << "\t";
             bool first = true;
             for (const auto & el : dests_.getElements())
             {
@@ -607,9 +618,9 @@ namespace mavis
                 }
                 else
                 {
-                    ss << ",";
+                    os << ",";
                 }
-                ss << static_cast<uint32_t>(el.field_value);
+                os << static_cast<uint32_t>(el.field_value);
             }
             for (const auto & el : sources_.getElements())
             {
@@ -619,15 +630,14 @@ namespace mavis
                 }
                 else
                 {
-                    ss << ",";
+                    os << ",";
                 }
-                ss << static_cast<uint32_t>(el.field_value);
+                os << static_cast<uint32_t>(el.field_value);
             }
             if (hasImmediate())
             {
-                ss << " 0x" << std::hex << immediate_;
+                os << " 0x" << std::hex << immediate_;
             }
-            return ss.str();
         }
 
       private:
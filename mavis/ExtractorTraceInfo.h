@@ -177,6 +177,7 @@ namespace mavis
             throw InvalidExtractorSpecialFieldID(tinfo_.getMnemonic());
         }
 
+        using ExtractorIF::dasmTo;
         using ExtractorIF::dasmString; // tell the compiler all dasmString
                                        // overloads are considered
 
@@ -185,6 +186,11 @@ namespace mavis
             return mnemonic + " (from " + getName() + ")";
         }
 
+        void dasmTo(DasmWriter & os, const std::string & mnemonic, Opcode) const override
+        {
+            os << mnemonic << " (from " << name_ << ")";
+        }
+
         // TODO: If we need annotations for disassembly for trace extractors, we
         // can add it here. See the implementation in ExtractorDirectInfoBase as a
         // reference
@@ -156,6 +156,16 @@ public:
         return obj_->dasmString(mnemonic, icode, meta);
     }
 
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const Opcode icode) const override
+    {
+        obj_->dasmTo(os, mnemonic, icode);
+    }
+
+    void dasmTo(DasmWriter &os, const std::string &mnemonic, const Opcode icode, const InstMetaData::PtrType& meta) const override
+    {
+        obj_->dasmTo(os, mnemonic, icode, meta);
+    }
+
     void dasmAnnotate(const std::string& txt) override
     {
         obj_->dasmAnnotate(txt);
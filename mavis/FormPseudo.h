@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include "Field.h"
 
 namespace mavis
 {
@@ -28,6 +30,42 @@ namespace mavis
         static inline const Field family_ = {"family", 0, 16};
 
       public:
+        // Instruction families distinguished by the root of the decode tree (see DTable)
+        static constexpr uint32_t NUM_FAMILIES = 6;
+
+        static inline bool isFamily(const uint32_t family, const uint32_t fval)
+        {
+            switch (family)
+            {
+                case 0: // 16-bit
+                    return (fval & 0x3ul) != 0x3ul;
+                case 1: // 32-bit
+                    return ((fval & 0x3ul) == 3ul) && ((fval & 0x1cul) != 0x1cul);
+                case 2: // 48-bit
+                    return (fval & 0x3ful) == 0x1ful;
+                case 3: // 64-bit
+                    return (fval & 0x7ful) == 0x3ful;
+                case 4: // 80..176-bit
+                    return ((fval & 0x7ful) == 0x7ful) && ((fval & 0x7000ul) != 0x7000ul);
+                case 5: // >= 192-bit
+                    return (fval & 0x707ful) == 0x707ful;
+                default:
+                    return false;
+            }
+        }
+
+        // First family matching the given opcode, or NUM_FAMILIES if none does
+        static inline uint32_t findFamily(const uint64_t icode)
+        {
+            const uint32_t fval = family_.extract(icode);
+            uint32_t family = 0;
+            while ((family < NUM_FAMILIES) && !isFamily(family, fval))
+            {
+                ++family;
+            }
+            return family;
+        }
+
         static inline std::string getName() { return "'*' PseudoForm"; }
 
         static inline const Field & getField(const idType fid)
@@ -0,0 +1,547 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DecoderExceptions.h"
+#include "DecoderTypes.h"
+#include "ExtractorDirectInfo.h"
+#include "InstMetaData.h"
+#include "JSONUtils.hpp"
+#include "JsonMacros.hpp"
+#include "OpcodeInfo.h"
+#include "OperandInfo.hpp"
+
+namespace mavis
+{
+
+    /**
+     * \brief Macro-op fusion: recognizes JSON-described instruction sequences in a window of
+     * decoded instructions, and makes the fused instruction for each with makeInstDirectly()
+     *
+     * The fusion file is an array of rules:
+     *
+     *   {
+     *     "fusion"   : "lui_addi",                   // Rule name
+     *     "sequence" : ["lui", ["addi", "addiw"]],   // Mnemonics (or alternatives) in order
+     *     "same"     : [["0.rd", "1.rs1"], ["0.rd", "1.rd"]],
+     *     "differ"   : [["0.rd", "x0"]],
+     *     "imm"      : ["0.imm", "1.imm"],           // Fused immediate (optional)
+     *     "fused"    : "fused.lui_addi"              // Instruction or pseudo instruction to make
+     *   }
+     *
+     * "same"/"differ" compare operands, written <index>.<field> (an operand field name such as
+     * rd, rs1, rs2, or "imm" for the signed immediate), x<n>, or an integer. A field may carry a
+     * signed offset, so ["1.imm", "0.imm+8"] requires the second immediate to be 8 past the first
+     * (e.g. adjacent doublewords of a load pair).
+     *
+     * The fused instruction's destinations are the distinct destinations of the sequence (RD,
+     * then FUSED_RD_0/1, last instruction first). Its sources are the sources not produced within
+     * the sequence (RS1..RS4, with store data in FUSED_SD_0/1). Its immediate is the sum of the
+     * signed immediates listed by "imm" (lui's is already shifted, so lui+addi is the full
+     * constant); without "imm", it is the first instruction's (e.g. the offset of a load pair).
+     *
+     * A matcher is bound to the context that is current when it is built: mnemonics are resolved
+     * to UIDs, and fused instructions are prepared, once. Rules naming instructions the context
+     * does not have are dropped. Matching first tests the UIDs of the first two instructions
+     * against a table of pairs that start a rule, so the cost per adjacent pair is O(1).
+     *
+     * \tparam MavisType Mavis facade; InstType must provide getOpInfo() (an OpcodeInfo::PtrType)
+     */
+    template <typename MavisType> class FusionMatcher
+    {
+      public:
+        using InstPtrType = typename MavisType::InstPtrType;
+        using PreparedInstType = typename MavisType::PreparedInstType;
+
+        struct Match
+        {
+            InstPtrType inst = nullptr;     // Fused instruction (null if nothing matched)
+            uint32_t length = 0;            // Number of instructions fused
+            const std::string* name = nullptr; // Rule that matched
+        };
+
+        FusionMatcher(MavisType & mavis, const std::string & fusion_file) : mavis_(mavis)
+        {
+            const json_value json = parseJSONWithException<BadFusionFile>(fusion_file);
+#ifdef USE_NLOHMANN_JSON
+            const auto & rules = json;
+#else
+            const auto & rules = json.as_array();
+#endif
+            for (const auto & rule_value : rules)
+            {
+#ifdef USE_NLOHMANN_JSON
+                const auto & rule = rule_value;
+#else
+                const auto & rule = rule_value.as_object();
+#endif
+                addRule_(rule);
+            }
+        }
+
+        /**
+         * \brief Match the longest rule at the head of [first, last)
+         * \param args Passed to the InstType constructor, as for Mavis::makeInstDirectly()
+         */
+        template <typename IterType, typename... ArgTypes>
+        Match match(IterType first, const IterType last, ArgTypes &&... args) const
+        {
+            Match result;
+            if ((first == last) || (std::next(first) == last))
+            {
+                return result;
+            }
+
+            const InstructionUniqueID uid0 = (*first)->getOpInfo()->getInstructionUniqueID();
+            if ((uid0 >= starts_.size()) || !starts_[uid0])
+            {
+                return result;
+            }
+            const InstructionUniqueID uid1 =
+                (*std::next(first))->getOpInfo()->getInstructionUniqueID();
+            const auto candidates = pairs_.find(pairKey_(uid0, uid1));
+            if (candidates == pairs_.end())
+            {
+                return result;
+            }
+
+            OpcodeInfo::PtrType window[MAX_SEQUENCE];
+            uint32_t window_len = 0;
+            for (auto iter = first; (iter != last) && (window_len < MAX_SEQUENCE); ++iter)
+            {
+                window[window_len++] = (*iter)->getOpInfo();
+            }
+
+            const Rule* best = nullptr;
+            for (const uint32_t idx : candidates->second)
+            {
+                const Rule & rule = rules_[idx];
+                if (((best == nullptr) || (rule.sequence.size() > best->sequence.size()))
+                    && matches_(rule, window, window_len))
+                {
+                    best = &rule;
+                }
+            }
+            if (best == nullptr)
+            {
+                return result;
+            }
+
+            OperandInfo sources;
+            OperandInfo dests;
+            const uint32_t length = static_cast<uint32_t>(best->sequence.size());
+            if (!fuseOperands_(window, length, sources, dests))
+            {
+                return result;
+            }
+            const ExtractorDirectOpInfoList ex_info(best->fused.uid, sources, dests,
+                                                    fuseImmediate_(*best, window));
+            result.inst = best->fused_is_pseudo
+                              ? mavis_.makePseudoInst(best->fused, ex_info,
+                                                      std::forward<ArgTypes>(args)...)
+                              : mavis_.makeInstDirectly(best->fused, ex_info,
+                                                        std::forward<ArgTypes>(args)...);
+            result.length = length;
+            result.name = &best->name;
+            return result;
+        }
+
+        /**
+         * \brief Fuse a stream of instructions: each match is replaced by its fused instruction
+         */
+        template <typename... ArgTypes>
+        std::vector<InstPtrType> fuse(const std::vector<InstPtrType> & insts,
+                                      ArgTypes &&... args) const
+        {
+            std::vector<InstPtrType> fused;
+            fused.reserve(insts.size());
+            for (auto iter = insts.begin(); iter != insts.end();)
+            {
+                const Match m = match(iter, insts.end(), args...);
+                if (m.inst != nullptr)
+                {
+                    fused.emplace_back(m.inst);
+                    iter += m.length;
+                }
+                else
+                {
+                    fused.emplace_back(*iter);
+                    ++iter;
+                }
+            }
+            return fused;
+        }
+
+        size_t numRules() const { return rules_.size(); }
+
+      private:
+        // Longest fusible sequence
+        constexpr static inline uint32_t MAX_SEQUENCE = 4;
+
+        // Operand reference in a "same"/"differ" constraint
+        struct Operand
+        {
+            enum class Kind
+            {
+                FIELD,
+                IMM,
+                CONSTANT
+            };
+
+            Kind kind = Kind::CONSTANT;
+            uint32_t index = 0;
+            InstMetaData::OperandFieldID fid = InstMetaData::OperandFieldID::NONE;
+            int64_t value = 0; // CONSTANT: the constant; FIELD/IMM: added offset
+        };
+
+        struct Constraint
+        {
+            Operand lhs;
+            Operand rhs;
+            bool same;
+        };
+
+        struct Rule
+        {
+            std::string name;
+            std::vector<std::vector<InstructionUniqueID>> sequence; // Alternatives per position
+            std::vector<Constraint> constraints;
+            std::vector<uint32_t> imm_operands; // Summed; empty: the first instruction's
+            PreparedInstType fused;
+            bool fused_is_pseudo = false;
+        };
+
+        MavisType & mavis_;
+        std::vector<Rule> rules_;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> pairs_; // (uid0, uid1) -> rules
+        std::vector<bool> starts_;                                 // UIDs that start a rule
+
+        static uint64_t pairKey_(const InstructionUniqueID uid0, const InstructionUniqueID uid1)
+        {
+            return (static_cast<uint64_t>(uid0) << 32) | uid1;
+        }
+
+#ifdef USE_NLOHMANN_JSON
+        using json_rule = json_value;
+#else
+        using json_rule = boost::json::object;
+#endif
+
+        static std::vector<std::string> getMnemonics_(const json_value & value)
+        {
+            if (value.is_string())
+            {
+                return {JSON_CAST(value, std::string)};
+            }
+            return JSON_CAST(value, std::vector<std::string>);
+        }
+
+        void addRule_(const json_rule & rule_json)
+        {
+            Rule rule;
+            rule.name = JSON_GET(rule_json, "fusion", std::string);
+
+#ifdef USE_NLOHMANN_JSON
+            const auto & sequence = rule_json.at("sequence");
+#else
+            const auto & sequence = rule_json.at("sequence").as_array();
+#endif
+            for (const auto & position : sequence)
+            {
+                std::vector<InstructionUniqueID> uids;
+                for (const auto & mnemonic : getMnemonics_(position))
+                {
+                    const InstructionUniqueID uid = mavis_.lookupInstructionUniqueID(mnemonic);
+                    if (uid != INVALID_UID)
+                    {
+                        uids.emplace_back(uid);
+                    }
+                }
+                if (uids.empty())
+                {
+                    // Not in this context
+                    return;
+                }
+                rule.sequence.emplace_back(std::move(uids));
+            }
+            if ((rule.sequence.size() < 2) || (rule.sequence.size() > MAX_SEQUENCE))
+            {
+                throw BadFusionRule(rule.name, "a sequence has 2 to "
+                                                   + std::to_string(MAX_SEQUENCE)
+                                                   + " instructions");
+            }
+
+            for (const char* key : {"same", "differ"})
+            {
+                if (!rule_json.contains(key))
+                {
+                    continue;
+                }
+                for (const auto & pair :
+                     JSON_CAST(rule_json.at(key), std::vector<std::vector<std::string>>))
+                {
+                    if (pair.size() != 2)
+                    {
+                        throw BadFusionRule(rule.name, std::string("\"") + key
+                                                           + "\" entries are pairs of operands");
+                    }
+                    rule.constraints.push_back({parseOperand_(rule, pair[0]),
+                                                parseOperand_(rule, pair[1]),
+                                                std::string(key) == "same"});
+                }
+            }
+
+            if (rule_json.contains("imm"))
+            {
+                for (const auto & term : JSON_CAST(rule_json.at("imm"), std::vector<std::string>))
+                {
+                    const Operand operand = parseOperand_(rule, term);
+                    if (operand.kind != Operand::Kind::IMM)
+                    {
+                        throw BadFusionRule(rule.name, "\"imm\" lists <index>.imm operands, not '"
+                                                           + term + "'");
+                    }
+                    rule.imm_operands.emplace_back(operand.index);
+                }
+            }
+
+            const std::string fused = JSON_GET(rule_json, "fused", std::string);
+            if (mavis_.lookupInstructionUniqueID(fused) != INVALID_UID)
+            {
+                rule.fused = mavis_.prepareInstDirectly(fused);
+            }
+            else if (mavis_.lookupPseudoInstUniqueID(fused) != INVALID_UID)
+            {
+                rule.fused = mavis_.preparePseudoInst(fused);
+                rule.fused_is_pseudo = true;
+            }
+            else
+            {
+                return;
+            }
+
+            const uint32_t idx = static_cast<uint32_t>(rules_.size());
+            for (const InstructionUniqueID uid0 : rule.sequence[0])
+            {
+                if (uid0 >= starts_.size())
+                {
+                    starts_.resize(uid0 + 1, false);
+                }
+                starts_[uid0] = true;
+                for (const InstructionUniqueID uid1 : rule.sequence[1])
+                {
+                    pairs_[pairKey_(uid0, uid1)].emplace_back(idx);
+                }
+            }
+            rules_.emplace_back(std::move(rule));
+        }
+
+        static Operand parseOperand_(const Rule & rule, const std::string & text)
+        {
+            Operand operand;
+            const size_t dot = text.find('.');
+            if (dot != std::string::npos)
+            {
+                operand.index = static_cast<uint32_t>(std::stoul(text.substr(0, dot)));
+                std::string field = text.substr(dot + 1);
+                const size_t sign = field.find_first_of("+-");
+                if (sign != std::string::npos)
+                {
+                    size_t end = 0;
+                    operand.value = std::stoll(field.substr(sign), &end, 0);
+                    if ((end + sign) != field.size())
+                    {
+                        throw BadFusionRule(rule.name, "bad offset in operand '" + text + "'");
+                    }
+                    field.resize(sign);
+                }
+                if (field == "imm")
+                {
+                    operand.kind = Operand::Kind::IMM;
+                }
+                else
+                {
+                    operand.kind = Operand::Kind::FIELD;
+                    operand.fid = InstMetaData::getFieldID(field);
+                    if (operand.fid == InstMetaData::OperandFieldID::NONE)
+                    {
+                        throw BadFusionRule(rule.name, "unknown operand field '" + field + "'");
+                    }
+                }
+                if (operand.index >= rule.sequence.size())
+                {
+                    throw BadFusionRule(rule.name, "operand '" + text + "' is past the sequence");
+                }
+            }
+            else if (!text.empty() && (text[0] == 'x'))
+            {
+                operand.value = std::stoll(text.substr(1));
+            }
+            else
+            {
+                operand.value = std::stoll(text, nullptr, 0);
+            }
+            return operand;
+        }
+
+        static uint64_t fuseImmediate_(const Rule & rule, const OpcodeInfo::PtrType* window)
+        {
+            if (rule.imm_operands.empty())
+            {
+                return window[0]->getImmediate();
+            }
+            int64_t imm = 0;
+            for (const uint32_t index : rule.imm_operands)
+            {
+                imm += window[index]->getSignedOffset();
+            }
+            return static_cast<uint64_t>(imm);
+        }
+
+        // Value of operand in window (false if the instruction has no such field)
+        static bool getValue_(const Operand & operand, const OpcodeInfo::PtrType* window,
+                              int64_t & value)
+        {
+            switch (operand.kind)
+            {
+                case Operand::Kind::CONSTANT:
+                    value = operand.value;
+                    return true;
+                case Operand::Kind::IMM:
+                    value = window[operand.index]->getSignedOffset() + operand.value;
+                    return true;
+                case Operand::Kind::FIELD:
+                    break;
+            }
+            const OpcodeInfo & opinfo = *window[operand.index];
+            for (const OperandInfo* oi : {&opinfo.getDestOpInfo(), &opinfo.getSourceOpInfo()})
+            {
+                if (oi->hasFieldID(operand.fid))
+                {
+                    value = static_cast<int64_t>(oi->getFieldValue(operand.fid)) + operand.value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        static bool matches_(const Rule & rule, const OpcodeInfo::PtrType* window,
+                             const uint32_t window_len)
+        {
+            if (rule.sequence.size() > window_len)
+            {
+                return false;
+            }
+            for (uint32_t i = 2; i < rule.sequence.size(); ++i)
+            {
+                const InstructionUniqueID uid = window[i]->getInstructionUniqueID();
+                const auto & alternatives = rule.sequence[i];
+                if (std::find(alternatives.begin(), alternatives.end(), uid) == alternatives.end())
+                {
+                    return false;
+                }
+            }
+            for (const Constraint & c : rule.constraints)
+            {
+                int64_t lhs = 0;
+                int64_t rhs = 0;
+                if (!getValue_(c.lhs, window, lhs) || !getValue_(c.rhs, window, rhs)
+                    || ((lhs == rhs) != c.same))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Operands of the fused instruction (false if they do not fit its operand fields)
+        static bool fuseOperands_(const OpcodeInfo::PtrType* window, const uint32_t length,
+                                  OperandInfo & sources, OperandInfo & dests)
+        {
+            using FieldID = InstMetaData::OperandFieldID;
+            constexpr FieldID dest_fids[] = {FieldID::RD, FieldID::FUSED_RD_0, FieldID::FUSED_RD_1};
+            constexpr FieldID source_fids[] = {FieldID::RS1, FieldID::RS2, FieldID::RS3,
+                                               FieldID::RS4};
+            constexpr FieldID store_data_fids[] = {FieldID::FUSED_SD_0, FieldID::FUSED_SD_1};
+
+            const auto same_reg = [](const OperandInfo::Element & a, const OperandInfo::Element & b)
+            { return (a.field_value == b.field_value) && (a.operand_type == b.operand_type); };
+            const auto contains = [&same_reg](const OperandInfo & oi,
+                                              const OperandInfo::Element & elem)
+            {
+                for (const auto & e : oi.getElements())
+                {
+                    if (same_reg(e, elem))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            uint32_t n_dests = 0;
+            for (uint32_t i = length; i-- > 0;)
+            {
+                for (const auto & elem : window[i]->getDestOpInfoList())
+                {
+                    if (contains(dests, elem))
+                    {
+                        continue;
+                    }
+                    if (n_dests == std::size(dest_fids))
+                    {
+                        return false;
+                    }
+                    dests.addElement(dest_fids[n_dests++], elem.operand_type, elem.field_value);
+                }
+            }
+
+            // Sources produced earlier in the sequence are internal
+            OperandInfo produced;
+            uint32_t n_sources = 0;
+            uint32_t n_store_data = 0;
+            for (uint32_t i = 0; i < length; ++i)
+            {
+                for (const auto & elem : window[i]->getSourceOpInfoList())
+                {
+                    if (contains(produced, elem) || contains(sources, elem))
+                    {
+                        continue;
+                    }
+                    if (elem.is_store_data)
+                    {
+                        if (n_store_data == std::size(store_data_fids))
+                        {
+                            return false;
+                        }
+                        sources.addElement(store_data_fids[n_store_data++], elem.operand_type,
+                                           elem.field_value, true);
+                    }
+                    else
+                    {
+                        if (n_sources == std::size(source_fids))
+                        {
+                            return false;
+                        }
+                        sources.addElement(source_fids[n_sources++], elem.operand_type,
+                                           elem.field_value);
+                    }
+                }
+                for (const auto & elem : window[i]->getDestOpInfoList())
+                {
+                    if (!contains(produced, elem))
+                    {
+                        produced.addElement(FieldID::NONE, elem.operand_type, elem.field_value);
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+} // namespace mavis
@@ -3,17 +3,21 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <typeinfo>
 #include <functional>
 #include <array>
 #include <map>
 #include <vector>
 #include <memory>
 #include "DecoderTypes.h"
+#include "CacheFilter.h"
 #include "OpcodeInfo.h"
 #include "Extractor.h"
 #include "InstructionRegistry.hpp"
 #include "Stash.hpp"
 #include "Overlay.hpp"
+#include "PreparedInst.h"
+#include "Symbol.hpp"
 
 namespace mavis
 {
@@ -26,6 +30,11 @@ namespace mavis
       public:
         typedef typename std::shared_ptr<IFactoryIF> PtrType;
 
+        // Finds the annotation registered for a name (see AnnotationRegistry), or returns nullptr.
+        // Leaves use it to look up their annotations on first use rather than at build
+        typedef std::function<typename AnnotationType::PtrType(const std::string &)>
+            AnnotationLookup;
+
         struct IFactoryInfo
         {
             typedef std::shared_ptr<IFactoryInfo> PtrType;
@@ -68,6 +77,9 @@ namespace mavis
 
         virtual void flushCaches() = 0;
 
+        // Drop the cached decodes selected by filter, keeping the rest
+        virtual void flushCachesIf(const CacheFilter & filter) = 0;
+
         virtual void
         addIFactory(const Opcode istencil,
                     const typename IFactoryIF<InstType, AnnotationType>::PtrType & node) = 0;
@@ -374,6 +386,20 @@ namespace mavis
             }
         }
 
+        void flushCachesIf(const CacheFilter & filter) override
+        {
+            for (auto & entry : table_)
+            {
+                assert(entry.factory != nullptr);
+                entry.factory->flushCachesIf(filter);
+            }
+
+            if (default_.factory != nullptr)
+            {
+                default_.factory->flushCachesIf(filter);
+            }
+        }
+
         void print(std::ostream & os, const uint32_t level = 0) const override
         {
             std::ios_base::fmtflags os_state(os.flags());
@@ -408,7 +434,6 @@ namespace mavis
             os.flags(os_state);
         }
 
-      private:
         struct SpecialCaseEntry
         {
             std::string mnemonic;
@@ -420,6 +445,25 @@ namespace mavis
             ExtractorIF::PtrType extractor = nullptr;
         };
 
+        // Special cases, in match (decreasing specificity) order
+        const std::vector<SpecialCaseEntry> & getSpecialCases() const { return table_; }
+
+        const SpecialCaseEntry & getDefaultCase() const { return default_; }
+
+        // Replace each child with replace(child) (see DecodeNodePool)
+        template <typename ReplaceFuncType> void replaceChildren(const ReplaceFuncType & replace)
+        {
+            for (auto & entry : table_)
+            {
+                entry.factory = replace(entry.factory);
+            }
+            if (default_.factory != nullptr)
+            {
+                default_.factory = replace(default_.factory);
+            }
+        }
+
+      private:
         std::vector<SpecialCaseEntry> table_;
         SpecialCaseEntry default_;
 
@@ -573,6 +617,22 @@ namespace mavis
             }
         }
 
+        void flushCachesIf(const CacheFilter & filter) override
+        {
+            for (const auto & [key, ifact] : hash_)
+            {
+                if (ifact != nullptr)
+                {
+                    ifact->flushCachesIf(filter);
+                }
+            }
+
+            if (default_ != nullptr)
+            {
+                default_->flushCachesIf(filter);
+            }
+        }
+
         void print(std::ostream & os, const uint32_t level = 0) const override
         {
             std::ios_base::fmtflags os_state(os.flags());
@@ -669,6 +729,29 @@ namespace mavis
             return itable_[index];
         }
 
+        const typename IFactoryIF<InstType, AnnotationType>::PtrType &
+        getChild(const uint32_t index) const
+        {
+            assert(index < field_->getSize());
+            return itable_[index];
+        }
+
+        // Replace each child with replace(child) (see DecodeNodePool)
+        template <typename ReplaceFuncType> void replaceChildren(const ReplaceFuncType & replace)
+        {
+            for (uint32_t i = 0; i < field_->getSize(); ++i)
+            {
+                if (itable_[i] != nullptr)
+                {
+                    itable_[i] = replace(itable_[i]);
+                }
+            }
+            if (default_ != nullptr)
+            {
+                default_ = replace(default_);
+            }
+        }
+
         void
         addIFactory(const Opcode istencil,
                     const typename IFactoryIF<InstType, AnnotationType>::PtrType & node) override
@@ -751,6 +834,22 @@ namespace mavis
             }
         }
 
+        void flushCachesIf(const CacheFilter & filter) override
+        {
+            for (uint32_t i = 0; i < field_->getSize(); ++i)
+            {
+                if (itable_[i] != nullptr)
+                {
+                    itable_[i]->flushCachesIf(filter);
+                }
+            }
+
+            if (default_ != nullptr)
+            {
+                default_->flushCachesIf(filter);
+            }
+        }
+
         void print(std::ostream & os, const uint32_t level = 0) const override
         {
             std::ios_base::fmtflags os_state(os.flags());
@@ -918,6 +1017,22 @@ namespace mavis
             }
         }
 
+        void flushCachesIf(const CacheFilter & filter) override
+        {
+            for (uint32_t i = 0; i < tsize_; ++i)
+            {
+                if (itable_[i] != nullptr)
+                {
+                    itable_[i]->flushCachesIf(filter);
+                }
+            }
+
+            if (default_ != nullptr)
+            {
+                default_->flushCachesIf(filter);
+            }
+        }
+
         void print(std::ostream & os, const uint32_t level = 0) const override
         {
             std::ios_base::fmtflags os_state(os.flags());
@@ -1024,6 +1139,30 @@ namespace mavis
             return nullptr;
         }
 
+        // Node selected by the index'th matcher (nullptr if none was added)
+        const typename IFactoryIF<InstType, AnnotationType>::PtrType &
+        getMatchNode(const uint32_t index) const
+        {
+            assert(index < TableSize);
+            return itable_[index].factory;
+        }
+
+        // Replace each child with replace(child) (see DecodeNodePool)
+        template <typename ReplaceFuncType> void replaceChildren(const ReplaceFuncType & replace)
+        {
+            for (auto & me : itable_)
+            {
+                if (me.factory != nullptr)
+                {
+                    me.factory = replace(me.factory);
+                }
+            }
+            if (default_ != nullptr)
+            {
+                default_ = replace(default_);
+            }
+        }
+
         void
         addIFactory(const Opcode istencil,
                     const typename IFactoryIF<InstType, AnnotationType>::PtrType & node) override
@@ -1104,6 +1243,22 @@ namespace mavis
             }
         }
 
+        void flushCachesIf(const CacheFilter & filter) override
+        {
+            for (const auto & me : itable_)
+            {
+                if (me.factory != nullptr)
+                {
+                    me.factory->flushCachesIf(filter);
+                }
+            }
+
+            if (default_ != nullptr)
+            {
+                default_->flushCachesIf(filter);
+            }
+        }
+
         void print(std::ostream & os, const uint32_t level = 0) const override
         {
             std::ios_base::fmtflags os_state(os.flags());
@@ -1300,13 +1455,13 @@ namespace mavis
             // Stash miss...
             if (entry == nullptr)
             {
-                std::string use_mnemonic = mnemonic;
+                const InstructionVariant & variant = getInstructionVariant_(mnemonic);
+                Symbol use_mnemonic = variant.mnemonic;
                 ExtractorIF::PtrType use_extractor = extractor;
                 InstMetaData::PtrType use_meta = getMeta_(mnemonic);
                 // TODO: Do we need to support instruction variants for disassembly?
                 DisassemblerIF::PtrType use_dasm = dasm_;
-                InstructionUniqueID use_uid =
-                    getInstructionUID_(mnemonic); // TODO: lookup work may be wasted
+                InstructionUniqueID use_uid = variant.uid; // TODO: lookup work may be wasted
                 // typename AnnotationType::PtrType use_anno = getAnnotation_(mnemonic);     //
                 // TODO: lookup work may be wasted
                 typename AnnotationType::PtrType use_anno =
@@ -1320,7 +1475,7 @@ namespace mavis
                 // base mnemonic
                 if ((olay != nullptr) && (olay->getBaseMnemonic() == mnemonic))
                 {
-                    use_mnemonic = olay->getMnemonic();
+                    use_mnemonic = Symbol(olay->getMnemonic());
                     if (olay->getExtractor() != nullptr)
                     {
                         use_extractor = olay->getExtractor();
@@ -1363,9 +1518,9 @@ namespace mavis
         getInfoBypassCache(const std::string & mnemonic, const ExtractorIF::PtrType & extractor)
         {
             // TODO: Overlays are not supported yet, since no opcode provided
-            const DecodedInstructionInfo::PtrType & new_dii =
-                std::make_shared<DecodedInstructionInfo>(mnemonic, getInstructionUID_(mnemonic),
-                                                         extractor, meta_, Opcode(0));
+            const InstructionVariant & variant = getInstructionVariant_(mnemonic);
+            const DecodedInstructionInfo::PtrType & new_dii = std::make_shared<DecodedInstructionInfo>(
+                variant.mnemonic, variant.uid, extractor, meta_, Opcode(0));
             OpcodeInfo::PtrType optr =
                 std::make_shared<OpcodeInfo>(Opcode(0), new_dii, extractor, meta_, dasm_);
 
@@ -1375,12 +1530,21 @@ namespace mavis
                 optr, findAnnotation_(mnemonic));
         }
 
+        /**
+         * \brief Resolve what getInfoBypassCache() looks up for mnemonic, once (see PreparedInst)
+         */
+        PreparedInst<AnnotationType> prepare(const std::string & mnemonic) const
+        {
+            const InstructionVariant & variant = getInstructionVariant_(mnemonic);
+            return {variant.mnemonic, variant.uid, meta_, dasm_, findAnnotation_(mnemonic), nullptr};
+        }
+
         void addInstructionVariantAnnotation(const std::string & mnemonic,
                                              const typename AnnotationType::PtrType & anno)
         {
             if (annotation_map_.find(mnemonic) == annotation_map_.end())
             {
-                annotation_map_[mnemonic] = anno;
+                annotation_map_[mnemonic] = AnnotationVariant{anno, nullptr, {}};
             }
             else
             {
@@ -1390,11 +1554,26 @@ namespace mavis
             }
         }
 
+        /**
+         * \brief Register the instruction's annotation without looking it up: the first
+         * getInfo()/prepare() of the instruction looks up lookup_name (the factory's name in the
+         * JSON), and failing that the mnemonic
+         */
+        void addInstructionVariantAnnotation(
+            const std::string & mnemonic, const std::string & lookup_name,
+            const typename IFactoryIF<InstType, AnnotationType>::AnnotationLookup & lookup)
+        {
+            if (annotation_map_.find(mnemonic) == annotation_map_.end())
+            {
+                annotation_map_[mnemonic] = AnnotationVariant{nullptr, lookup, lookup_name};
+            }
+        }
+
         void addInstructionVariantUID(const std::string & mnemonic, const InstructionUniqueID uid)
         {
             if (uid_map_.find(mnemonic) == uid_map_.end())
             {
-                uid_map_[mnemonic] = uid;
+                uid_map_.emplace(mnemonic, InstructionVariant{uid, Symbol(mnemonic)});
             }
 #if 0
         // TODO: Enable this code once we can assure uniqueness
@@ -1457,8 +1636,70 @@ namespace mavis
             }
         }
 
+        /**
+         * \brief Replace the factory's metadata (its variants' and overlays' too) with equal,
+         * shared objects: share(name, meta) returns the object to use (see DecodeNodePool)
+         */
+        template <typename ShareFuncType> void shareMetaData(const ShareFuncType & share)
+        {
+            meta_ = share(name_, meta_);
+            for (auto & [mnemonic, meta] : meta_map_)
+            {
+                meta = share(mnemonic, meta);
+            }
+            for (auto & olay : overlay_list_)
+            {
+                olay->shareMetaData(share);
+            }
+        }
+
+        /**
+         * \brief Everything that decides what the factory makes, but not its caches (see
+         * DecodeNodePool). Metadata is compared by identity, so it must have been shared first;
+         * deferred annotations are compared by the name they are looked up by, so factories are
+         * only comparable when their annotations come from the same registry
+         */
+        void appendSignature(std::string & sig) const
+        {
+            std::ostringstream ss;
+            ss << typeid(*this).name() << '\0' << name_ << '\0' << std::hex << stencil_ << '\0'
+               << meta_.get() << '\0' << typeid(*dasm_).name() << '\0';
+            for (const auto & [mnemonic, variant] : uid_map_)
+            {
+                ss << 'U' << mnemonic << '\0' << variant.uid << '\0';
+            }
+            for (const auto & [mnemonic, variant] : annotation_map_)
+            {
+                ss << 'A' << mnemonic << '\0';
+                if (variant.lookup_name.empty())
+                {
+                    ss << variant.anno.get() << '\0';
+                }
+                else
+                {
+                    ss << '=' << variant.lookup_name << '\0';
+                }
+            }
+            for (const auto & [mnemonic, meta] : meta_map_)
+            {
+                ss << 'M' << mnemonic << '\0' << meta.get() << '\0';
+            }
+            sig += ss.str();
+            for (const auto & olay : overlay_list_)
+            {
+                sig += 'O';
+                olay->appendSignature(sig);
+            }
+        }
+
         void flushCaches() override { stash_.reset(new ExtractionStashType("ExtractionStash")); }
 
+        void flushCachesIf(const CacheFilter & filter) override
+        {
+            stash_->eraseIf([&filter](const Opcode icode, const StashEntry & entry)
+                            { return filter.matches(icode, entry.dii->unique_id); });
+        }
+
         void print(std::ostream & os, const uint32_t) const override
         {
             std::ios_base::fmtflags os_state(os.flags());
@@ -1471,9 +1712,26 @@ namespace mavis
         const Opcode stencil_;   // For debugging
         InstMetaData::PtrType meta_;
         DisassemblerIF::PtrType dasm_;
-        std::map<const std::string, InstructionUniqueID> uid_map_;
-        std::map<const std::string, typename AnnotationType::PtrType> annotation_map_;
-        std::map<const std::string, typename InstMetaData::PtrType> meta_map_;
+        // UID and interned mnemonic of each instruction made by this factory
+        struct InstructionVariant
+        {
+            InstructionUniqueID uid;
+            Symbol mnemonic;
+        };
+
+        std::map<std::string, InstructionVariant, std::less<>> uid_map_;
+        // Annotation of each instruction made by this factory. Until the instruction is first
+        // decoded, lookup is set and anno is not. lookup_name is empty for annotations given
+        // at build
+        struct AnnotationVariant
+        {
+            typename AnnotationType::PtrType anno;
+            typename IFactoryIF<InstType, AnnotationType>::AnnotationLookup lookup;
+            std::string lookup_name;
+        };
+
+        mutable std::map<std::string, AnnotationVariant, std::less<>> annotation_map_;
+        std::map<std::string, typename InstMetaData::PtrType, std::less<>> meta_map_;
         std::unique_ptr<ExtractionStashType> stash_;
         std::vector<typename Overlay<InstType, AnnotationType>::PtrType> overlay_list_;
 
@@ -1481,7 +1739,8 @@ namespace mavis
         /**
          * @brief findAnnotation_: Lookup the annotation associated with the mnemonic.
          * Failing that, try lookup of the annotation by the factory name (e.g. for
-         * expanded/compressed instructions). Otherwise return NULL
+         * expanded/compressed instructions). Otherwise return NULL. Deferred annotations are
+         * looked up here the first time
          *
          * @param mnemonic
          * @return
@@ -1501,15 +1760,24 @@ namespace mavis
                 {
                     return nullptr; // Annotation not found for mnemonic or factory name
                 }
-                else
-                {
-                    return iter->second; // Annotation found for factory name
-                }
             }
-            else
+            return resolveAnnotation_(iter->first, iter->second);
+        }
+
+        // Look up a variant's annotation, once
+        static const typename AnnotationType::PtrType &
+        resolveAnnotation_(const std::string & mnemonic, AnnotationVariant & variant)
+        {
+            if (variant.lookup)
             {
-                return iter->second; // Annotation found for mnemonic
+                variant.anno = variant.lookup(variant.lookup_name);
+                if ((variant.anno == nullptr) && (variant.lookup_name != mnemonic))
+                {
+                    variant.anno = variant.lookup(mnemonic);
+                }
+                variant.lookup = nullptr;
             }
+            return variant.anno;
         }
 
 #if 0
@@ -1538,11 +1806,11 @@ namespace mavis
         }
 
       private:
-        InstructionUniqueID getInstructionUID_(const std::string & mnemonic) const
+        const InstructionVariant & getInstructionVariant_(const std::string & mnemonic) const
         {
-            InstructionUniqueID uid = uid_map_.at(mnemonic);
-            assert((uid != INVALID_UID) && "UID is invalid");
-            return uid;
+            const InstructionVariant & variant = uid_map_.at(mnemonic);
+            assert((variant.uid != INVALID_UID) && "UID is invalid");
+            return variant;
         }
 
         /**
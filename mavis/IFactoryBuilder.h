@@ -39,8 +39,24 @@ namespace mavis
                                  AnnotationTypeAllocator & annotation_allocator,
                                  const InstUIDList & uid_list = {},
                                  const AnnotationOverrides & anno_overrides = {}) :
+            IFactoryBuilder(
+                std::make_shared<typename IFactoryBuilder::AnnotationRegistryType>(
+                    anno_files, annotation_allocator, anno_overrides),
+                uid_list)
+        {
+        }
+
+        /**
+         * \brief Construct with an existing annotation registry (e.g. one shared with other
+         * builders by ContextRegistry)
+         */
+        explicit IFactoryBuilder(
+            const typename FactoryBuilderBase<FactoryType, InstType, AnnotationType,
+                                              AnnotationTypeAllocator>::AnnotationRegistryType::
+                PtrType & anno_registry,
+            const InstUIDList & uid_list = {}) :
             FactoryBuilderBase<FactoryType, InstType, AnnotationType, AnnotationTypeAllocator>(
-                anno_files, annotation_allocator, uid_list, anno_overrides)
+                anno_registry, uid_list)
         {
             // Pre-populate the registry_ with custom instruction factories...
 
@@ -104,22 +120,6 @@ namespace mavis
             // Is this a "normal" instruction? (non-expanded, so xpand_name is empty)
             if (xpand_name.empty())
             {
-                // Try to find a matching annotation... first try matching the factory's name
-                // typename AnnotationType::PtrType panno =
-                // anno_registry_.findAnnotation(factory_name); We suppress exceptions if we intend
-                // to try lookup by the mnemonic on failure
-                typename AnnotationType::PtrType panno =
-                    this->findAnnotation(factory_name, mnemonic != factory_name);
-
-                if (panno == nullptr)
-                {
-                    // Try to find a matching annotation for the instruction's mnemonic...
-                    // panno = anno_registry_.findAnnotation(mnemonic);
-                    // NOTE: panno may still be NULL here. findAnnotation() will have thrown an
-                    // exception if there were annotation files provided
-                    panno = this->findAnnotation(mnemonic);
-                }
-
                 // Try to find the named IFactory
                 // ifact = FactoryBuilderBase<FactoryType, InstType, AnnotationType,
                 // AnnotationTypeAllocator>::findIFact(factory_name);
@@ -139,8 +139,10 @@ namespace mavis
                 }
 
                 // This factory may cover several variants (e.g. csr's which use the JSON "factory"
-                // clause). Add this instruction's annotation to the factory
-                ifact->addInstructionVariantAnnotation(mnemonic, panno);
+                // clause). Add this instruction's annotation to the factory: it is looked up by
+                // the factory's name, then by the mnemonic, when the instruction is first decoded
+                ifact->addInstructionVariantAnnotation(mnemonic, factory_name,
+                                                       this->getAnnotationLookup());
                 const InstructionUniqueID inst_uid = this->registerInst(mnemonic);
                 ifact->addInstructionVariantUID(mnemonic, inst_uid);
             }
@@ -205,7 +207,7 @@ namespace mavis
             {
                 panno = this->findAnnotation(olay_base_mnemonic);
             }
-            if ((panno == nullptr) && this->anno_registry_.isPopulated())
+            if ((panno == nullptr) && this->anno_registry_->isPopulated())
             {
                 throw BuildErrorOverlayMissingAnnotation(olay_mnemonic, olay_base_mnemonic);
             }
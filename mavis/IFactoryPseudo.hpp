@@ -3,6 +3,7 @@
 #include "IFactory.h"
 #include "FormGeneric.hpp"
 #include "ExtractorWrap.hpp"
+#include "PreparedInst.h"
 
 namespace mavis {
 
@@ -15,12 +16,13 @@ class IFactoryPseudo : public IFactoryIF<InstType, AnnotationType>
 public:
     typedef std::shared_ptr<IFactoryPseudo> PtrType;
 
+    // The annotation is looked up (by name) when the instruction is first made
     IFactoryPseudo(const std::string& name, InstructionUniqueID uid,
                    const InstMetaData::PtrType& meta,
                    const DisassemblerIF::PtrType& dasm,
                    const FormGeneric::PtrType& form,
-                   const typename AnnotationType::PtrType anno) :
-        name_(name), meta_(meta), dasm_(dasm), form_(form), anno_(anno), uid_(uid)
+                   const typename IFactoryIF<InstType, AnnotationType>::AnnotationLookup& anno_lookup) :
+        name_(name), meta_(meta), dasm_(dasm), form_(form), anno_lookup_(anno_lookup), uid_(uid)
     {}
 
     std::string getName() const override
@@ -46,7 +48,13 @@ public:
                                                                                                   ext_wrap, meta_,
                                                                                                   Opcode(0));
         OpcodeInfo::PtrType optr = std::make_shared<OpcodeInfo>(Opcode(0), new_dii, ext_wrap, meta_, dasm_);
-        return std::make_shared<typename IFactoryIF<InstType, AnnotationType>::IFactoryInfo>(optr, anno_);
+        return std::make_shared<typename IFactoryIF<InstType, AnnotationType>::IFactoryInfo>(optr, getAnnotation_());
+    }
+
+    // Resolve what getInfo() uses for mnemonic, once (see PreparedInst)
+    PreparedInst<AnnotationType> prepare(const std::string& mnemonic) const
+    {
+        return {Symbol(mnemonic), uid_, meta_, dasm_, getAnnotation_(), form_};
     }
 
     void setDisassembler(const DisassemblerIF::PtrType& dasm)
@@ -67,9 +75,19 @@ private:
     InstMetaData::PtrType meta_;
     DisassemblerIF::PtrType dasm_;
     FormGeneric::PtrType form_;
-    typename AnnotationType::PtrType anno_;
+    mutable typename AnnotationType::PtrType anno_;
+    mutable typename IFactoryIF<InstType, AnnotationType>::AnnotationLookup anno_lookup_;
     InstructionUniqueID uid_;
 
+    const typename AnnotationType::PtrType& getAnnotation_() const
+    {
+        if (anno_lookup_) {
+            anno_ = anno_lookup_(name_);
+            anno_lookup_ = nullptr;
+        }
+        return anno_;
+    }
+
 private:
     const Field* getField() const override
     {
@@ -112,6 +130,9 @@ private:
 
     void flushCaches() override
     {}
+
+    void flushCachesIf(const CacheFilter&) override
+    {}
 };
 
 } // namespace mavis
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace mavis
+{
+
+    /**
+     * \brief Vector that keeps up to N elements inline, and moves to the heap past that
+     *
+     * Used for the short per-instruction lists (operands, registers) that are built on every
+     * decode miss: those fit inline, and cost no allocation. Longer lists (e.g. a register list
+     * made from a wide 64-bit mask) spill to the heap. Supports the subset of the std::vector
+     * API that those lists use.
+     */
+    template <typename T, size_t N> class InlineVector
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "InlineVector elements are copied as bytes, and never destroyed");
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                      "InlineVector heap storage comes from the default operator new");
+
+      public:
+        using value_type = T;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        InlineVector() = default;
+
+        InlineVector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+
+        template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        InlineVector(InputIt first, InputIt last)
+        {
+            assign(first, last);
+        }
+
+        InlineVector(const InlineVector & other) { *this = other; }
+
+        InlineVector(InlineVector && other) noexcept { *this = std::move(other); }
+
+        ~InlineVector() { release_(); }
+
+        InlineVector & operator=(const InlineVector & other)
+        {
+            if (this != &other)
+            {
+                clear();
+                reserve(other.size_);
+                std::memcpy(static_cast<void*>(data()), other.data(), other.size_ * sizeof(T));
+                size_ = other.size_;
+            }
+            return *this;
+        }
+
+        InlineVector & operator=(InlineVector && other) noexcept
+        {
+            if (this != &other)
+            {
+                if (other.heap_ != nullptr)
+                {
+                    release_();
+                    heap_ = std::exchange(other.heap_, nullptr);
+                    capacity_ = std::exchange(other.capacity_, N);
+                    size_ = std::exchange(other.size_, 0);
+                }
+                else
+                {
+                    // Fits in either storage
+                    std::memcpy(static_cast<void*>(data()), other.data(), other.size_ * sizeof(T));
+                    size_ = std::exchange(other.size_, 0);
+                }
+            }
+            return *this;
+        }
+
+        template <typename InputIt> void assign(InputIt first, InputIt last)
+        {
+            clear();
+            for (; first != last; ++first)
+            {
+                push_back(*first);
+            }
+        }
+
+        // Elements that fit without a heap allocation
+        static constexpr size_type inline_capacity() { return N; }
+
+        size_type capacity() const { return capacity_; }
+
+        size_type size() const { return size_; }
+
+        bool empty() const { return size_ == 0; }
+
+        T* data()
+        {
+            return (heap_ != nullptr) ? heap_ : std::launder(reinterpret_cast<T*>(storage_));
+        }
+
+        const T* data() const
+        {
+            return (heap_ != nullptr) ? heap_
+                                      : std::launder(reinterpret_cast<const T*>(storage_));
+        }
+
+        iterator begin() { return data(); }
+
+        iterator end() { return data() + size_; }
+
+        const_iterator begin() const { return data(); }
+
+        const_iterator end() const { return data() + size_; }
+
+        const_iterator cbegin() const { return begin(); }
+
+        const_iterator cend() const { return end(); }
+
+        T & operator[](const size_type idx) { return data()[idx]; }
+
+        const T & operator[](const size_type idx) const { return data()[idx]; }
+
+        T & at(const size_type idx)
+        {
+            checkIndex_(idx);
+            return data()[idx];
+        }
+
+        const T & at(const size_type idx) const
+        {
+            checkIndex_(idx);
+            return data()[idx];
+        }
+
+        T & front() { return data()[0]; }
+
+        const T & front() const { return data()[0]; }
+
+        T & back() { return data()[size_ - 1]; }
+
+        const T & back() const { return data()[size_ - 1]; }
+
+        void reserve(const size_type n)
+        {
+            if (n > capacity_)
+            {
+                grow_(n);
+            }
+        }
+
+        void push_back(const T & val) { emplace_back(val); }
+
+        template <typename... ArgTypes> T & emplace_back(ArgTypes &&... args)
+        {
+            if (size_ == capacity_)
+            {
+                // args may refer to an element of this vector
+                const T val(std::forward<ArgTypes>(args)...);
+                grow_(2 * capacity_);
+                return emplace_back(val);
+            }
+            T* elem = ::new (static_cast<void*>(data() + size_)) T(std::forward<ArgTypes>(args)...);
+            ++size_;
+            return *elem;
+        }
+
+        void pop_back() { --size_; }
+
+        void clear() { size_ = 0; }
+
+        bool operator==(const InlineVector & other) const
+        {
+            if (size_ != other.size_)
+            {
+                return false;
+            }
+            for (size_type i = 0; i < size_; ++i)
+            {
+                if (!((*this)[i] == other[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const InlineVector & other) const { return !(*this == other); }
+
+      private:
+        void checkIndex_(const size_type idx) const
+        {
+            if (idx >= size_)
+            {
+                throw std::out_of_range("InlineVector::at: index " + std::to_string(idx)
+                                        + " >= size " + std::to_string(size_));
+            }
+        }
+
+        void grow_(const size_type n)
+        {
+            T* heap = static_cast<T*>(::operator new(n * sizeof(T)));
+            std::memcpy(static_cast<void*>(heap), data(), size_ * sizeof(T));
+            release_();
+            heap_ = heap;
+            capacity_ = n;
+        }
+
+        void release_()
+        {
+            ::operator delete(heap_);
+            heap_ = nullptr;
+            capacity_ = N;
+        }
+
+        alignas(T) unsigned char storage_[N * sizeof(T)];
+        T* heap_ = nullptr; // Elements past N (or nullptr: they are in storage_)
+        size_type capacity_ = N;
+        size_type size_ = 0;
+    };
+
+} // namespace mavis
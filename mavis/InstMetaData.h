@@ -24,7 +24,6 @@
 #include <memory>
 #include <array>
 #include <cinttypes>
-#include <regex>
 
 namespace mavis
 {
@@ -258,8 +257,38 @@ namespace mavis
             {"V", ISAExtensionIndex::V}
         };
 
-        static inline const std::regex isa_ext_pattern_ =
-            std::regex("([1-9][0-9]*?)?([A-Z])", std::regex::optimize);
+        // Finds the first "wX" ISA extension token in s, where 'w' is an optional width (decimal,
+        // no leading zero) and 'X' is an upper case extension letter. Equivalent to a search for
+        // the regex "([1-9][0-9]*)?([A-Z])"
+        static bool tokenizeISAExtension_(const std::string & s, std::string & width,
+                                          std::string & ext)
+        {
+            const size_t len = s.size();
+            for (size_t i = 0; i < len; ++i)
+            {
+                if ((s[i] >= '1') && (s[i] <= '9'))
+                {
+                    size_t j = i + 1;
+                    while ((j < len) && (s[j] >= '0') && (s[j] <= '9'))
+                    {
+                        ++j;
+                    }
+                    if ((j < len) && (s[j] >= 'A') && (s[j] <= 'Z'))
+                    {
+                        width = s.substr(i, j - i);
+                        ext = s.substr(j, 1);
+                        return true;
+                    }
+                }
+                else if ((s[i] >= 'A') && (s[i] <= 'Z'))
+                {
+                    width.clear();
+                    ext = s.substr(i, 1);
+                    return true;
+                }
+            }
+            return false;
+        }
 
         static inline const std::map<std::string, OperandFieldID> ofimap_{
             //{"rs",  OperandFieldID::RS},
@@ -437,15 +466,13 @@ namespace mavis
                #endif
                 if (!ilist.empty())
                 {
-                    std::smatch matches;
                     for (const auto & s : ilist)
                     {
-                        // matches[0] is the entire string matched,
-                        // matches[1] is the capture group for the optional width (emtpy if not
-                        // provided) matches[2] is the capture group for the ISA extension letter
-                        if (std::regex_search(s, matches, isa_ext_pattern_))
+                        std::string width;
+                        std::string ext;
+                        if (tokenizeISAExtension_(s, width, ext))
                         {
-                            const auto itr = isamap_.find(matches[2].str());
+                            const auto itr = isamap_.find(ext);
                             if (itr != isamap_.end())
                             {
                                 isa_ext_ |=
@@ -455,12 +482,12 @@ namespace mavis
                             else
                             {
                                 // Invalid ISA extension letter
-                                throw BuildErrorInvalidISAExtension(JSON_GET(inst, "mnemonic", std::string), s, matches[2].str());
+                                throw BuildErrorInvalidISAExtension(JSON_GET(inst, "mnemonic", std::string), s, ext);
                             }
-                            if (matches[1].length() != 0)
+                            if (!width.empty())
                             {
                                 const uint32_t n =
-                                    std::strtoull(matches[1].str().c_str(), nullptr, 0);
+                                    std::strtoull(width.c_str(), nullptr, 0);
                                 if ((n == 0) || ((n & (n - 1)) != 0))
                                 {
                                     // Not a non-zero power of 2
@@ -487,6 +514,21 @@ namespace mavis
 
         InstMetaData::PtrType clone() const { return std::make_shared<InstMetaData>(*this); }
 
+        /**
+         * \brief Same information (see DecodeNodePool, which shares equal metadata between
+         * contexts)
+         */
+        bool operator==(const InstMetaData & other) const
+        {
+            return (compressed_ == other.compressed_) && (inst_types_ == other.inst_types_)
+                   && (isa_ext_ == other.isa_ext_) && (isa_width_ == other.isa_width_)
+                   && (field_set_ == other.field_set_) && (oper_type_ == other.oper_type_)
+                   && (fixed_fields_ == other.fixed_fields_) && (data_size_ == other.data_size_)
+                   && (tags_.getS() == other.tags_.getS());
+        }
+
+        bool operator!=(const InstMetaData & other) const { return !(*this == other); }
+
         /**
          * Construct according to ISA (for custom instruction factories)
          * @param iset
@@ -751,6 +793,15 @@ namespace mavis
 
         const MatchSet<Tag> getTags() const { return tags_; }
 
+        // Names of the instruction types (the JSON "type" stanza values)
+        static const std::map<std::string, InstructionTypes> & getInstTypeNames() { return tmap_; }
+
+        // Names of the ISA extensions (single letters)
+        static const std::map<std::string, ISAExtensionIndex> & getISAExtensionNames()
+        {
+            return isamap_;
+        }
+
         static inline const std::string & getFieldIDName(OperandFieldID fid)
         {
             assert(fid != OperandFieldID::NONE);
@@ -4,6 +4,7 @@
 #include "DecoderExceptions.h"
 #include "InstMetaData.h"
 #include <map>
+#include <string_view>
 
 namespace mavis {
 
@@ -26,7 +27,7 @@ public:
         return meta;
     }
 
-    InstMetaData::PtrType lookup(const std::string& mnemonic) const
+    InstMetaData::PtrType lookup(const std::string_view mnemonic) const
     {
         const auto iter = registry_.find(mnemonic);
         if (iter != registry_.end()) {
@@ -37,7 +38,7 @@ public:
     }
 
 private:
-    std::map<std::string, InstMetaData::PtrType> registry_;
+    std::map<std::string, InstMetaData::PtrType, std::less<>> registry_;
 };
 
 } // namespace mavis
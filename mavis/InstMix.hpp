@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "DecoderTypes.h"
+#include "DecoderConsts.h"
+#include "InstMetaData.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Compile-time policies for Mavis' dynamic instruction-mix histogram (the last
+     * Mavis template parameter). With InstMixDisabled (the default) nothing is counted and
+     * makeInst/getInfo are unchanged.
+     */
+    struct InstMixDisabled
+    {
+        static constexpr bool enabled = false;
+    };
+
+    struct InstMixEnabled
+    {
+        static constexpr bool enabled = true;
+    };
+
+    /**
+     * \brief Decode counts indexed by UID
+     *
+     * UIDs are small dense integers, so a count is an increment of an array element. The
+     * histogram belongs to one decoder, and so to the one thread using it (see
+     * DecodePipeline); per-thread mixes are combined with InstMix::merge.
+     */
+    class InstMixHistogram
+    {
+      public:
+        void count(const InstructionUniqueID uid)
+        {
+            if (uid >= counts_.size())
+            {
+                counts_.resize(uid + 64, 0);
+            }
+            ++counts_[uid];
+        }
+
+        uint64_t getCount(const InstructionUniqueID uid) const
+        {
+            return (uid < counts_.size()) ? counts_[uid] : 0;
+        }
+
+        const std::vector<uint64_t> & getCounts() const { return counts_; }
+
+        void reset() { std::fill(counts_.begin(), counts_.end(), 0); }
+
+      private:
+        std::vector<uint64_t> counts_;
+    };
+
+    /**
+     * \brief An instruction mix: the counts of a histogram, resolved to mnemonics, instruction
+     * types, ISA extensions and tags (see Mavis::getInstMix)
+     */
+    class InstMix
+    {
+      public:
+        using InstructionTypes = InstMetaData::InstructionTypes;
+        using ISAExtension = InstMetaData::ISAExtension;
+
+        struct Entry
+        {
+            InstructionUniqueID uid = INVALID_UID;
+            std::string mnemonic;
+            uint64_t count = 0;
+            std::underlying_type_t<InstructionTypes> inst_types = 0;
+            std::underlying_type_t<ISAExtension> isa = 0;
+            std::vector<std::string> tags;
+        };
+
+        using CountMap = std::map<std::string, uint64_t>;
+
+        void add(Entry entry)
+        {
+            total_ += entry.count;
+            const auto iter = entries_.find(entry.mnemonic);
+            if (iter == entries_.end())
+            {
+                std::string mnemonic = entry.mnemonic;
+                entries_.emplace(std::move(mnemonic), std::move(entry));
+            }
+            else
+            {
+                iter->second.count += entry.count;
+            }
+        }
+
+        /**
+         * \brief Add the counts of another mix (e.g. another thread's). Entries are combined
+         * by mnemonic, since decoders built separately have different UIDs.
+         */
+        void merge(const InstMix & other)
+        {
+            for (const auto & [mnemonic, entry] : other.entries_)
+            {
+                add(entry);
+            }
+        }
+
+        // By mnemonic
+        const std::map<std::string, Entry> & getEntries() const { return entries_; }
+
+        uint64_t getTotal() const { return total_; }
+
+        uint64_t getCount(const std::string & mnemonic) const
+        {
+            const auto iter = entries_.find(mnemonic);
+            return (iter == entries_.end()) ? 0 : iter->second.count;
+        }
+
+        // Counts by instruction type name ("int", "load", ...): an instruction counts once
+        // for each of its types
+        CountMap byInstType() const
+        {
+            CountMap counts;
+            for (const auto & [name, itype] : InstMetaData::getInstTypeNames())
+            {
+                const auto bits = static_cast<std::underlying_type_t<InstructionTypes>>(itype);
+                sum_(counts, name, [bits](const Entry & e) { return (e.inst_types & bits) != 0; });
+            }
+            return counts;
+        }
+
+        // Counts by ISA extension letter
+        CountMap byExtension() const
+        {
+            CountMap counts;
+            for (const auto & [name, index] : InstMetaData::getISAExtensionNames())
+            {
+                const std::underlying_type_t<ISAExtension> bit =
+                    1ull << static_cast<std::underlying_type_t<decltype(index)>>(index);
+                sum_(counts, name, [bit](const Entry & e) { return (e.isa & bit) != 0; });
+            }
+            return counts;
+        }
+
+        // Counts by tag: an instruction counts once for each of its tags
+        CountMap byTag() const
+        {
+            CountMap counts;
+            for (const auto & [mnemonic, entry] : entries_)
+            {
+                for (const auto & tag : entry.tags)
+                {
+                    counts[tag] += entry.count;
+                }
+            }
+            return counts;
+        }
+
+        /**
+         * \brief Write the mix as a JSON object: the total, the count of each instruction
+         * (with its UID) and the aggregations by type, extension and tag
+         */
+        void writeJSON(std::ostream & os) const
+        {
+            os << "{\n  \"total\": " << total_ << ",\n  \"instructions\": {";
+            const char* sep = "\n";
+            for (const auto & [mnemonic, entry] : entries_)
+            {
+                os << sep << "    ";
+                writeString_(os, mnemonic);
+                os << ": {\"uid\": " << entry.uid << ", \"count\": " << entry.count << "}";
+                sep = ",\n";
+            }
+            os << "\n  },\n  \"types\": ";
+            writeCounts_(os, byInstType());
+            os << ",\n  \"extensions\": ";
+            writeCounts_(os, byExtension());
+            os << ",\n  \"tags\": ";
+            writeCounts_(os, byTag());
+            os << "\n}\n";
+        }
+
+        /**
+         * \brief Write the mix as CSV, one row per instruction:
+         * mnemonic,uid,count,extensions,types,tags (lists separated by spaces)
+         */
+        void writeCSV(std::ostream & os) const
+        {
+            os << "mnemonic,uid,count,extensions,types,tags\n";
+            for (const auto & [mnemonic, entry] : entries_)
+            {
+                os << mnemonic << "," << entry.uid << "," << entry.count << ",";
+                const char* sep = "";
+                for (const auto & [name, index] : InstMetaData::getISAExtensionNames())
+                {
+                    if ((entry.isa >> static_cast<std::underlying_type_t<decltype(index)>>(index))
+                        & 1)
+                    {
+                        os << sep << name;
+                        sep = " ";
+                    }
+                }
+                os << ",";
+                sep = "";
+                for (const auto & [name, itype] : InstMetaData::getInstTypeNames())
+                {
+                    if (entry.inst_types
+                        & static_cast<std::underlying_type_t<InstructionTypes>>(itype))
+                    {
+                        os << sep << name;
+                        sep = " ";
+                    }
+                }
+                os << ",";
+                sep = "";
+                for (const auto & tag : entry.tags)
+                {
+                    os << sep << tag;
+                    sep = " ";
+                }
+                os << "\n";
+            }
+        }
+
+      private:
+        // Types, extensions and tags with no instructions are left out
+        template <typename SelectFunc>
+        void sum_(CountMap & counts, const std::string & name, const SelectFunc & select) const
+        {
+            uint64_t sum = 0;
+            for (const auto & [mnemonic, entry] : entries_)
+            {
+                if (select(entry))
+                {
+                    sum += entry.count;
+                }
+            }
+            if (sum != 0)
+            {
+                counts[name] = sum;
+            }
+        }
+
+        static void writeString_(std::ostream & os, const std::string & s)
+        {
+            os << '"';
+            for (const char c : s)
+            {
+                if ((c == '"') || (c == '\\'))
+                {
+                    os << '\\';
+                }
+                os << c;
+            }
+            os << '"';
+        }
+
+        static void writeCounts_(std::ostream & os, const CountMap & counts)
+        {
+            os << "{";
+            const char* sep = "";
+            for (const auto & [name, count] : counts)
+            {
+                os << sep;
+                writeString_(os, name);
+                os << ": " << count;
+                sep = ", ";
+            }
+            os << "}";
+        }
+
+        std::map<std::string, Entry> entries_;
+        uint64_t total_ = 0;
+    };
+
+} // namespace mavis
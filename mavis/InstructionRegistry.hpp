@@ -3,7 +3,10 @@
 #include "DecoderTypes.h"
 #include "DecoderExceptions.h"
 #include "SimpleDynArray.hpp"
+#include "PerfectHash.hpp"
+#include <atomic>
 #include <map>
+#include <string_view>
 
 namespace mavis {
 
@@ -32,7 +35,8 @@ private:
         }
 
         void allocateUID(InstructionUniqueID uid) {
-            next_uid_ = std::max(uid + 1, next_uid_);
+            InstructionUniqueID next = next_uid_;
+            while ((uid + 1 > next) && !next_uid_.compare_exchange_weak(next, uid + 1)) {}
         }
 
     private:
@@ -42,7 +46,10 @@ private:
         // the instruction a different UID in each context can help prevent the case where the user
         // has saved the UID under one context, then attempts to look that saved UID up in a different context
         // (and inadvertently retrieve info for the wrong instruction)
-        static inline InstructionUniqueID next_uid_ = 1;
+        //
+        // The counter is atomic since contexts may be built on background threads (see
+        // ContextRegistry)
+        static inline std::atomic<InstructionUniqueID> next_uid_ = 1;
     };
 
 public:
@@ -72,13 +79,20 @@ public:
 
     InstructionRegistry(const InstructionRegistry&) = delete;
 
-    InstructionUniqueID lookupUID(const std::string& mnemonic) const
+    InstructionUniqueID lookupUID(const std::string_view mnemonic) const
     {
-        try {
-            return id_map_.at(mnemonic);
-        } catch (const std::out_of_range& exc) {
-            return INVALID_UID;
+        if (const InstructionUniqueID* uid = id_index_.find(mnemonic)) {
+            return *uid;
         }
+        const auto iter = id_map_.find(mnemonic);
+        return (iter == id_map_.end()) ? INVALID_UID : iter->second;
+    }
+
+    // Index the mnemonics registered so far with a perfect hash (called once the context is
+    // configured). Mnemonics registered later are still found, through the map
+    void freezeLookups()
+    {
+        id_index_.build(id_map_);
     }
 
     const std::string& lookupMnemonic(const InstructionUniqueID uid) const
@@ -86,6 +100,19 @@ public:
         return mnemonic_array_[uid];
     }
 
+    // The registered instructions and their UIDs, as a UID list for another registry. Aliases
+    // (which share their expansion's UID) are left out: they are aliased again when built.
+    InstUIDList getUIDList() const
+    {
+        InstUIDList uid_list;
+        for (const auto& [mnemonic, uid] : id_map_) {
+            if (mnemonic_array_.contains(uid) && (mnemonic_array_[uid] == mnemonic)) {
+                uid_list.push_back({mnemonic, uid});
+            }
+        }
+        return uid_list;
+    }
+
     // This method is used by the builder to set up an "alias" from a compressed
     // instruction to its expanded form. Both the compressed and the expansion
     // share the same UID. We don't want to add this to the mnemonic_array_ since it
@@ -135,9 +162,10 @@ public:
     }
 
 private:
-    UIDManager                                       uid_man_;
-    std::map<const std::string, InstructionUniqueID> id_map_;
-    SimpleDynArray<std::string>                      mnemonic_array_;
+    UIDManager                                                   uid_man_;
+    std::map<std::string, InstructionUniqueID, std::less<>>      id_map_;
+    PerfectHashIndex<InstructionUniqueID>                        id_index_;
+    SimpleDynArray<std::string>                                  mnemonic_array_;
 };
 
 } // namespace mavis
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cctype>
 #include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
 #ifdef USE_NLOHMANN_JSON
 #include <nlohmann/json.hpp>
@@ -10,6 +16,11 @@
 #endif
 #include <boost/system/system_error.hpp>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace mavis
 {
 
@@ -19,64 +30,317 @@ namespace mavis
     using json_value = boost::json::value;
 #endif
 
-    // Parses the JSON file at the given path
-    inline json_value parseJSON(const std::string& path)
+    /**
+     * \brief Read-only memory mapping of a file
+     *
+     * Throws std::ifstream::failure if the file cannot be opened (like the std::ifstream it
+     * replaces in parseJSON)
+     */
+    class MappedFile
     {
-        std::ifstream fs;
+      public:
+        explicit MappedFile(const std::string& path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::ifstream::failure("Cannot open " + path);
+            }
 
-#ifndef TARGET_OS_MAC
-        std::ios_base::iostate exceptionMask = fs.exceptions() | std::ios::failbit;
-        fs.exceptions(exceptionMask);
-#endif
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw std::ifstream::failure("Cannot stat " + path);
+            }
 
-        fs.open(path);
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ > 0)
+            {
+                void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::ifstream::failure("Cannot map " + path);
+                }
+                data_ = static_cast<const char*>(addr);
+                ::madvise(addr, size_, MADV_SEQUENTIAL);
+            }
+            ::close(fd);
+        }
 
-#ifndef TARGET_OS_MAC
-        exceptionMask &= ~std::ios::failbit;
-        fs.exceptions(exceptionMask);
-#endif
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
 
+        ~MappedFile()
+        {
+            if (data_ != nullptr)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+        }
+
+        std::string_view view() const { return {data_, size_}; }
+
+      private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Parses a JSON text (path is only used for error messages)
+    inline json_value parseJSONText(const std::string_view text, const std::string& path)
+    {
 #ifdef USE_NLOHMANN_JSON
         try {
-            json_value json;
-            fs >> json;
-            return json;
+            return nlohmann::json::parse(text.begin(), text.end());
         } catch (const std::exception& ex) {
             throw std::runtime_error("Error parsing JSON " + path + ": " + ex.what());
         }
 #else
         boost::system::error_code ec;
+        json_value json = boost::json::parse(boost::json::string_view(text.data(), text.size()), ec);
+        if (ec)
+        {
+            throw boost::system::system_error(ec, "Error parsing JSON " + path);
+        }
+        return json;
+#endif
+    }
 
-        try
+    // Parses the JSON file at the given path
+    inline json_value parseJSON(const std::string& path)
+    {
+        const MappedFile file(path);
+        return parseJSONText(file.view(), path);
+    }
+
+#ifdef USE_NLOHMANN_JSON
+    /**
+     * \brief SAX handler for forEachJSONArrayElement: builds each element of the top-level array
+     * from the parser's events, and hands it to the consumer as soon as it is complete
+     */
+    template<typename ConsumerType>
+    class JSONArrayElementSAX
+    {
+      public:
+        using number_integer_t = json_value::number_integer_t;
+        using number_unsigned_t = json_value::number_unsigned_t;
+        using number_float_t = json_value::number_float_t;
+        using string_t = json_value::string_t;
+
+        JSONArrayElementSAX(const std::string& path, ConsumerType& consumer) :
+            path_(path), consumer_(consumer)
         {
-#if (BOOST_VERSION / 100 >= 1081)
-            const boost::json::value json = boost::json::parse(fs, ec);
-            if (json.is_null() || ec)
-            {
-                throw boost::system::system_error(ec);
+        }
+
+        bool null() { return value_([](auto& b) { return b.null(); }); }
+
+        bool boolean(bool val) { return value_([val](auto& b) { return b.boolean(val); }); }
+
+        bool number_integer(number_integer_t val)
+        {
+            return value_([val](auto& b) { return b.number_integer(val); });
+        }
+
+        bool number_unsigned(number_unsigned_t val)
+        {
+            return value_([val](auto& b) { return b.number_unsigned(val); });
+        }
+
+        bool number_float(number_float_t val, const string_t& s)
+        {
+            return value_([val, &s](auto& b) { return b.number_float(val, s); });
+        }
+
+        bool string(string_t& val) { return value_([&val](auto& b) { return b.string(val); }); }
+
+        bool key(string_t& val) { return builder_->key(val); }
+
+        bool start_object(std::size_t elements)
+        {
+            if (depth_ == 0) {
+                throw malformed_("expected a top-level array");
             }
-#else
-            boost::json::stream_parser parser;
-            std::string buf;
-            while (std::getline(fs, buf))
-            {
-                parser.write(buf);
+            startElement_();
+            ++depth_;
+            return builder_->start_object(elements);
+        }
+
+        bool end_object()
+        {
+            builder_->end_object();
+            return endContainer_();
+        }
+
+        bool start_array(std::size_t elements)
+        {
+            if (depth_ == 0) {
+                depth_ = 1;
+                return true;
             }
-            parser.finish(ec);
+            startElement_();
+            ++depth_;
+            return builder_->start_array(elements);
+        }
 
-            if (ec)
-            {
-                throw boost::system::system_error(ec);
+        bool end_array()
+        {
+            if (depth_ == 1) {
+                depth_ = 0;
+                return true;
+            }
+            builder_->end_array();
+            return endContainer_();
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex)
+        {
+            throw std::runtime_error("Error parsing JSON " + path_ + ": " + ex.what());
+        }
+
+      private:
+        using Builder = nlohmann::detail::json_sax_dom_parser<json_value>;
+
+        const std::string& path_;
+        ConsumerType& consumer_;
+        uint32_t depth_ = 0; // Open arrays and objects, the top-level array included
+        json_value element_;
+        std::unique_ptr<Builder> builder_;
+
+        std::runtime_error malformed_(const char* why) const
+        {
+            return std::runtime_error("Error parsing JSON " + path_ + ": " + why);
+        }
+
+        void startElement_()
+        {
+            if (depth_ == 1) {
+                element_ = json_value();
+                builder_ = std::make_unique<Builder>(element_);
+            }
+        }
+
+        // A scalar: an element on its own, or part of the one being built
+        template<typename EventType>
+        bool value_(EventType&& event)
+        {
+            if (depth_ == 0) {
+                throw malformed_("expected a top-level array");
+            }
+            if (depth_ == 1) {
+                startElement_();
+                event(*builder_);
+                return consume_();
             }
+            return event(*builder_);
+        }
 
-            const boost::json::value json = parser.release();
+        bool endContainer_()
+        {
+            return (--depth_ == 1) ? consume_() : true;
+        }
+
+        bool consume_()
+        {
+            builder_.reset();
+            consumer_(element_);
+            return true;
+        }
+    };
 #endif
-            return json;
+
+    /**
+     * \brief Streams the elements of the top-level array in the JSON file at the given path
+     *
+     * Each element is handed to the consumer, which may modify or move from it, as soon as it has
+     * been parsed; the document as a whole is never built. The ISA and annotation files are
+     * arrays of small per-instruction objects, so this keeps only one instruction's worth of JSON
+     * alive at a time. Anything but whitespace after the array is an error, as it is for a
+     * whole-document parse.
+     *
+     * With nlohmann::json, one SAX pass over the mapped file builds the elements. With
+     * boost::json, a scanner that tracks strings and nesting finds the extent of each element,
+     * which is then parsed on its own (straight from the mapped file).
+     */
+    template<typename ConsumerType>
+    inline void forEachJSONArrayElement(const std::string& path, ConsumerType&& consumer)
+    {
+#ifdef USE_NLOHMANN_JSON
+        const MappedFile file(path);
+        const std::string_view text = file.view();
+        JSONArrayElementSAX<std::remove_reference_t<ConsumerType>> sax(path, consumer);
+        nlohmann::json::sax_parse(text.begin(), text.end(), &sax);
+#else
+        const MappedFile file(path);
+        const std::string_view text = file.view();
+        const auto malformed = [&path](const char* why) {
+            return std::runtime_error("Error parsing JSON " + path + ": " + why);
+        };
+        const auto skip_ws = [&text](size_t pos) {
+            while ((pos < text.size()) && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+            }
+            return pos;
+        };
+
+        size_t pos = skip_ws(0);
+        if ((pos == text.size()) || (text[pos] != '[')) {
+            throw malformed("expected a top-level array");
+        }
+        const auto end_of_array = [&](const size_t close) {
+            if (skip_ws(close + 1) != text.size()) {
+                throw malformed("unexpected content after the top-level array");
+            }
+        };
+
+        pos = skip_ws(pos + 1);
+        if ((pos < text.size()) && (text[pos] == ']')) {
+            end_of_array(pos);
+            return;
         }
-        catch (const boost::system::system_error& ex)
+
+        // Find each element's extent: the next ',' or ']' outside of any string or nested value
+        while (pos < text.size())
         {
-            throw boost::system::system_error(ex.code(), "Error parsing JSON " + path);
+            const size_t start = pos;
+            uint32_t depth = 0;
+            bool in_string = false;
+            for (; pos < text.size(); ++pos)
+            {
+                const char c = text[pos];
+                if (in_string) {
+                    if (c == '\\') {
+                        ++pos;
+                    } else if (c == '"') {
+                        in_string = false;
+                    }
+                } else if (c == '"') {
+                    in_string = true;
+                } else if ((c == '{') || (c == '[')) {
+                    ++depth;
+                } else if ((c == '}') || (c == ']')) {
+                    if (depth == 0) {
+                        break;
+                    }
+                    --depth;
+                } else if ((c == ',') && (depth == 0)) {
+                    break;
+                }
+            }
+            if (pos >= text.size()) {
+                throw malformed("unterminated top-level array");
+            }
+
+            json_value element = parseJSONText(text.substr(start, pos - start), path);
+            consumer(element);
+
+            if (text[pos] == ']') {
+                end_of_array(pos);
+                return;
+            }
+            pos = skip_ws(pos + 1);
         }
+        throw malformed("unterminated top-level array");
 #endif
     }
 
@@ -93,6 +357,19 @@ namespace mavis
         }
     }
 
+    template<typename OpenFailedExceptionType, typename ConsumerType>
+    inline void forEachJSONArrayElementWithException(const std::string& path, ConsumerType&& consumer)
+    {
+        try
+        {
+            forEachJSONArrayElement(path, std::forward<ConsumerType>(consumer));
+        }
+        catch (const std::ifstream::failure&)
+        {
+            throw OpenFailedExceptionType(path);
+        }
+    }
+
     struct JSONStringMapCompare : public std::less<std::string>
     {
         using is_transparent = void;
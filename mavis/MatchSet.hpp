@@ -36,6 +36,11 @@ public:
         return t_vect_;
     }
 
+    const std::set<std::string>& getS() const
+    {
+        return s_set_;
+    }
+
     void merge(const std::set<std::string>& other_set)
     {
         std::set<std::string> set_union;
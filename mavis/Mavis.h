@@ -4,8 +4,14 @@
 #include "mavis/DecoderTypes.h"
 #include "mavis/DTable.h"
 #include "mavis/ContextRegistry.hpp"
+#include "mavis/BlockCache.hpp"
+#include "mavis/WarmCacheFile.hpp"
+#include "mavis/TextScanner.hpp"
+#include "mavis/InstMix.hpp"
 #include <memory>
+#include <type_traits>
 #include <vector>
+#include <unordered_map>
 #include <string>
 #include <iostream>
 
@@ -29,10 +35,13 @@ namespace mavis
  * \brief Mavis decoder toplevel facade
  * \tparam InstType type of instructions to generate
  * \tparam AnnotationType type of micro-architectural info objects to use
+ * \tparam InstMixPolicy mavis::InstMixEnabled to count the decoded instructions (see
+ * getInstMix)
  */
 template <typename InstType, typename AnnotationType,
           typename InstTypeAllocator = mavis::SharedPtrAllocator<InstType>,
-          typename AnnotationTypeAllocator = mavis::SharedPtrAllocator<AnnotationType>>
+          typename AnnotationTypeAllocator = mavis::SharedPtrAllocator<AnnotationType>,
+          typename InstMixPolicy = mavis::InstMixDisabled>
 class Mavis
 {
   public:
@@ -50,6 +59,8 @@ class Mavis
         mavis::ContextRegistry<InstType, AnnotationType, AnnotationTypeAllocator>;
     using InstUIDList = mavis::InstUIDList;
     using AnnotationOverrides = mavis::AnnotationOverrides;
+    using BlockCacheType = mavis::BlockCache<InstType>;
+    using BlockType = typename BlockCacheType::BlockType;
 
   public:
     /**
@@ -63,6 +74,8 @@ class Mavis
      * objects
      * @param annotation_allocator Reference to a memory allocator to use when creating
      * AnnotationType objects
+     * @param anno_load_mode       EAGER constructs every annotation when a context is built;
+     * LAZY indexes the annotation JSON and constructs an annotation on its first lookup
      *
      * \note Keep in mind that the allocators are _copied_ into this class.
      *
@@ -82,10 +95,11 @@ class Mavis
           const mavis::MatchSet<mavis::Pattern> & exclusions,
           const InstTypeAllocator & inst_allocator = mavis::SharedPtrAllocator<InstType>(),
           const AnnotationTypeAllocator & annotation_allocator =
-              mavis::SharedPtrAllocator<AnnotationType>()) :
+              mavis::SharedPtrAllocator<AnnotationType>(),
+          mavis::AnnotationLoadMode anno_load_mode = mavis::AnnotationLoadMode::EAGER) :
         inst_allocator_(inst_allocator),
         annotation_allocator_(annotation_allocator),
-        context_(annotation_allocator)
+        context_(annotation_allocator, anno_load_mode)
     {
         static_assert(std::is_same<typename InstTypeAllocator::InstTypePtr,
                                    typename InstType::PtrType>::value,
@@ -140,12 +154,79 @@ class Mavis
                              exclusions);
     }
 
-    void switchContext(const std::string & name)
+    /**
+     * \brief Register a context that is built on the first switchContext() to it
+     *
+     * Build errors are reported by that switchContext() call.
+     */
+    void makeContextLazy(
+        const std::string & name, const FileNameListType & isa_files,
+        const FileNameListType & anno_files, const InstUIDList & uid_list = {},
+        const AnnotationOverrides & anno_overrides = {},
+        const mavis::MatchSet<mavis::Pattern> & inclusions = mavis::MatchSet<mavis::Pattern>(),
+        const mavis::MatchSet<mavis::Pattern> & exclusions = mavis::MatchSet<mavis::Pattern>())
+    {
+        context_.makeContext(name, isa_files, anno_files, uid_list, anno_overrides, inclusions,
+                             exclusions, mavis::ContextBuildMode::LAZY);
+    }
+
+    /**
+     * \brief Register a context that is built on a background thread
+     *
+     * Decoding may continue in the current context meanwhile. Use isContextReady() to poll, or
+     * waitForContext() to block; switchContext() to it also blocks until the build is done.
+     * Build errors are reported by switchContext()/waitForContext().
+     */
+    void makeContextAsync(
+        const std::string & name, const FileNameListType & isa_files,
+        const FileNameListType & anno_files, const InstUIDList & uid_list = {},
+        const AnnotationOverrides & anno_overrides = {},
+        const mavis::MatchSet<mavis::Pattern> & inclusions = mavis::MatchSet<mavis::Pattern>(),
+        const mavis::MatchSet<mavis::Pattern> & exclusions = mavis::MatchSet<mavis::Pattern>())
     {
-        context_.switchContext(name);
+        context_.makeContext(name, isa_files, anno_files, uid_list, anno_overrides, inclusions,
+                             exclusions, mavis::ContextBuildMode::ASYNC);
+    }
+
+    bool isContextReady(const std::string & name) const { return context_.isContextReady(name); }
+
+    /**
+     * \brief Number of decode tree nodes and metadata objects that contexts share with contexts
+     * made before them (see mavis/DecodeNodePool.hpp). Leaves are only shared between contexts
+     * made with the same UID list.
+     */
+    size_t getNumSharedDecodeNodes() const { return context_.getNumSharedNodes(); }
+
+    void waitForContext(const std::string & name) { context_.waitForContext(name); }
+
+    /**
+     * \brief Handle of the named context, for switching to it (or decoding in it) without a
+     * name lookup. Waits for a LAZY/ASYNC context to be built.
+     */
+    mavis::ContextHandle getContextHandle(const std::string & name)
+    {
+        return context_.getContextHandle(name);
+    }
+
+    mavis::ContextHandle getCurrentContext() const { return context_.getCurrentContext(); }
+
+    void switchContext(const std::string & name) { switchContext(getContextHandle(name)); }
+
+    /**
+     * \brief Switch to a context by handle: no name lookup, and nothing is done when ctx is
+     * already the current context
+     */
+    void switchContext(const mavis::ContextHandle ctx)
+    {
+        if ((dtrie_ != nullptr) && (ctx == context_.getCurrentContext()))
+        {
+            return;
+        }
+        context_.switchContext(ctx);
         builder_ = context_.getBuilder();
         pseudo_builder_ = context_.getPseudoBuilder();
         dtrie_ = context_.getDTable();
+        context_name_ = context_.getContextSymbol(ctx);
     }
 
     bool hasContext(const std::string & name) { return context_.hasContext(name); }
@@ -153,15 +234,47 @@ class Mavis
     template <typename... ArgTypes>
     typename InstType::PtrType makeInst(const mavis::Opcode icode, ArgTypes &&... args)
     {
+        if constexpr (InstMixPolicy::enabled)
+        {
+            inst_mix_.count(dtrie_->getOpcodeClass(icode).uid);
+        }
         return dtrie_->makeInst(icode, inst_allocator_, std::forward<ArgTypes>(args)...);
     }
 
-    template <typename TraceInfoType, typename... ArgTypes>
+    template <typename TraceInfoType, typename... ArgTypes,
+              typename = std::enable_if_t<!std::is_same_v<TraceInfoType, mavis::ContextHandle>>>
     typename InstType::PtrType makeInstFromTrace(const TraceInfoType & tinfo, ArgTypes &&... args)
     {
         return dtrie_->makeInstFromTrace(tinfo, inst_allocator_, std::forward<ArgTypes>(args)...);
     }
 
+    /*
+     * Decode in the given context, without switching to it (e.g. one handle per hart).
+     *
+     * This is single threaded, like makeInst: a context's tables are caches filled in by every
+     * decode, shared by all users of the handle (and, for shared decode nodes, by other
+     * contexts). Harts decoded on different threads need a Mavis per thread (see DecodePipeline).
+     */
+    template <typename... ArgTypes>
+    typename InstType::PtrType makeInst(const mavis::ContextHandle ctx, const mavis::Opcode icode,
+                                        ArgTypes &&... args)
+    {
+        if constexpr (InstMixPolicy::enabled)
+        {
+            inst_mix_.count(context_.getDTable(ctx).getOpcodeClass(icode).uid);
+        }
+        return context_.getDTable(ctx).makeInst(icode, inst_allocator_,
+                                                std::forward<ArgTypes>(args)...);
+    }
+
+    template <typename TraceInfoType, typename... ArgTypes>
+    typename InstType::PtrType makeInstFromTrace(const mavis::ContextHandle ctx,
+                                                 const TraceInfoType & tinfo, ArgTypes &&... args)
+    {
+        return context_.getDTable(ctx).makeInstFromTrace(tinfo, inst_allocator_,
+                                                         std::forward<ArgTypes>(args)...);
+    }
+
     template <typename... ArgTypes>
     typename InstType::PtrType makeInstDirectly(const mavis::ExtractorDirectInfoIF & user_info,
                                                 ArgTypes &&... args)
@@ -170,6 +283,36 @@ class Mavis
                                         std::forward<ArgTypes>(args)...);
     }
 
+    using InstPtrType = typename InstType::PtrType;
+    using PreparedInstType = mavis::PreparedInst<AnnotationType>;
+
+    /**
+     * \brief Resolve an instruction (by mnemonic or UID) once, for repeated creation with
+     * makeInstDirectly(prepared, ...). See mavis/PreparedInst.h
+     */
+    PreparedInstType prepareInstDirectly(const std::string & mnemonic) const
+    {
+        return dtrie_->prepareInstDirectly(mnemonic);
+    }
+
+    PreparedInstType prepareInstDirectly(const mavis::InstructionUniqueID uid) const
+    {
+        return dtrie_->prepareInstDirectly(uid);
+    }
+
+    /**
+     * \brief Create an instruction from a prepared handle; only the operands of user_info are
+     * used (its mnemonic/UID are ignored)
+     */
+    template <typename... ArgTypes>
+    typename InstType::PtrType makeInstDirectly(const PreparedInstType & prepared,
+                                                const mavis::ExtractorDirectInfoIF & user_info,
+                                                ArgTypes &&... args)
+    {
+        return dtrie_->makeInstDirectly(prepared, user_info, inst_allocator_,
+                                        std::forward<ArgTypes>(args)...);
+    }
+
     /**
      * @brief makePseudoInst -- create a pseudo instruction (InstType)
      * @tparam ArgTypes
@@ -214,35 +357,152 @@ class Mavis
         return inst;
     }
 
+    /**
+     * \brief Resolve a pseudo instruction (by mnemonic or UID) once, for repeated creation with
+     * makePseudoInst(prepared, ...). See mavis/PreparedInst.h
+     */
+    PreparedInstType preparePseudoInst(const std::string & mnemonic) const
+    {
+        const auto & ifact = pseudo_builder_->findIFact(mnemonic);
+        if (ifact == nullptr)
+        {
+            throw mavis::UnknownPseudoMnemonic(mnemonic);
+        }
+        return ifact->prepare(mnemonic);
+    }
+
+    PreparedInstType preparePseudoInst(const mavis::InstructionUniqueID uid) const
+    {
+        const std::string & mnemonic = lookupPseudoInstMnemonic(uid);
+        const auto ifact = pseudo_builder_->findIFact(uid);
+        if (ifact == nullptr)
+        {
+            throw mavis::UnknownPseudoMnemonic(mnemonic);
+        }
+        return ifact->prepare(mnemonic);
+    }
+
+    template <typename... ArgTypes>
+    typename InstType::PtrType makePseudoInst(const PreparedInstType & prepared,
+                                              const mavis::ExtractorDirectInfoIF & ex_info,
+                                              ArgTypes &&... args)
+    {
+        return inst_allocator_(prepared.makeOpcodeInfo(ex_info), prepared.anno,
+                               std::forward<ArgTypes>(args)...);
+    }
+
     void morphInst(typename InstType::PtrType inst,
                    const mavis::ExtractorDirectInfoIF & user_info) const
     {
         dtrie_->morphInst(inst, user_info);
     }
 
-    // Not const because getInfo will cache instruction information
-    DecodeInfoType getInfo(const mavis::Opcode icode) { return dtrie_->getInfo(icode); }
+    /**
+     * \brief Decoded block at pc, in the current context (see mavis/BlockCache.hpp)
+     *
+     * On a miss, instructions are fetched and decoded from pc up to the next branch, jump, or
+     * system instruction. The block stays cached until invalidateBlocks() covers any of it, or
+     * flushBlocks()/flushCaches().
+     *
+     * \param fetch Callable returning the 32 bits at an address (only the low 16 are used for a
+     * compressed instruction)
+     * \param args Passed to the InstType constructor, as for makeInst()
+     */
+    template <typename FetchFunc, typename... ArgTypes>
+    const BlockType & getBlock(const uint64_t pc, FetchFunc && fetch, ArgTypes &&... args)
+    {
+        if (const BlockType* block = blocks_.find(context_name_, pc); block != nullptr)
+        {
+            return *block;
+        }
+        return blocks_.insert(context_name_, decodeBlock_(pc, fetch, args...));
+    }
+
+    // Drop cached blocks (of every context) with any byte in [start, end), e.g. for stores to
+    // code, or a fence.i
+    void invalidateBlocks(uint64_t start, uint64_t end) { blocks_.invalidate(start, end); }
+
+    void flushBlocks() { blocks_.clear(); }
 
     // Not const because getInfo will cache instruction information
+    DecodeInfoType getInfo(const mavis::Opcode icode)
+    {
+        DecodeInfoType info = dtrie_->getInfo(icode);
+        if constexpr (InstMixPolicy::enabled)
+        {
+            inst_mix_.count(info->opinfo->getInstructionUniqueID());
+        }
+        return info;
+    }
+
+    DecodeInfoType getInfo(const mavis::ContextHandle ctx, const mavis::Opcode icode)
+    {
+        DecodeInfoType info = context_.getDTable(ctx).getInfo(icode);
+        if constexpr (InstMixPolicy::enabled)
+        {
+            inst_mix_.count(info->opinfo->getInstructionUniqueID());
+        }
+        return info;
+    }
+
+    /**
+     * \brief Decode icode into a non-owning, trivially copyable view (see mavis/DecodedView.h)
+     *
+     * The view is a handle into the decoder's view cache: valid until that cache line is reused
+     * for another opcode or flushCaches() (and not after this Mavis is destroyed)
+     */
+    mavis::DecodedView<AnnotationType> getDecodedView(const mavis::Opcode icode)
+    {
+        return dtrie_->getDecodedView(icode);
+    }
+
+    /**
+     * \brief UID and type bits of icode, from a compact classification table (see
+     * mavis/OpcodeClass.h). The reference is valid until the next classification.
+     */
+    const mavis::OpcodeClass & getOpcodeClass(Opcode icode) { return dtrie_->getOpcodeClass(icode); }
+
+    /**
+     * \brief Disassemble icode into buf without allocating (NUL terminated, truncated if cap is
+     * too small)
+     * \return Length of the complete disassembly, as with snprintf
+     */
+    size_t dasmTo(Opcode icode, char* buf, size_t cap) { return dtrie_->dasmTo(icode, buf, cap); }
+
+    size_t dasmTo(const mavis::ContextHandle ctx, Opcode icode, char* buf, size_t cap)
+    {
+        return context_.getDTable(ctx).dasmTo(icode, buf, cap);
+    }
+
+    /**
+     * \brief Cache the disassembly of each opcode for dasmTo() (in the current context)
+     */
+    void enableDasmCache(bool enable = true) { dtrie_->enableDasmCache(enable); }
+
+    // Not const because the classification is cached
     bool isOpcodeInstType(Opcode icode, InstructionType itype)
     {
-        const DecodeInfoType info = getInfo(icode);
-        return info->opinfo->isInstType(itype);
+        return getOpcodeClass(icode).isInstType(itype);
     }
 
-    // Not const because getInfo will cache instruction information
+    // Not const because the classification is cached
     bool isOpcodeExtractedInstType(Opcode icode, ExtractedInstType itype)
     {
-        const DecodeInfoType info = getInfo(icode);
-        return info->opinfo->isExtractedInstType(itype);
+        return getOpcodeClass(icode).isExtractedInstType(itype);
+    }
+
+    // Not const because the classification is cached
+    mavis::InstructionUniqueID lookupOpcodeUniqueID(Opcode icode)
+    {
+        return getOpcodeClass(icode).uid;
     }
 
-    mavis::InstructionUniqueID lookupInstructionUniqueID(const std::string & mnemonic) const
+    mavis::InstructionUniqueID lookupInstructionUniqueID(const std::string_view mnemonic) const
     {
         return builder_->findInstructionUID(mnemonic);
     }
 
-    mavis::InstructionUniqueID lookupPseudoInstUniqueID(const std::string & mnemonic) const
+    mavis::InstructionUniqueID lookupPseudoInstUniqueID(const std::string_view mnemonic) const
     {
         return pseudo_builder_->findInstructionUID(mnemonic);
     }
@@ -252,6 +512,12 @@ class Mavis
         return builder_->findInstructionMnemonic(uid);
     }
 
+    /**
+     * \brief UIDs of the current context's instructions, as a uid_list for another Mavis (e.g.
+     * the decoder of another thread), so that both give every instruction the same UID
+     */
+    InstUIDList getInstUIDList() const { return builder_->getInstUIDList(); }
+
     const std::string & lookupPseudoInstMnemonic(const mavis::InstructionUniqueID uid) const
     {
         return pseudo_builder_->findInstructionMnemonic(uid);
@@ -276,7 +542,228 @@ class Mavis
         }
     }
 
-    void flushCaches() { dtrie_->flushCaches(); }
+    void flushCaches()
+    {
+        dtrie_->flushCaches();
+        blocks_.clear();
+    }
+
+    /*
+     * Selective invalidation, for when only some decodes are stale. These drop what the current
+     * context's decode table (and every level below it) cached for the selected opcodes, plus
+     * the cached blocks containing them, and leave everything else warm.
+     */
+    void invalidateOpcode(Opcode icode) { invalidate_(mavis::CacheFilter::opcode(icode)); }
+
+    // Opcodes with (icode & mask) == value
+    void invalidateOpcodes(Opcode mask, Opcode value)
+    {
+        invalidate_(mavis::CacheFilter::opcodes(mask, value));
+    }
+
+    // Opcodes that decode to the instruction (or overlay) uid
+    void invalidateInst(mavis::InstructionUniqueID uid)
+    {
+        invalidate_(mavis::CacheFilter::inst(uid));
+    }
+
+    void invalidateInst(const std::string & mnemonic)
+    {
+        invalidateInst(lookupUID_(mnemonic));
+    }
+
+    /**
+     * \brief Drop the cached instructions built from annotations (all of them, or those of one
+     * instruction), e.g. after modifying annotations in place. Decodes stay cached.
+     */
+    void invalidateAnnotations()
+    {
+        dtrie_->invalidateAnnotations(mavis::CacheFilter::all());
+        blocks_.clear();
+    }
+
+    void invalidateAnnotations(const std::string & mnemonic)
+    {
+        const auto filter = mavis::CacheFilter::inst(lookupUID_(mnemonic));
+        dtrie_->invalidateAnnotations(filter);
+        blocks_.invalidateIf(filter);
+    }
+
+    /**
+     * \brief Record the opcodes decoded in the current context from now on, for saveWarmCache()
+     */
+    void recordOpcodes(bool enable = true) { dtrie_->enableOpcodeRecording(enable); }
+
+    // Identifies the current context's decode table in warm cache files
+    uint64_t getContextFingerprint() const { return dtrie_->getFingerprint(); }
+
+    /**
+     * \brief Save the opcodes recorded in the current context (see recordOpcodes) to path, in the
+     * format of mavis/WarmCacheFile.hpp
+     */
+    void saveWarmCache(const std::string & path) const
+    {
+        mavis::WarmCacheFile::write(path, dtrie_->getFingerprint(), dtrie_->getRecordedOpcodes());
+    }
+
+    /**
+     * \brief Decode the opcodes saved by saveWarmCache() (in a previous run) into the current
+     * context's caches, before the run starts
+     *
+     * The leaf factories keep what they decode (up to their stash sizes); the direct-mapped
+     * front-end caches keep the last opcodes of each line. Opcodes that no longer decode are
+     * skipped. Throws StaleWarmCacheFile if the file was saved from another decode table.
+     * \param args Passed to the InstType constructor, as for makeInst()
+     * \return Number of opcodes decoded
+     */
+    template <typename... ArgTypes>
+    size_t loadWarmCache(const std::string & path, ArgTypes &&... args)
+    {
+        size_t decoded = 0;
+        for (const Opcode icode : mavis::WarmCacheFile::read(path, dtrie_->getFingerprint()))
+        {
+            try
+            {
+                dtrie_->makeInst(icode, inst_allocator_, args...);
+                getOpcodeClass(icode);
+                ++decoded;
+            }
+            catch (const mavis::BaseException &)
+            {
+            }
+        }
+        return decoded;
+    }
+
+    /**
+     * \brief Decode all the instructions of some text into the current context's caches (e.g.
+     * before a timed region), so that the run does not start cold
+     *
+     * The text of each region is swept linearly from its start, respecting RVC lengths. Its
+     * distinct opcodes are collected by options.threads threads, and then decoded on this one
+     * (the decode tables are not thread safe); opcodes that do not decode are negatively
+     * cached. With options.blocks, the blocks along the sweep are decoded into the block cache
+     * too: the threads find where the blocks start, in the spans of the opcode sweep, from the
+     * opcodes' classes, and this thread makes the blocks (from the decode cache, now warm). See
+     * mavis/ELFText.hpp for the code of an ELF file.
+     * \param args Passed to the InstType constructor, as for makeInst()
+     */
+    template <typename... ArgTypes>
+    mavis::PrewarmStats prewarm(const std::vector<mavis::TextRegion> & regions,
+                                const mavis::PrewarmOptions & options, ArgTypes &&... args)
+    {
+        using mavis::TextScanner;
+
+        mavis::PrewarmStats stats;
+        std::vector<mavis::TextSpan> spans;
+        std::unordered_map<Opcode, bool> ends_block; // Of the opcodes that decode
+        for (const Opcode icode : TextScanner::collectOpcodes(
+                 regions, options.threads, options.chunk_bytes, stats.insts, &spans))
+        {
+            try
+            {
+                dtrie_->makeInst(icode, inst_allocator_, args...);
+                ends_block.emplace(icode, endsBlock_(getOpcodeClass(icode)));
+                ++stats.opcodes;
+            }
+            catch (const mavis::BaseException &)
+            {
+                ++stats.illegal;
+            }
+        }
+        if (!options.blocks)
+        {
+            return stats;
+        }
+
+        // A block starts at the start of a region, and after a control flow instruction or an
+        // undecodable opcode (it ends at the next one, or at MAX_BLOCK_INSTS instructions)
+        std::vector<std::vector<uint64_t>> starts(spans.size());
+        TextScanner::parallelFor(
+            spans.size(), options.threads,
+            [&spans, &ends_block, &starts](const size_t s)
+            {
+                const mavis::TextSpan & span = spans[s];
+                if (span.begin == 0)
+                {
+                    starts[s].push_back(0);
+                }
+                for (uint64_t off = span.begin; off < span.end;)
+                {
+                    const Opcode icode = TextScanner::fetch(*span.region, off);
+                    off += TextScanner::instLength(static_cast<uint16_t>(icode));
+                    const auto iter = ends_block.find(icode);
+                    if ((iter == ends_block.end()) || iter->second)
+                    {
+                        starts[s].push_back(off);
+                    }
+                }
+            });
+
+        for (size_t s = 0; s < spans.size(); ++s)
+        {
+            const mavis::TextRegion & region = *spans[s].region;
+            const auto fetch = [&region](uint64_t addr) -> uint32_t
+            { return TextScanner::fetch(region, addr - region.address); };
+            for (uint64_t off : starts[s])
+            {
+                // A start at an undecodable opcode is not a block (the next one starts one)
+                try
+                {
+                    while ((off + 2) <= region.size)
+                    {
+                        const BlockType & block = getBlock(region.address + off, fetch, args...);
+                        ++stats.blocks;
+                        off += block.fall_through_offset;
+                        if (block.ends_in_control_flow
+                            || (block.insts.size() < BlockCacheType::MAX_BLOCK_INSTS))
+                        {
+                            break;
+                        }
+                    }
+                }
+                catch (const mavis::BaseException &)
+                {
+                }
+            }
+        }
+        return stats;
+    }
+
+    // Text in a buffer, at address
+    template <typename... ArgTypes>
+    mavis::PrewarmStats prewarm(const uint8_t* text, uint64_t size, uint64_t address,
+                                const mavis::PrewarmOptions & options, ArgTypes &&... args)
+    {
+        return prewarm(std::vector<mavis::TextRegion>{{text, size, address}}, options, args...);
+    }
+
+    /**
+     * \brief Mix of the instructions decoded by makeInst() and getInfo() since construction
+     * (or resetInstMix()), with Mavis instantiated with mavis::InstMixEnabled
+     *
+     * Each call is counted by UID, in any context; compressed instructions count as their
+     * expansions, which share their UIDs. Decodes that only fill caches (prewarm,
+     * loadWarmCache, getBlock) are not counted. Mixes of per-thread decoders are combined
+     * with InstMix::merge.
+     */
+    mavis::InstMix getInstMix() const
+    {
+        static_assert(InstMixPolicy::enabled,
+                      "Counting instructions needs a Mavis instantiated with mavis::InstMixEnabled");
+        mavis::InstMix mix;
+        const auto & counts = inst_mix_.getCounts();
+        for (mavis::InstructionUniqueID uid = 0; uid < counts.size(); ++uid)
+        {
+            if (counts[uid] != 0)
+            {
+                mix.add(makeInstMixEntry_(uid, counts[uid]));
+            }
+        }
+        return mix;
+    }
+
+    void resetInstMix() { inst_mix_.reset(); }
 
   private:
     InstTypeAllocator inst_allocator_;
@@ -288,10 +775,122 @@ class Mavis
     typename mavis::PseudoBuilder<InstType, AnnotationType, AnnotationTypeAllocator>::PtrType
         pseudo_builder_;
     typename mavis::DTable<InstType, AnnotationType, AnnotationTypeAllocator>::PtrType dtrie_;
+    mavis::Symbol context_name_;
+    BlockCacheType blocks_;
+    mavis::InstMixHistogram inst_mix_;
 
   private:
     void print(std::ostream & os) const { os << *dtrie_; }
 
+    void invalidate_(const mavis::CacheFilter & filter)
+    {
+        dtrie_->invalidate(filter);
+        blocks_.invalidateIf(filter);
+    }
+
+    // Resolve uid in the current context, or else in the first other built context that has it
+    mavis::InstMix::Entry makeInstMixEntry_(const mavis::InstructionUniqueID uid,
+                                            const uint64_t count) const
+    {
+        using DTableType = mavis::DTable<InstType, AnnotationType, AnnotationTypeAllocator>;
+
+        mavis::InstMix::Entry entry;
+        entry.uid = uid;
+        entry.count = count;
+
+        std::vector<const DTableType*> dtables{dtrie_.get()};
+        for (const mavis::ContextHandle ctx : context_.getBuiltContexts())
+        {
+            dtables.push_back(&context_.getDTable(ctx));
+        }
+        for (const DTableType* dtable : dtables)
+        {
+            try
+            {
+                const auto prepared = dtable->prepareInstDirectly(uid);
+                entry.mnemonic = prepared.mnemonic.str();
+                entry.inst_types = prepared.meta->getInstType();
+                entry.isa = prepared.meta->getISA();
+                const auto tags = prepared.meta->getTags();
+                entry.tags.assign(tags.getS().begin(), tags.getS().end());
+                return entry;
+            }
+            catch (const std::exception &)
+            {
+                // Not an instruction of this context (UID lookups throw UnassignedIndex)
+            }
+        }
+        entry.mnemonic = "uid:" + std::to_string(uid);
+        return entry;
+    }
+
+    mavis::InstructionUniqueID lookupUID_(const std::string & mnemonic) const
+    {
+        const mavis::InstructionUniqueID uid = lookupInstructionUniqueID(mnemonic);
+        if (uid == mavis::INVALID_UID)
+        {
+            throw mavis::UnknownMnemonic(mnemonic);
+        }
+        return uid;
+    }
+
+    // Whether an instruction ends a block (see getBlock)
+    static bool endsBlock_(const mavis::OpcodeClass & oclass)
+    {
+        using InstructionTypes = mavis::InstMetaData::InstructionTypes;
+        return oclass.isInstType(InstructionTypes::BRANCH)
+               || oclass.isInstType(InstructionTypes::SYSTEM);
+    }
+
+    template <typename FetchFunc, typename... ArgTypes>
+    BlockType decodeBlock_(const uint64_t pc, FetchFunc & fetch, ArgTypes &... args)
+    {
+        using InstructionTypes = mavis::InstMetaData::InstructionTypes;
+
+        BlockType block;
+        block.pc = pc;
+        while (block.insts.size() < BlockCacheType::MAX_BLOCK_INSTS)
+        {
+            const uint64_t offset = block.fall_through_offset;
+            const uint32_t word = fetch(pc + offset);
+            const uint32_t size = ((word & 0x3) == 0x3) ? 4 : 2;
+            const Opcode icode = (size == 4) ? word : (word & 0xffff);
+
+            // An undecodable opcode ends the block (its own fetch reports the error)
+            typename InstType::PtrType inst;
+            try
+            {
+                inst = dtrie_->makeInst(icode, inst_allocator_, args...);
+            }
+            catch (const mavis::BaseException &)
+            {
+                if (block.insts.empty())
+                {
+                    throw;
+                }
+                break;
+            }
+            const mavis::OpcodeClass & oclass = getOpcodeClass(icode);
+            block.insts.push_back({inst, icode, static_cast<uint32_t>(offset), size, oclass.uid});
+            block.fall_through_offset += size;
+
+            if (endsBlock_(oclass))
+            {
+                block.ends_in_control_flow = true;
+                block.has_target = !oclass.isInstType(InstructionTypes::JALR)
+                                   && !oclass.isExtractedInstType(ExtractedInstType::INDIRECT)
+                                   && !oclass.isInstType(InstructionTypes::SYSTEM);
+                if (block.has_target)
+                {
+                    block.target_offset = static_cast<int64_t>(offset)
+                                          + dtrie_->getInfo(icode)->opinfo->getSignedOffset();
+                }
+                break;
+            }
+        }
+        return block;
+    }
+
   public:
     friend std::ostream & operator<<(std::ostream & os, const Mavis & facade)
     {
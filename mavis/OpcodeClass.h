@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "DecoderTypes.h"
+#include "DecoderConsts.h"
+#include "DecodedInstInfo.h"
+#include "InstMetaData.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Compact classification of an opcode: its UID and type bits
+     *
+     * This is what front-end models ask for most (is it a branch/load/store/call, and which
+     * instruction is it). DTable::getOpcodeClass() answers from a direct-mapped table of these,
+     * without touching the OpcodeInfo/DecodedInstructionInfo of the opcode or allocating
+     * instructions.
+     */
+    struct OpcodeClass
+    {
+        using InstructionTypes = InstMetaData::InstructionTypes;
+        using ExtractedInstTypes = DecodedInstructionInfo::ExtractedInstTypes;
+
+        Opcode icode = 0;
+        InstructionUniqueID uid = INVALID_UID;
+        std::underlying_type_t<InstructionTypes> inst_types = 0;
+        std::underlying_type_t<ExtractedInstTypes> ext_inst_types = 0;
+
+        bool isInstType(InstructionTypes itype) const
+        {
+            const auto bits = static_cast<std::underlying_type_t<InstructionTypes>>(itype);
+            return (inst_types & bits) == bits;
+        }
+
+        bool isExtractedInstType(ExtractedInstTypes itype) const
+        {
+            const auto bits = static_cast<std::underlying_type_t<ExtractedInstTypes>>(itype);
+            return (ext_inst_types & bits) == bits;
+        }
+    };
+
+} // namespace mavis
@@ -48,6 +48,23 @@ namespace mavis
             // return extractor_->dasmString(getMnemonic(), icode_, meta_);
         }
 
+        /**
+         * \brief Disassemble into buf (NUL terminated, truncated if cap is too small) without
+         * allocating
+         * \return Length of the complete disassembly, as with snprintf
+         */
+        size_t dasmTo(char* buf, const size_t cap) const
+        {
+            DasmWriter os(buf, cap);
+            dasmTo(os);
+            return os.required();
+        }
+
+        void dasmTo(DasmWriter & os) const
+        {
+            dasm_->toBuffer(os, getMnemonic(), icode_, meta_, extractor_);
+        }
+
         bool isHint() const { return info_->is_hint; }
 
         ImmediateType getImmediateType() const { return info_->immediate_type; }
@@ -66,7 +83,7 @@ namespace mavis
 
         const OperandInfo::ElementList & getSourceOpInfoList() const
         {
-            return info_->source_opinfo_list;
+            return info_->source_opinfo.getElements();
         }
 
         DecodedInstructionInfo::BitMask getIntSourceRegs() const { return info_->int_sources; }
@@ -136,7 +153,7 @@ namespace mavis
 
         const OperandInfo::ElementList & getDestOpInfoList() const
         {
-            return info_->dest_opinfo_list;
+            return info_->dest_opinfo.getElements();
         }
 
         DecodedInstructionInfo::BitMask getIntDestRegs() const { return info_->int_dests; }
@@ -237,6 +254,8 @@ namespace mavis
             return info_->isExtInstType(itype);
         }
 
+        uint64_t getExtractedInstTypes() const { return info_->ext_itype; }
+
         std::underlying_type_t<ISAExtension> getISA() const { return meta_->getISA(); }
 
         bool isISA(ISAExtension isa) const { return meta_->isISA(isa); }
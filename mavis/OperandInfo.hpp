@@ -1,10 +1,10 @@
 #pragma once
 
-#include <vector>
 #include <array>
 #include <cinttypes>
 
 #include "InstMetaData.h"
+#include "InlineVector.hpp"
 
 namespace mavis {
 
@@ -36,7 +36,11 @@ public:
         Element& operator=(const Element&) = default;
     };
 
-    typedef std::vector<Element> ElementList;
+    // Operands kept inline: the most of any encoded instruction (cm.push/cm.popret: sp plus up
+    // to 13 registers). Longer lists, e.g. from a wide register mask, spill to the heap.
+    static constexpr uint32_t MAX_OPERANDS = 16;
+
+    typedef InlineVector<Element, MAX_OPERANDS> ElementList;
 
 private:
     ElementList     elems_;
@@ -20,6 +20,8 @@ using json_object = boost::json::object;
 #include <vector>
 #include <string>
 #include <iostream>
+#include <sstream>
+#include <typeinfo>
 
 namespace mavis {
 
@@ -103,6 +105,24 @@ public:
 
     uint32_t getNumMaskBits() const { return n_match_mask_bits_; }
 
+    // Replace the metadata with an equal, shared one (see DecodeNodePool)
+    template<typename ShareFuncType>
+    void shareMetaData(const ShareFuncType& share)
+    {
+        meta_ = share(mnemonic_, meta_);
+    }
+
+    // Everything that decides what the overlay makes (see DecodeNodePool). The metadata and
+    // annotation are compared by identity, so their owners must have been shared first
+    void appendSignature(std::string& sig) const
+    {
+        std::ostringstream ss;
+        ss << mnemonic_ << '\0' << base_mnemonic_ << '\0' << std::hex << match_mask_ << '\0'
+           << match_value_ << '\0' << uid_ << '\0' << xform_extractor_.get() << '\0'
+           << meta_.get() << '\0' << anno_.get() << '\0' << typeid(*dasm_).name() << '\0';
+        sig += ss.str();
+    }
+
     void print(std::ostream& os) const
     {
         std::ios_base::fmtflags os_state(os.flags());
@@ -1,15 +1,23 @@
 #pragma once
 
 #include <regex>
+#include <string>
 
 namespace mavis {
 
 class Pattern
 {
 public:
+    // Patterns without regex metacharacters (the common case, e.g. "pf") are matched by string
+    // compare and never build a std::regex
     explicit Pattern(const std::string& p):
-        p_string_(p), is_empty_(p.empty()), p_rex_(p, std::regex::optimize)
-    {}
+        p_string_(p), is_empty_(p.empty()),
+        is_literal_(p.find_first_of(".[]{}()\\*+?^$|") == std::string::npos)
+    {
+        if (!is_literal_) {
+            p_rex_ = std::regex(p, std::regex::optimize);
+        }
+    }
     Pattern(const Pattern&) = default;
     Pattern& operator=(const Pattern&) = default;
 
@@ -18,14 +26,28 @@ public:
         return is_empty_;
     }
 
+    bool isLiteral() const
+    {
+        return is_literal_;
+    }
+
+    const std::string& getString() const
+    {
+        return p_string_;
+    }
+
     bool match(const std::string& s) const
     {
+        if (is_literal_) {
+            return s == p_string_;
+        }
         return std::regex_match(s, p_rex_, std::regex_constants::match_any);
     }
 
 private:
     std::string   p_string_;
     bool          is_empty_;
+    bool          is_literal_;
     std::regex    p_rex_;
 };
-} // namespace mavis
\ No newline at end of file
+} // namespace mavis
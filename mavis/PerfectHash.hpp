@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mavis
+{
+
+    /**
+     * \brief Read-only perfect hash index over the string keys of an existing map
+     *
+     * Built once by hash-and-displace: keys are bucketed by one hash, and each bucket (largest
+     * first) is given the seed of a second hash that puts all of its keys into free slots. A
+     * lookup is then two hashes and a single key compare. The index points at the map's values,
+     * so it stays valid as long as no entries are erased from the map; keys added after build()
+     * are not in the index, and callers fall back to the map for them.
+     */
+    template <typename ValueType> class PerfectHashIndex
+    {
+      public:
+        template <typename MapType> void build(const MapType & map)
+        {
+            clear();
+            if (map.empty())
+            {
+                return;
+            }
+
+            std::vector<std::string_view> keys;
+            std::vector<const ValueType*> values;
+            for (const auto & [key, value] : map)
+            {
+                keys.emplace_back(key);
+                values.emplace_back(&value);
+            }
+
+            const size_t n = keys.size();
+            const size_t n_buckets = std::max<size_t>(1, n / 4);
+            size_t n_slots = n + (n / 4) + 1;
+            while (!place_(keys, values, n_buckets, n_slots))
+            {
+                n_slots += (n / 8) + 1;
+            }
+        }
+
+        void clear()
+        {
+            displacements_.clear();
+            keys_.clear();
+            values_.clear();
+        }
+
+        bool isBuilt() const { return !keys_.empty(); }
+
+        // Value for key, or nullptr if key was not in the map when the index was built
+        const ValueType* find(const std::string_view key) const
+        {
+            if (keys_.empty())
+            {
+                return nullptr;
+            }
+            const uint32_t d = displacements_[hash_(0, key) % displacements_.size()];
+            const size_t slot = hash_(d, key) % keys_.size();
+            return ((values_[slot] != nullptr) && (keys_[slot] == key)) ? values_[slot] : nullptr;
+        }
+
+      private:
+        static constexpr uint32_t MAX_SEED = 1u << 16;
+
+        std::vector<uint32_t> displacements_;
+        std::vector<std::string> keys_;
+        std::vector<const ValueType*> values_;
+
+        // Seeded FNV-1a, with a final avalanche so that the low bits are usable as a slot index
+        static uint64_t hash_(const uint64_t seed, const std::string_view key)
+        {
+            uint64_t h = 14695981039346656037ull ^ (seed * 0x9e3779b97f4a7c15ull);
+            for (const char c : key)
+            {
+                h ^= static_cast<uint8_t>(c);
+                h *= 1099511628211ull;
+            }
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+            return h;
+        }
+
+        bool place_(const std::vector<std::string_view> & keys,
+                    const std::vector<const ValueType*> & values, const size_t n_buckets,
+                    const size_t n_slots)
+        {
+            std::vector<std::vector<size_t>> buckets(n_buckets);
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                buckets[hash_(0, keys[i]) % n_buckets].push_back(i);
+            }
+            std::vector<size_t> order(n_buckets);
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&buckets](const size_t a, const size_t b)
+                      { return buckets[a].size() > buckets[b].size(); });
+
+            displacements_.assign(n_buckets, 0);
+            keys_.assign(n_slots, std::string());
+            values_.assign(n_slots, nullptr);
+            std::vector<bool> used(n_slots, false);
+            std::vector<size_t> slots;
+            for (const size_t b : order)
+            {
+                if (buckets[b].empty())
+                {
+                    break;
+                }
+                bool placed = false;
+                for (uint32_t d = 1; !placed && (d < MAX_SEED); ++d)
+                {
+                    slots.clear();
+                    placed = true;
+                    for (const size_t i : buckets[b])
+                    {
+                        const size_t slot = hash_(d, keys[i]) % n_slots;
+                        if (used[slot] || (std::find(slots.begin(), slots.end(), slot) != slots.end()))
+                        {
+                            placed = false;
+                            break;
+                        }
+                        slots.push_back(slot);
+                    }
+                    if (placed)
+                    {
+                        displacements_[b] = d;
+                        for (size_t j = 0; j < slots.size(); ++j)
+                        {
+                            used[slots[j]] = true;
+                            keys_[slots[j]] = std::string(keys[buckets[b][j]]);
+                            values_[slots[j]] = values[buckets[b][j]];
+                        }
+                    }
+                }
+                if (!placed)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+} // namespace mavis
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "DecoderTypes.h"
+#include "DecodedInstInfo.h"
+#include "Symbol.hpp"
+#include "OpcodeInfo.h"
+#include "ExtractorDirectInfo.h"
+#include "ExtractorWrap.hpp"
+#include "FormGeneric.hpp"
+#include "RecyclingAllocator.hpp"
+
+namespace mavis
+{
+
+    /**
+     * \brief Everything needed to create an instruction directly (no opcode), resolved once
+     *
+     * Returned by DTable::prepareInstDirectly() and Mavis::preparePseudoInst(). Creating an
+     * instruction from a prepared handle only extracts the operands of the ExtractorDirectInfo:
+     * the factory, UID, meta data, disassembler and annotation lookups (and the interning of the
+     * mnemonic) are done when the handle is prepared. The extractor copy and the decoded info
+     * come from per-thread free lists (RecyclingAllocator), so steady-state creation does not
+     * call operator new for them.
+     *
+     * A handle belongs to the context it was prepared in. Prepare pseudo instruction handles after
+     * any Mavis::setPseudoInstDisassembler() call for them.
+     */
+    template <typename AnnotationType> struct PreparedInst
+    {
+        Symbol mnemonic;
+        InstructionUniqueID uid = INVALID_UID;
+        InstMetaData::PtrType meta;
+        DisassemblerIF::PtrType dasm;
+        typename AnnotationType::PtrType anno;
+        FormGeneric::PtrType form; // Pseudo instructions only: their operands are wrapped
+
+        OpcodeInfo::PtrType makeOpcodeInfo(const ExtractorDirectInfoIF & ex_info) const
+        {
+            ExtractorIF::PtrType extractor = ex_info.clone();
+            if (form != nullptr)
+            {
+                extractor = makeRecycled<ExtractorWrap>(extractor, form);
+            }
+            return makeOpcodeInfo(extractor, Opcode(0));
+        }
+
+        // Operands from extractor (e.g. a trace record's), reported against icode
+        OpcodeInfo::PtrType makeOpcodeInfo(const ExtractorIF::PtrType & extractor,
+                                           const Opcode icode) const
+        {
+            const auto dii =
+                makeRecycled<DecodedInstructionInfo>(mnemonic, uid, extractor, meta, icode);
+            return makeRecycled<OpcodeInfo>(icode, dii, extractor, meta, dasm);
+        }
+    };
+
+} // namespace mavis
@@ -38,34 +38,32 @@ public:
         FactoryBuilderBase<FactoryType,InstType,AnnotationType,AnnotationTypeAllocator>(anno_files, annotation_allocator, uid_list)
     {}
 
+    // Construct with an existing (possibly shared) annotation registry
+    explicit PseudoBuilder(const typename FactoryBuilderBase<FactoryType,InstType,AnnotationType,AnnotationTypeAllocator>::AnnotationRegistryType::PtrType& anno_registry,
+                           const InstUIDList& uid_list = {}) :
+        FactoryBuilderBase<FactoryType,InstType,AnnotationType,AnnotationTypeAllocator>(anno_registry, uid_list)
+    {}
+
     PseudoBuilder(const PseudoBuilder&) = delete;
 
     void configure(const FileNameListType &isa_files)
     {
-        for (const auto &jfile : isa_files) {
-            const json_value json = parseJSONWithException<BadISAFile>(jfile);
-            #ifdef USE_NLOHMANN_JSON
-            const auto& jobj = json;
-            #else
-            const auto& jobj = json.as_array();
-            #endif
-            for (const auto &inst_value : jobj) {
-                #ifdef USE_NLOHMANN_JSON
-                const auto& inst = inst_value;
-                if (inst.contains("pseudo")) {
-                    std::string mnemonic = inst["pseudo"].get<std::string>();
-                #else
-                const auto& inst = inst_value.as_object();
-                if (const auto it = inst.find("pseudo"); it != inst.end()) {
-                    std::string mnemonic = boost::json::value_to<std::string>(it->value());
-                #endif
-                    InstMetaData::PtrType meta = this->makeInstMetaData(mnemonic, inst);
-                    Disassembler::PtrType dasm = std::make_shared<Disassembler>();
-                    FormGeneric::PtrType form = std::make_shared<FormGeneric>(inst, meta);
-                    build_(mnemonic, meta, dasm, form);
-                }
-            }
+        // Stream the ISA files an instruction at a time (no document is built)
+        for (const auto &isa_file : isa_files) {
+            forEachJSONArrayElementWithException<BadISAFile>(isa_file,
+                [this](const json_value &inst_value) { configureInst_(inst_value); });
         }
+        this->freezeLookups();
+    }
+
+    // Configure from ISA file entries gathered elsewhere (e.g. by the context's DTable, while
+    // streaming the same files)
+    void configureInsts(const std::vector<json_value> &insts)
+    {
+        for (const auto &inst_value : insts) {
+            configureInst_(inst_value);
+        }
+        this->freezeLookups();
     }
 
     void setDisassembler(const InstructionUniqueID uid, const DisassemblerIF::PtrType& dasm)
@@ -79,6 +77,24 @@ public:
     }
 
 private:
+    void configureInst_(const json_value &inst_value)
+    {
+        #ifdef USE_NLOHMANN_JSON
+        const auto& inst = inst_value;
+        if (inst.contains("pseudo")) {
+            std::string mnemonic = inst["pseudo"].get<std::string>();
+        #else
+        const auto& inst = inst_value.as_object();
+        if (const auto it = inst.find("pseudo"); it != inst.end()) {
+            std::string mnemonic = boost::json::value_to<std::string>(it->value());
+        #endif
+            InstMetaData::PtrType meta = this->makeInstMetaData(mnemonic, inst);
+            Disassembler::PtrType dasm = std::make_shared<Disassembler>();
+            FormGeneric::PtrType form = std::make_shared<FormGeneric>(inst, meta);
+            build_(mnemonic, meta, dasm, form);
+        }
+    }
+
     typename IFactoryIF<InstType, AnnotationType>::PtrType build_(const std::string& mnemonic,
                                                                   const InstMetaData::PtrType& meta,
                                                                   const DisassemblerIF::PtrType& dasm,
@@ -88,8 +104,7 @@ private:
 
         if (ifact == nullptr) {
             const InstructionUniqueID inst_uid = this->registerInst(mnemonic);
-            typename AnnotationType::PtrType panno = this->findAnnotation(mnemonic);
-            ifact.reset(new FactoryType(mnemonic, inst_uid, meta, dasm, form, panno));
+            ifact.reset(new FactoryType(mnemonic, inst_uid, meta, dasm, form, this->getAnnotationLookup()));
             registry_[mnemonic] = ifact;
         }
 
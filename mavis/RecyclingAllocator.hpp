@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace mavis
+{
+
+    /**
+     * \brief Allocator that keeps freed single objects on a per-thread free list, and hands them
+     * out again before asking operator new
+     *
+     * Used (through makeRecycled) for the objects made on every direct (prepared) instruction
+     * creation, which are freed about as fast as they are made: the steady state allocates
+     * nothing. Each allocated type (for allocate_shared, each control block type) has its own
+     * list. An object may be freed on a thread other than the one that made it; it then joins
+     * that thread's list. A list keeps at most MAX_FREE objects, and is released when its thread
+     * exits.
+     */
+    template <typename T> class RecyclingAllocator
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                      "RecyclingAllocator storage comes from the default operator new");
+
+      public:
+        using value_type = T;
+
+        static constexpr size_t MAX_FREE = 1024;
+
+        RecyclingAllocator() = default;
+
+        template <typename U> RecyclingAllocator(const RecyclingAllocator<U> &) {}
+
+        T* allocate(const size_t n)
+        {
+            FreeList & list = freeList_();
+            if ((n == 1) && (list.head != nullptr))
+            {
+                Node* node = list.head;
+                list.head = node->next;
+                --list.size;
+                return reinterpret_cast<T*>(node);
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, const size_t n)
+        {
+            FreeList & list = freeList_();
+            if ((n == 1) && (list.size < MAX_FREE))
+            {
+                list.head = ::new (static_cast<void*>(p)) Node{list.head};
+                ++list.size;
+                return;
+            }
+            ::operator delete(p);
+        }
+
+        template <typename U> bool operator==(const RecyclingAllocator<U> &) const { return true; }
+
+        template <typename U> bool operator!=(const RecyclingAllocator<U> &) const { return false; }
+
+      private:
+        struct Node
+        {
+            Node* next;
+        };
+        static_assert(sizeof(T) >= sizeof(Node), "RecyclingAllocator objects hold a list link");
+
+        // Trivially destructible, so that it stays usable by objects freed late in thread exit
+        struct FreeList
+        {
+            Node* head = nullptr;
+            size_t size = 0;
+        };
+
+        // Releases the list at thread exit, and sends later frees to operator delete
+        struct Releaser
+        {
+            FreeList & list;
+
+            ~Releaser()
+            {
+                while (list.head != nullptr)
+                {
+                    Node* next = list.head->next;
+                    ::operator delete(list.head);
+                    list.head = next;
+                }
+                list.size = MAX_FREE;
+            }
+        };
+
+        static FreeList & freeList_()
+        {
+            static thread_local FreeList list;
+            static thread_local Releaser releaser{list};
+            return list;
+        }
+    };
+
+    // std::make_shared, with the object (and its control block) from a RecyclingAllocator
+    template <typename T, typename... ArgTypes> std::shared_ptr<T> makeRecycled(ArgTypes &&... args)
+    {
+        return std::allocate_shared<T>(RecyclingAllocator<T>(), std::forward<ArgTypes>(args)...);
+    }
+
+} // namespace mavis
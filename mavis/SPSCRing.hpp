@@ -0,0 +1,193 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mavis
+{
+
+    /**
+     * \brief What a producer (consumer) of an SPSCRing does while the ring is full (empty)
+     */
+    enum class WaitPolicy
+    {
+        SPIN,  // Busy-wait: lowest latency, burns a core
+        YIELD, // Busy-wait, yielding the core between polls
+        BLOCK  // Spin briefly, then sleep until the other side makes progress
+    };
+
+    /**
+     * \brief Bounded lock-free ring for exactly one producer thread and one consumer thread
+     *
+     * push/pop never take a lock while the ring is neither full nor empty. With
+     * WaitPolicy::BLOCK, a side that has to wait registers itself and sleeps on a condition
+     * variable; the other side only touches the mutex when someone is sleeping. A full ring is
+     * the backpressure: push waits (or tryPush fails) until the consumer catches up.
+     */
+    template <typename T> class SPSCRing
+    {
+      public:
+        // capacity is rounded up to a power of 2
+        explicit SPSCRing(size_t capacity, WaitPolicy policy = WaitPolicy::BLOCK,
+                          uint32_t spin_count = 1024) :
+            slots_(roundUp_(capacity)),
+            mask_(slots_.size() - 1),
+            policy_(policy),
+            spin_count_(spin_count)
+        {
+        }
+
+        SPSCRing(const SPSCRing &) = delete;
+        SPSCRing & operator=(const SPSCRing &) = delete;
+
+        size_t capacity() const { return slots_.size(); }
+
+        // Producer side
+        bool tryPush(T && value)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            if ((tail - head_.load(std::memory_order_acquire)) == slots_.size())
+            {
+                return false;
+            }
+            slots_[tail & mask_] = std::move(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            wake_();
+            return true;
+        }
+
+        // Producer side: false if the ring was closed
+        bool push(T && value)
+        {
+            for (uint32_t polls = 0; !closed_.load(std::memory_order_acquire); ++polls)
+            {
+                if (tryPush(std::move(value)))
+                {
+                    return true;
+                }
+                wait_(polls, [this]
+                      {
+                          return closed_.load(std::memory_order_acquire)
+                                 || ((tail_.load(std::memory_order_relaxed)
+                                      - head_.load(std::memory_order_acquire))
+                                     < slots_.size());
+                      });
+            }
+            return false;
+        }
+
+        // Consumer side
+        bool tryPop(T & value)
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            value = std::move(slots_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            wake_();
+            return true;
+        }
+
+        // Consumer side: false once the ring is closed and empty
+        bool pop(T & value)
+        {
+            for (uint32_t polls = 0;; ++polls)
+            {
+                if (tryPop(value))
+                {
+                    return true;
+                }
+                if (closed_.load(std::memory_order_acquire))
+                {
+                    // Elements pushed before close() are still delivered
+                    return tryPop(value);
+                }
+                wait_(polls, [this]
+                      {
+                          return closed_.load(std::memory_order_acquire)
+                                 || (head_.load(std::memory_order_relaxed)
+                                     != tail_.load(std::memory_order_acquire));
+                      });
+            }
+        }
+
+        // No more pushes: pop drains what is left, then fails
+        void close()
+        {
+            closed_.store(true, std::memory_order_release);
+            wake_();
+        }
+
+        bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+      private:
+        static size_t roundUp_(const size_t capacity)
+        {
+            size_t size = 1;
+            while (size < capacity)
+            {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        template <typename ReadyFunc> void wait_(const uint32_t polls, const ReadyFunc & ready)
+        {
+            if ((policy_ == WaitPolicy::SPIN)
+                || ((policy_ == WaitPolicy::BLOCK) && (polls < spin_count_)))
+            {
+                return;
+            }
+            if (policy_ == WaitPolicy::YIELD)
+            {
+                std::this_thread::yield();
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cond_.wait(lock, ready);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void wake_()
+        {
+            if (policy_ != WaitPolicy::BLOCK)
+            {
+                return;
+            }
+            // Pairs with the registration in wait_(): either the sleeper sees the update, or
+            // this sees the sleeper
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleepers_.load(std::memory_order_relaxed) != 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                cond_.notify_all();
+            }
+        }
+
+        std::vector<T> slots_;
+        const size_t mask_;
+        const WaitPolicy policy_;
+        const uint32_t spin_count_;
+
+        // Each index is written by one side only; kept on separate cache lines
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+        alignas(64) std::atomic<bool> closed_{false};
+
+        std::atomic<uint32_t> sleepers_{0};
+        std::mutex mutex_;
+        std::condition_variable cond_;
+    };
+
+} // namespace mavis
@@ -98,6 +98,30 @@ public:
         }
     }
 
+    /**
+     * \brief Remove the KVP's for which pred(key, value) is true
+     * \param pred
+     */
+    template<typename Predicate>
+    void eraseIf(const Predicate& pred)
+    {
+        if (mru_.valid && pred(mru_.key, mru_.value)) {
+            mru_ = Node();
+        }
+        for (auto& node : hash_) {
+            if (node.valid && pred(node.key, node.value)) {
+                node = Node();
+            }
+        }
+        for (auto iter = map_.begin(); iter != map_.end();) {
+            if (pred(iter->second.key, iter->second.value)) {
+                iter = map_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
 private:
     std::string name_;
     Node mru_;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mavis
+{
+
+    /**
+     * \brief Interned string (used for instruction mnemonics)
+     *
+     * Each distinct string is stored once, process-wide, and never freed, so a Symbol is a single
+     * pointer: copying one is free, two Symbols compare by pointer, and the string a Symbol refers
+     * to outlives every context (and every instruction) that uses it.
+     */
+    class Symbol
+    {
+      public:
+        Symbol() : str_(&intern_(std::string_view())) {}
+
+        explicit Symbol(const std::string_view s) : str_(&intern_(s)) {}
+
+        const std::string & str() const { return *str_; }
+
+        std::string_view view() const { return *str_; }
+
+        operator const std::string &() const { return *str_; }
+
+        bool operator==(const Symbol & other) const { return str_ == other.str_; }
+
+        bool operator!=(const Symbol & other) const { return str_ != other.str_; }
+
+        bool operator==(const std::string_view s) const { return *str_ == s; }
+
+        bool operator!=(const std::string_view s) const { return *str_ != s; }
+
+      private:
+        const std::string* str_;
+
+        static const std::string & intern_(const std::string_view s)
+        {
+            static std::shared_mutex mutex;
+            // Keys view the (heap allocated, hence address stable) interned strings
+            static std::unordered_map<std::string_view, std::unique_ptr<const std::string>> table;
+
+            {
+                std::shared_lock<std::shared_mutex> lock(mutex);
+                const auto iter = table.find(s);
+                if (iter != table.end())
+                {
+                    return *iter->second;
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto iter = table.find(s);
+            if (iter == table.end())
+            {
+                auto str = std::make_unique<const std::string>(s);
+                const std::string_view key = *str;
+                iter = table.emplace(key, std::move(str)).first;
+            }
+            return *iter->second;
+        }
+    };
+
+    inline std::ostream & operator<<(std::ostream & os, const Symbol & sym) { return os << sym.str(); }
+
+} // namespace mavis
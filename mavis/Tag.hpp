@@ -1,14 +1,78 @@
 #pragma once
 
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "Pattern.hpp"
 
 namespace mavis {
 
+/**
+ * \brief Process-wide interning of tag strings to dense integer IDs
+ *
+ * IDs are handed out in order of first appearance and never recycled, so they can be used to
+ * index bitsets over the tag universe (see TagFilter)
+ */
+class TagRegistry
+{
+public:
+    static uint32_t intern(const std::string& t)
+    {
+        std::lock_guard<std::mutex> lock(mutex_());
+        auto& ids = ids_();
+        const auto itr = ids.find(t);
+        if (itr != ids.end()) {
+            return itr->second;
+        }
+        const uint32_t id = static_cast<uint32_t>(names_().size());
+        names_().push_back(t);
+        ids.emplace(t, id);
+        return id;
+    }
+
+    static size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_());
+        return names_().size();
+    }
+
+    // Names of the tags with IDs [first, size())
+    static std::vector<std::string> getNames(const size_t first)
+    {
+        std::lock_guard<std::mutex> lock(mutex_());
+        const auto& names = names_();
+        return (first < names.size()) ? std::vector<std::string>(names.begin() + first, names.end())
+                                      : std::vector<std::string>();
+    }
+
+private:
+    static std::mutex& mutex_()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    static std::unordered_map<std::string, uint32_t>& ids_()
+    {
+        static std::unordered_map<std::string, uint32_t> ids;
+        return ids;
+    }
+
+    static std::vector<std::string>& names_()
+    {
+        static std::vector<std::string> names;
+        return names;
+    }
+};
+
 class Tag
 {
 public:
     explicit Tag(const std::string& t):
-        t_string_(t), is_empty_(t.empty())
+        t_string_(t), is_empty_(t.empty()), id_(TagRegistry::intern(t))
     {}
     Tag(const Tag&) = default;
     Tag& operator=(const Tag&) = default;
@@ -18,6 +82,16 @@ public:
         return is_empty_;
     }
 
+    uint32_t getID() const
+    {
+        return id_;
+    }
+
+    const std::string& getString() const
+    {
+        return t_string_;
+    }
+
     bool match(const Pattern& p) const
     {
         return p.match(t_string_);
@@ -26,6 +100,7 @@ public:
 private:
     std::string t_string_;
     bool        is_empty_;
+    uint32_t    id_;
 };
 
 } // namespace mavis
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Tag.hpp"
+#include "Pattern.hpp"
+#include "MatchSet.hpp"
+
+namespace mavis {
+
+/**
+ * \brief Bitset over interned tag IDs (see TagRegistry)
+ */
+class TagBitSet
+{
+public:
+    void set(const uint32_t id)
+    {
+        const size_t w = id / 64;
+        if (w >= words_.size()) {
+            words_.resize(w + 1, 0);
+        }
+        words_[w] |= (1ull << (id % 64));
+    }
+
+    bool test(const uint32_t id) const
+    {
+        const size_t w = id / 64;
+        return (w < words_.size()) && ((words_[w] >> (id % 64)) & 1);
+    }
+
+    bool intersects(const TagBitSet& other) const
+    {
+        const size_t n = std::min(words_.size(), other.words_.size());
+        for (size_t w = 0; w < n; ++w) {
+            if ((words_[w] & other.words_[w]) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        std::fill(words_.begin(), words_.end(), 0);
+    }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * \brief Inclusion/exclusion tag patterns compiled into bitsets over the tag universe
+ *
+ * Each distinct tag is matched against the patterns once (when first seen by this filter), after
+ * which filtering an instruction is a bitwise AND of its tag bits with the inclusion and exclusion
+ * sets. Build one per configuration: the compiled sets grow as new tags are interned.
+ */
+class TagFilter
+{
+public:
+    TagFilter(const MatchSet<Pattern>& inclusions, const MatchSet<Pattern>& exclusions):
+        inclusions_(inclusions), exclusions_(exclusions)
+    {}
+
+    bool hasInclusions() const
+    {
+        return !inclusions_.isEmpty();
+    }
+
+    bool hasExclusions() const
+    {
+        return !exclusions_.isEmpty();
+    }
+
+    bool isEmpty() const
+    {
+        return inclusions_.isEmpty() && exclusions_.isEmpty();
+    }
+
+    // Equivalent to tags.matchAnyAny(inclusions)
+    bool isIncluded(const MatchSet<Tag>& tags)
+    {
+        return tagBits_(tags).intersects(included_);
+    }
+
+    // Equivalent to tags.matchAnyAny(exclusions)
+    bool isExcluded(const MatchSet<Tag>& tags)
+    {
+        return tagBits_(tags).intersects(excluded_);
+    }
+
+private:
+    const TagBitSet& tagBits_(const MatchSet<Tag>& tags)
+    {
+        tag_bits_.clear();
+        for (const auto& t : tags.getV()) {
+            if (t.getID() >= num_compiled_) {
+                compile_();
+            }
+            tag_bits_.set(t.getID());
+        }
+        return tag_bits_;
+    }
+
+    // Match the tags interned since the last compile against the patterns
+    void compile_()
+    {
+        const auto names = TagRegistry::getNames(num_compiled_);
+        for (const auto& name : names) {
+            if (inclusions_.matchAny(name)) {
+                included_.set(num_compiled_);
+            }
+            if (exclusions_.matchAny(name)) {
+                excluded_.set(num_compiled_);
+            }
+            ++num_compiled_;
+        }
+    }
+
+    const MatchSet<Pattern> inclusions_;
+    const MatchSet<Pattern> exclusions_;
+    TagBitSet included_;
+    TagBitSet excluded_;
+    TagBitSet tag_bits_;        // Scratch bits for the instruction being filtered
+    uint32_t  num_compiled_ = 0;
+};
+
+} // namespace mavis
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "DecoderTypes.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Instruction bytes (e.g. an executable section) at an address
+     */
+    struct TextRegion
+    {
+        const uint8_t* data;
+        uint64_t size;
+        uint64_t address;
+    };
+
+    /**
+     * \brief Whole instructions [begin, end) of a region's sweep (offsets into the region)
+     */
+    struct TextSpan
+    {
+        const TextRegion* region;
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    /**
+     * \brief How Mavis::prewarm() scans and decodes text
+     */
+    struct PrewarmOptions
+    {
+        uint32_t threads = 1;             // Scanning threads (decoding stays on the caller's)
+        uint64_t chunk_bytes = 64 * 1024; // Bytes of text per scanning work item
+        bool blocks = true;               // Also fill the block cache (see Mavis::getBlock)
+    };
+
+    struct PrewarmStats
+    {
+        uint64_t insts = 0;   // Instructions scanned
+        uint64_t opcodes = 0; // Distinct opcodes decoded
+        uint64_t illegal = 0; // Distinct opcodes that did not decode (negatively cached)
+        uint64_t blocks = 0;  // Blocks decoded
+    };
+
+    /**
+     * \brief Linear sweep over RISC-V text, from the start of each region, one instruction at a
+     * time (2 bytes for RVC, 4 otherwise)
+     */
+    class TextScanner
+    {
+      public:
+        // RISC-V code is always little endian
+        static uint16_t readU16(const uint8_t* p)
+        {
+            return static_cast<uint16_t>(p[0] | (p[1] << 8));
+        }
+
+        // Length of the instruction whose first halfword is low (RVC unless the low 2 bits are 11)
+        static uint64_t instLength(const uint16_t low) { return ((low & 0x3) == 0x3) ? 4 : 2; }
+
+        /**
+         * \brief Opcode at offset off of region, or 0 (an illegal opcode) if it runs past the end
+         */
+        static Opcode fetch(const TextRegion & region, const uint64_t off)
+        {
+            if ((off + 2) > region.size)
+            {
+                return 0;
+            }
+            const uint16_t low = readU16(region.data + off);
+            if (instLength(low) == 2)
+            {
+                return low;
+            }
+            if ((off + 4) > region.size)
+            {
+                return 0;
+            }
+            return low | (static_cast<Opcode>(readU16(region.data + off + 2)) << 16);
+        }
+
+        /**
+         * \brief Distinct opcodes of the regions, in increasing order
+         *
+         * Regions are cut into chunks at fixed offsets, with no sequential length pre-scan, and
+         * the chunks are scanned by up to num_threads threads. An instruction can straddle a cut,
+         * so the sweep enters a chunk at its start or 2 bytes in: each chunk is scanned from its
+         * start, and the exit of a sweep entering 2 bytes in is found too (the two sweeps
+         * normally meet within a few instructions). The entry of every chunk then follows from
+         * one pass over the chunks, and the chunks entered 2 bytes in are scanned again, also in
+         * parallel.
+         * \param insts Incremented by the number of instructions scanned
+         * \param spans If given, set to the chunks' spans (see splitRegions)
+         */
+        static std::vector<Opcode> collectOpcodes(const std::vector<TextRegion> & regions,
+                                                  const uint32_t num_threads,
+                                                  const uint64_t chunk_bytes, uint64_t & insts,
+                                                  std::vector<TextSpan>* spans = nullptr)
+        {
+            const std::vector<Chunk> chunks = sweep_(regions, num_threads, chunk_bytes, true);
+            std::unordered_set<Opcode> all;
+            for (const Chunk & chunk : chunks)
+            {
+                all.insert(chunk.sweep.icodes.begin(), chunk.sweep.icodes.end());
+                insts += chunk.sweep.insts;
+            }
+            if (spans != nullptr)
+            {
+                *spans = spansOf_(chunks);
+            }
+            std::vector<Opcode> icodes(all.begin(), all.end());
+            std::sort(icodes.begin(), icodes.end());
+            return icodes;
+        }
+
+        /**
+         * \brief The sweep of the regions, as spans of whole instructions of about chunk_bytes
+         *
+         * The spans are found as by collectOpcodes (by up to num_threads threads, with no
+         * sequential pre-scan), without collecting the opcodes. Each region's spans are in
+         * order, and follow each other from its start up to its last whole instruction.
+         */
+        static std::vector<TextSpan> splitRegions(const std::vector<TextRegion> & regions,
+                                                  const uint32_t num_threads,
+                                                  const uint64_t chunk_bytes)
+        {
+            return spansOf_(sweep_(regions, num_threads, chunk_bytes, false));
+        }
+
+        /**
+         * \brief Calls func(i) for each i in [0, n), on up to num_threads threads (the caller's
+         * alone for one)
+         */
+        template <typename FuncType>
+        static void parallelFor(const size_t n, const uint32_t num_threads, const FuncType & func)
+        {
+            std::atomic<size_t> next{0};
+            const auto worker = [&]()
+            {
+                for (size_t i = next++; i < n; i = next++)
+                {
+                    func(i);
+                }
+            };
+
+            const uint32_t n_threads = std::min<uint64_t>(std::max<uint32_t>(num_threads, 1), n);
+            if (n_threads <= 1)
+            {
+                worker();
+                return;
+            }
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < n_threads; ++t)
+            {
+                threads.emplace_back(worker);
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+      private:
+        // The instructions a sweep meets in a chunk: those starting in it (the last may end in
+        // the next chunk)
+        struct Sweep
+        {
+            std::unordered_set<Opcode> icodes;
+            uint64_t insts = 0;
+            uint64_t exit = 0; // Region offset at which the sweep leaves the chunk
+        };
+
+        // A cut of a region
+        struct Chunk
+        {
+            const TextRegion* region;
+            uint64_t offset;
+            uint64_t size;
+            Sweep sweep;            // Of the region's sweep
+            uint64_t late_exit = 0; // Exit of a sweep entering 2 bytes in
+            bool late = false;      // Whether the region's sweep enters 2 bytes in
+        };
+
+        // Cuts the regions into chunks, and finds the sweep's entry into each (see
+        // collectOpcodes). Only with collect are the chunks' opcodes collected
+        static std::vector<Chunk> sweep_(const std::vector<TextRegion> & regions,
+                                         const uint32_t num_threads, const uint64_t chunk_bytes,
+                                         const bool collect)
+        {
+            const uint64_t cut = std::max<uint64_t>(chunk_bytes, 4) & ~uint64_t(1);
+            std::vector<Chunk> chunks;
+            for (const auto & region : regions)
+            {
+                for (uint64_t off = 0; off < region.size; off += cut)
+                {
+                    chunks.push_back({&region, off, std::min(cut, region.size - off)});
+                }
+            }
+
+            parallelFor(chunks.size(), num_threads,
+                        [&chunks, collect](const size_t c)
+                        {
+                            Chunk & chunk = chunks[c];
+                            scan_(chunk, chunk.offset, chunk.sweep, collect);
+                            chunk.late_exit = exitFrom_(chunk, chunk.offset + 2, chunk.sweep.exit);
+                        });
+
+            // The sweep of a region enters its first chunk at its start
+            std::vector<size_t> late;
+            for (size_t c = 1; c < chunks.size(); ++c)
+            {
+                const Chunk & prev = chunks[c - 1];
+                if ((prev.region == chunks[c].region)
+                    && ((prev.late ? prev.late_exit : prev.sweep.exit) != chunks[c].offset))
+                {
+                    chunks[c].late = true;
+                    late.push_back(c);
+                }
+            }
+            if (collect)
+            {
+                parallelFor(late.size(), num_threads,
+                            [&chunks, &late](const size_t l)
+                            {
+                                Chunk & chunk = chunks[late[l]];
+                                chunk.sweep = Sweep();
+                                scan_(chunk, chunk.offset + 2, chunk.sweep, true);
+                            });
+            }
+            return chunks;
+        }
+
+        static std::vector<TextSpan> spansOf_(const std::vector<Chunk> & chunks)
+        {
+            std::vector<TextSpan> spans;
+            for (const Chunk & chunk : chunks)
+            {
+                const uint64_t begin = chunk.offset + (chunk.late ? 2 : 0);
+                const uint64_t end = chunk.late ? chunk.late_exit : chunk.sweep.exit;
+                if (begin < end)
+                {
+                    spans.push_back({chunk.region, begin, end});
+                }
+            }
+            return spans;
+        }
+
+        // Offset of the instruction after the one at off (the end of the region if there is no
+        // whole instruction at off)
+        static uint64_t next_(const TextRegion & region, const uint64_t off)
+        {
+            if ((off + 2) > region.size)
+            {
+                return region.size;
+            }
+            return std::min(off + instLength(readU16(region.data + off)), region.size);
+        }
+
+        // A partial instruction at the end of a region is not an instruction
+        static void scan_(const Chunk & chunk, uint64_t off, Sweep & sweep, const bool collect)
+        {
+            const TextRegion & region = *chunk.region;
+            const uint64_t end = chunk.offset + chunk.size;
+            while ((off < end) && ((off + 2) <= region.size))
+            {
+                const uint64_t len = instLength(readU16(region.data + off));
+                if ((off + len) > region.size)
+                {
+                    break;
+                }
+                if (collect)
+                {
+                    sweep.icodes.insert(fetch(region, off));
+                }
+                ++sweep.insts;
+                off += len;
+            }
+            sweep.exit = off;
+        }
+
+        // Exit of a sweep entering chunk at entry, given the exit of the sweep entering at its
+        // start: once the two meet at an instruction, they go on together
+        static uint64_t exitFrom_(const Chunk & chunk, uint64_t entry, const uint64_t start_exit)
+        {
+            const TextRegion & region = *chunk.region;
+            const uint64_t end = chunk.offset + chunk.size;
+            uint64_t off = chunk.offset;
+            while (entry < end)
+            {
+                if (off == entry)
+                {
+                    return start_exit;
+                }
+                if (off < entry)
+                {
+                    off = next_(region, off);
+                }
+                else
+                {
+                    entry = next_(region, entry);
+                }
+            }
+            return entry;
+        }
+    };
+
+} // namespace mavis
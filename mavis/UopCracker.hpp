@@ -0,0 +1,498 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "DecoderExceptions.h"
+#include "DecoderTypes.h"
+#include "Extractor.h"
+#include "ExtractorDirectInfo.h"
+#include "InstMetaData.h"
+#include "JSONUtils.hpp"
+#include "JsonMacros.hpp"
+#include "OpcodeInfo.h"
+#include "OperandInfo.hpp"
+
+namespace mavis
+{
+
+    /**
+     * \brief Cracks multi-op instructions (cm.push/cm.pop*, cm.mva01s, register pairs, segment
+     * loads, ...) into micro-ops described in JSON, caching each opcode's micro-ops
+     *
+     * The crack file is an array of rules, one per instruction:
+     *
+     *   {
+     *     "crack" : "cm.push",
+     *     "list"  : "sources", "skip" : 1,          // Register list: sources after sp
+     *     "uops"  : [
+     *       {
+     *         "uop"     : "sw",                     // Instruction or pseudo instruction
+     *         "repeat"  : "list",                   // Once per list register
+     *         "sources" : [["rs1", "rs1"], ["rs2", "reg"]],
+     *         "imm"     : ["-list_bytes"], "imm_step" : 4
+     *       },
+     *       {
+     *         "uop"     : "addi",
+     *         "sources" : [["rs1", "rs1"]], "dests" : [["rd", "rd"]],
+     *         "imm"     : ["-frame", "imm"]            // cm.push offsets are negative
+     *       }
+     *     ]
+     *   }
+     *
+     * "sources"/"dests" pair a micro-op operand field with its value: a field of the cracked
+     * instruction (rs1, rd, rd2, ...), "reg" (the current list register), or x<n>. A "+i" suffix
+     * adds the repetition index. "repeat" is "list", "nf" (NF special field + 1), or a count.
+     *
+     * The immediate is the sum of the "imm" terms (each optionally negated) plus "imm_offset",
+     * plus "imm_step" times the repetition index. Terms are "imm" (the signed offset of the
+     * cracked instruction), "list_bytes" (list registers times the data size in bytes), and
+     * "frame" (list_bytes rounded up to 16, the Zcmp register save area).
+     *
+     * Micro-ops are OpcodeInfo objects, made with the prepared micro-op instruction; special
+     * fields are not carried over. A cracker is bound to the context that is current when it is
+     * built. Rules for instructions that context does not have are dropped.
+     *
+     * \tparam MavisType Mavis facade
+     */
+    template <typename MavisType> class UopCracker
+    {
+      public:
+        using UopList = std::vector<OpcodeInfo::PtrType>;
+
+        UopCracker(MavisType & mavis, const std::string & crack_file) : mavis_(mavis)
+        {
+            const json_value json = parseJSONWithException<BadCrackFile>(crack_file);
+#ifdef USE_NLOHMANN_JSON
+            const auto & rules = json;
+#else
+            const auto & rules = json.as_array();
+#endif
+            for (const auto & rule_value : rules)
+            {
+#ifdef USE_NLOHMANN_JSON
+                addRule_(rule_value);
+#else
+                addRule_(rule_value.as_object());
+#endif
+            }
+        }
+
+        /**
+         * \brief Micro-ops of a decoded instruction (empty if it is not cracked)
+         *
+         * Each opcode is cracked once; the list stays valid until clear(). Instructions made
+         * directly have no opcode to key on (they all have opcode 0): they are cracked on every
+         * call, into a list that is valid until the next such call.
+         */
+        const UopList & crack(const OpcodeInfo::PtrType & opinfo)
+        {
+            const InstructionUniqueID uid = opinfo->getInstructionUniqueID();
+            if ((uid >= rule_index_.size()) || (rule_index_[uid] == NO_RULE))
+            {
+                return no_uops_;
+            }
+
+            const Opcode icode = opinfo->getOpcode();
+            if (icode == 0)
+            {
+                // Made directly: nothing to key on
+                direct_uops_ = crack_(rules_[rule_index_[uid]], opinfo);
+                return direct_uops_;
+            }
+
+            Line & line = lines_[icode % CACHE_SIZE];
+            if ((line.uops != nullptr) && (line.icode == icode))
+            {
+                return *line.uops;
+            }
+
+            auto iter = uops_.find(icode);
+            if (iter == uops_.end())
+            {
+                // Cached only once cracked: a rule that throws leaves nothing behind
+                iter = uops_.emplace(icode, crack_(rules_[rule_index_[uid]], opinfo)).first;
+            }
+            line = {icode, &iter->second};
+            return iter->second;
+        }
+
+        /**
+         * \brief Micro-ops of an opcode, decoded in the current context (which should be the
+         * cracker's)
+         */
+        const UopList & crack(const Opcode icode) { return crack(mavis_.getInfo(icode)->opinfo); }
+
+        bool isCracked(const InstructionUniqueID uid) const
+        {
+            return (uid < rule_index_.size()) && (rule_index_[uid] != NO_RULE);
+        }
+
+        // Drop the cached micro-ops
+        void clear()
+        {
+            uops_.clear();
+            lines_.fill(Line());
+            direct_uops_.clear();
+        }
+
+        size_t numRules() const { return rules_.size(); }
+
+      private:
+        using FieldID = InstMetaData::OperandFieldID;
+
+        // Micro-op operand value
+        struct Operand
+        {
+            enum class Kind
+            {
+                FIELD,
+                REG,
+                CONSTANT
+            };
+
+            FieldID uop_fid = FieldID::NONE;
+            Kind kind = Kind::CONSTANT;
+            FieldID fid = FieldID::NONE; // Kind::FIELD: field of the cracked instruction
+            OperandInfo::OpcodeFieldValueType value = 0;
+            bool plus_index = false;
+        };
+
+        enum class Term
+        {
+            IMM,
+            LIST_BYTES,
+            FRAME
+        };
+
+        struct Uop
+        {
+            typename MavisType::PreparedInstType prepared;
+            enum class Repeat
+            {
+                COUNT,
+                LIST,
+                NF
+            } repeat = Repeat::COUNT;
+            uint32_t count = 1;
+            std::vector<Operand> sources;
+            std::vector<Operand> dests;
+            std::vector<std::pair<Term, bool>> imm_terms; // (term, negated)
+            int64_t imm_offset = 0;
+            int64_t imm_step = 0;
+        };
+
+        struct Rule
+        {
+            std::string name;
+            bool list_from_dests = false;
+            uint32_t list_skip = 0;
+            std::vector<Uop> uops;
+        };
+
+#ifdef USE_NLOHMANN_JSON
+        using json_rule = json_value;
+#else
+        using json_rule = boost::json::object;
+#endif
+
+        constexpr static inline uint32_t NO_RULE = ~0u;
+        constexpr static inline uint32_t CACHE_SIZE = 1023;
+
+        struct Line
+        {
+            Opcode icode = 0;
+            const UopList* uops = nullptr;
+        };
+
+        MavisType & mavis_;
+        std::vector<Rule> rules_;
+        std::vector<uint32_t> rule_index_; // UID -> rule
+        std::unordered_map<Opcode, UopList> uops_;
+        std::array<Line, CACHE_SIZE> lines_{};
+        const UopList no_uops_;
+        UopList direct_uops_; // Of the last instruction made directly
+
+        void addRule_(const json_rule & rule_json)
+        {
+            Rule rule;
+            rule.name = JSON_GET(rule_json, "crack", std::string);
+            const InstructionUniqueID uid = mavis_.lookupInstructionUniqueID(rule.name);
+            if (uid == INVALID_UID)
+            {
+                // Not in this context
+                return;
+            }
+
+            if (rule_json.contains("list"))
+            {
+                const std::string list = JSON_GET(rule_json, "list", std::string);
+                if ((list != "sources") && (list != "dests"))
+                {
+                    throw BadCrackRule(rule.name, "\"list\" is \"sources\" or \"dests\"");
+                }
+                rule.list_from_dests = (list == "dests");
+            }
+            if (rule_json.contains("skip"))
+            {
+                rule.list_skip = JSON_GET(rule_json, "skip", uint32_t);
+            }
+
+#ifdef USE_NLOHMANN_JSON
+            const auto & uops = rule_json.at("uops");
+#else
+            const auto & uops = rule_json.at("uops").as_array();
+#endif
+            for (const auto & uop_value : uops)
+            {
+#ifdef USE_NLOHMANN_JSON
+                rule.uops.emplace_back(parseUop_(rule, uop_value));
+#else
+                rule.uops.emplace_back(parseUop_(rule, uop_value.as_object()));
+#endif
+            }
+
+            if (uid >= rule_index_.size())
+            {
+                rule_index_.resize(uid + 1, NO_RULE);
+            }
+            rule_index_[uid] = static_cast<uint32_t>(rules_.size());
+            rules_.emplace_back(std::move(rule));
+        }
+
+        Uop parseUop_(const Rule & rule, const json_rule & uop_json) const
+        {
+            Uop uop;
+            const std::string mnemonic = JSON_GET(uop_json, "uop", std::string);
+            if (mavis_.lookupInstructionUniqueID(mnemonic) != INVALID_UID)
+            {
+                uop.prepared = mavis_.prepareInstDirectly(mnemonic);
+            }
+            else if (mavis_.lookupPseudoInstUniqueID(mnemonic) != INVALID_UID)
+            {
+                uop.prepared = mavis_.preparePseudoInst(mnemonic);
+            }
+            else
+            {
+                throw BadCrackRule(rule.name, "unknown micro-op '" + mnemonic + "'");
+            }
+
+            if (uop_json.contains("repeat"))
+            {
+                if (!uop_json.at("repeat").is_string())
+                {
+                    uop.count = JSON_GET(uop_json, "repeat", uint32_t);
+                }
+                else if (const std::string repeat = JSON_GET(uop_json, "repeat", std::string);
+                         repeat == "list")
+                {
+                    uop.repeat = Uop::Repeat::LIST;
+                }
+                else if (repeat == "nf")
+                {
+                    uop.repeat = Uop::Repeat::NF;
+                }
+                else
+                {
+                    throw BadCrackRule(rule.name, "unknown repeat '" + repeat + "'");
+                }
+            }
+
+            for (const char* key : {"sources", "dests"})
+            {
+                auto & operands = (std::string_view(key) == "sources") ? uop.sources : uop.dests;
+                if (!uop_json.contains(key))
+                {
+                    continue;
+                }
+                for (const auto & pair :
+                     JSON_CAST(uop_json.at(key), std::vector<std::vector<std::string>>))
+                {
+                    if (pair.size() != 2)
+                    {
+                        throw BadCrackRule(rule.name, std::string("\"") + key
+                                                          + "\" entries are [field, value]");
+                    }
+                    operands.emplace_back(parseOperand_(rule, uop, pair[0], pair[1]));
+                }
+            }
+
+            if (uop_json.contains("imm"))
+            {
+                for (const auto & term : JSON_GET(uop_json, "imm", std::vector<std::string>))
+                {
+                    const bool negated = !term.empty() && (term[0] == '-');
+                    const std::string name = negated ? term.substr(1) : term;
+                    if (name == "imm")
+                    {
+                        uop.imm_terms.emplace_back(Term::IMM, negated);
+                    }
+                    else if (name == "list_bytes")
+                    {
+                        uop.imm_terms.emplace_back(Term::LIST_BYTES, negated);
+                    }
+                    else if (name == "frame")
+                    {
+                        uop.imm_terms.emplace_back(Term::FRAME, negated);
+                    }
+                    else
+                    {
+                        throw BadCrackRule(rule.name, "unknown immediate term '" + term + "'");
+                    }
+                }
+            }
+            if (uop_json.contains("imm_offset"))
+            {
+                uop.imm_offset = JSON_GET(uop_json, "imm_offset", int64_t);
+            }
+            if (uop_json.contains("imm_step"))
+            {
+                uop.imm_step = JSON_GET(uop_json, "imm_step", int64_t);
+            }
+            return uop;
+        }
+
+        static Operand parseOperand_(const Rule & rule, const Uop & uop, const std::string & field,
+                                     const std::string & text)
+        {
+            Operand operand;
+            operand.uop_fid = InstMetaData::getFieldID(field);
+            if (operand.uop_fid == FieldID::NONE)
+            {
+                throw BadCrackRule(rule.name, "unknown operand field '" + field + "'");
+            }
+
+            std::string value = text;
+            if ((value.size() > 2) && (value.compare(value.size() - 2, 2, "+i") == 0))
+            {
+                operand.plus_index = true;
+                value.resize(value.size() - 2);
+            }
+
+            if (value == "reg")
+            {
+                if (uop.repeat != Uop::Repeat::LIST)
+                {
+                    throw BadCrackRule(rule.name, "\"reg\" needs \"repeat\" : \"list\"");
+                }
+                operand.kind = Operand::Kind::REG;
+            }
+            else if ((value.size() > 1) && (value[0] == 'x')
+                     && (value.find_first_not_of("0123456789", 1) == std::string::npos))
+            {
+                operand.value = static_cast<OperandInfo::OpcodeFieldValueType>(std::stoul(value.substr(1)));
+            }
+            else
+            {
+                operand.kind = Operand::Kind::FIELD;
+                operand.fid = InstMetaData::getFieldID(value);
+                if (operand.fid == FieldID::NONE)
+                {
+                    throw BadCrackRule(rule.name, "unknown operand '" + text + "'");
+                }
+            }
+            return operand;
+        }
+
+        static const OperandInfo::Element* findField_(const OpcodeInfo & opinfo, const FieldID fid)
+        {
+            for (const OperandInfo* oi : {&opinfo.getSourceOpInfo(), &opinfo.getDestOpInfo()})
+            {
+                for (const auto & elem : oi->getElements())
+                {
+                    if (elem.field_id == fid)
+                    {
+                        return &elem;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        UopList crack_(const Rule & rule, const OpcodeInfo::PtrType & opinfo) const
+        {
+            UopList uops;
+            const auto & list_oi =
+                rule.list_from_dests ? opinfo->getDestOpInfoList() : opinfo->getSourceOpInfoList();
+            const uint32_t list_skip =
+                std::min(rule.list_skip, static_cast<uint32_t>(list_oi.size()));
+            const OperandInfo::Element* list = list_oi.data() + list_skip;
+            const uint32_t list_len = static_cast<uint32_t>(list_oi.size()) - list_skip;
+
+            const int64_t list_bytes = int64_t(list_len) * (opinfo->getDataSize() / 8);
+            const int64_t term_values[] = {opinfo->getSignedOffset(), list_bytes,
+                                           (list_bytes + 15) & -16ll};
+
+            for (const Uop & uop : rule.uops)
+            {
+                uint32_t count = uop.count;
+                if (uop.repeat == Uop::Repeat::LIST)
+                {
+                    count = list_len;
+                }
+                else if (uop.repeat == Uop::Repeat::NF)
+                {
+                    count = static_cast<uint32_t>(
+                                opinfo->getSpecialField(ExtractorIF::SpecialField::NF))
+                            + 1;
+                }
+
+                int64_t imm = uop.imm_offset;
+                for (const auto & [term, negated] : uop.imm_terms)
+                {
+                    const int64_t value = term_values[static_cast<uint32_t>(term)];
+                    imm += negated ? -value : value;
+                }
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const auto make_operands = [&](const std::vector<Operand> & operands,
+                                                   const bool is_source)
+                    {
+                        OperandInfo oi;
+                        for (const Operand & operand : operands)
+                        {
+                            const OperandInfo::Element* elem =
+                                (operand.kind == Operand::Kind::REG)     ? &list[i]
+                                : (operand.kind == Operand::Kind::FIELD) ? findField_(*opinfo,
+                                                                                      operand.fid)
+                                                                         : nullptr;
+                            if ((operand.kind == Operand::Kind::FIELD) && (elem == nullptr))
+                            {
+                                throw BadCrackRule(opinfo->getMnemonic(),
+                                                   "no operand '"
+                                                       + InstMetaData::getFieldIDName(operand.fid)
+                                                       + "'");
+                            }
+
+                            auto type = uop.prepared.meta->getOperandType(operand.uop_fid);
+                            if ((type == InstMetaData::OperandTypes::NONE) && (elem != nullptr))
+                            {
+                                type = elem->operand_type;
+                            }
+                            const OperandInfo::OpcodeFieldValueType value =
+                                ((elem != nullptr) ? elem->field_value : operand.value)
+                                + (operand.plus_index ? i : 0);
+                            oi.addElement(operand.uop_fid, type, value,
+                                          is_source && (elem != nullptr) && elem->is_store_data);
+                        }
+                        return oi;
+                    };
+
+                    const ExtractorDirectOpInfoList ex_info(
+                        uop.prepared.uid, make_operands(uop.sources, true),
+                        make_operands(uop.dests, false),
+                        static_cast<uint64_t>(imm + (uop.imm_step * int64_t(i))));
+                    uops.emplace_back(uop.prepared.makeOpcodeInfo(ex_info));
+                }
+            }
+            return uops;
+        }
+    };
+
+} // namespace mavis
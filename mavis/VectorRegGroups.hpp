@@ -0,0 +1,418 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DecoderExceptions.h"
+#include "DecoderTypes.h"
+#include "Extractor.h"
+#include "InlineVector.hpp"
+#include "InstMetaData.h"
+#include "OpcodeInfo.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Vector type state (the vtype CSR)
+     */
+    struct VType
+    {
+        uint32_t sew = 8;      // Selected element width, in bits
+        int32_t lmul_log2 = 0; // log2(LMUL): -3 (mf8) .. 3 (m8)
+        bool ta = false;
+        bool ma = false;
+        bool vill = false;
+
+        /**
+         * \brief From a vtype value: the immediate of vsetvli/vsetivli, or the rs2 value of
+         * vsetvl. Reserved encodings (and set bits above vma) give vill
+         */
+        static VType fromImmediate(const uint64_t vtypei)
+        {
+            VType vtype;
+            const uint32_t vlmul = vtypei & 0x7;
+            const uint32_t vsew = (vtypei >> 3) & 0x7;
+            vtype.vill = (vlmul == 4) || (vsew > 3) || ((vtypei >> 8) != 0);
+            if (!vtype.vill)
+            {
+                vtype.sew = 8u << vsew;
+                vtype.lmul_log2 = (vlmul < 4) ? int32_t(vlmul) : int32_t(vlmul) - 8;
+                vtype.ta = (vtypei >> 6) & 0x1;
+                vtype.ma = (vtypei >> 7) & 0x1;
+            }
+            return vtype;
+        }
+
+        // vtype value (vill as bit 8)
+        uint32_t encode() const
+        {
+            if (vill)
+            {
+                return 1u << 8;
+            }
+            uint32_t vsew = 0;
+            while ((8u << vsew) < sew)
+            {
+                ++vsew;
+            }
+            return (uint32_t(lmul_log2) & 0x7) | (vsew << 3) | (uint32_t(ta) << 6)
+                   | (uint32_t(ma) << 7);
+        }
+    };
+
+    /**
+     * \brief Registers of one vector operand: count registers from base
+     */
+    struct VectorRegGroup
+    {
+        InstMetaData::OperandFieldID field_id = InstMetaData::OperandFieldID::NONE; // NONE: v0 mask
+        uint32_t base = 0;
+        uint32_t count = 1;
+
+        uint64_t getMask() const { return ((1ull << count) - 1) << base; }
+    };
+
+    /**
+     * \brief Vector register groups of an instruction under a vtype
+     */
+    struct VectorRegGroups
+    {
+        InlineVector<VectorRegGroup, 4> sources; // Includes v0 when the instruction is masked
+        InlineVector<VectorRegGroup, 2> dests;
+        uint64_t source_mask = 0;
+        uint64_t dest_mask = 0;
+
+        // vill, an EMUL outside [1/8, 8], or a misaligned or out-of-range group (the groups are
+        // then clamped to v31)
+        bool illegal = false;
+    };
+
+    /**
+     * \brief Expands the base vector registers of decoded instructions into register groups, for
+     * a given vtype
+     *
+     * Accounts for LMUL, widening (2*SEW vd, and vs2 for .w* forms), narrowing (2*SEW vs2),
+     * vzext/vsext.vf*, load/store EEW and indexed EEW, segment NF, whole-register loads, stores and
+     * moves, single-register mask and reduction operands, element-0 moves, and the v0 mask.
+     * Operand shapes are derived once per instruction (from its types and mnemonic).
+     *
+     * Results are memoized in a direct-mapped cache keyed by (opcode, vtype); vl does not change
+     * the groups. A returned reference is valid until the next expand(). An expander belongs to
+     * one context: clear() it when switching.
+     */
+    class VectorRegGroupExpander
+    {
+      public:
+        const VectorRegGroups & expand(const OpcodeInfo::PtrType & opinfo, const VType & vtype)
+        {
+            const Opcode icode = opinfo->getOpcode();
+            const uint32_t vtype_key = vtype.encode();
+            if (icode == 0)
+            {
+                // Made directly: nothing to key on
+                scratch_ = VectorRegGroups();
+                expand_(opinfo, vtype, scratch_);
+                return scratch_;
+            }
+
+            Line & line = lines_[(icode ^ (vtype_key * 0x9e3779b1u)) % CACHE_SIZE];
+            if (!line.valid || (line.icode != icode) || (line.vtype != vtype_key))
+            {
+                line.groups = VectorRegGroups();
+                expand_(opinfo, vtype, line.groups);
+                line.icode = icode;
+                line.vtype = vtype_key;
+                line.valid = true;
+            }
+            return line.groups;
+        }
+
+        void clear()
+        {
+            lines_.fill(Line());
+            shapes_.clear();
+        }
+
+      private:
+        // Register count of an operand, relative to the vtype
+        struct OperandShape
+        {
+            enum class Kind : uint8_t
+            {
+                LMUL,  // EMUL = LMUL * 2^log2_delta
+                EEW,   // EMUL = LMUL * eew / SEW
+                ONE,   // A single register (mask, scalar element, reduction)
+                WHOLE, // whole_regs registers, whatever the vtype
+            };
+
+            Kind kind = Kind::LMUL;
+            int8_t log2_delta = 0;
+            uint32_t eew = 0;
+            uint32_t whole_regs = 0;
+            bool segment = false; // Times NF + 1
+        };
+
+        struct Shape
+        {
+            bool valid = false;
+            OperandShape vd; // Dests, and vd/vs3 as a source (mac, store data)
+            OperandShape vs1;
+            OperandShape vs2;
+            bool uses_v0 = false; // Carry/merge forms (.vvm, .vxm, ...)
+        };
+
+        constexpr static inline uint32_t CACHE_SIZE = 255;
+
+        struct Line
+        {
+            bool valid = false;
+            Opcode icode = 0;
+            uint32_t vtype = 0;
+            VectorRegGroups groups;
+        };
+
+        std::array<Line, CACHE_SIZE> lines_{};
+        std::vector<Shape> shapes_; // By UID
+        VectorRegGroups scratch_;
+
+        // Number in a mnemonic, after prefix (vl2re16 -> 2); 0 if none
+        static uint32_t mnemonicNumber_(const std::string & name, const size_t prefix_len)
+        {
+            uint32_t num = 0;
+            for (size_t i = prefix_len; (i < name.size()) && std::isdigit(name[i]); ++i)
+            {
+                num = (num * 10) + (name[i] - '0');
+            }
+            return num;
+        }
+
+        static uint32_t log2_(uint32_t value)
+        {
+            uint32_t log2 = 0;
+            while (value > 1)
+            {
+                value >>= 1;
+                ++log2;
+            }
+            return log2;
+        }
+
+        static Shape makeShape_(const OpcodeInfo & opinfo)
+        {
+            using Types = InstMetaData::InstructionTypes;
+            using Kind = OperandShape::Kind;
+
+            Shape shape;
+            shape.valid = true;
+
+            // e.g. vwadd.wv -> name vwadd, suffix wv; vmv.x.s -> name vmv, suffix s
+            const std::string & mnemonic = opinfo.getMnemonic();
+            const std::string name = mnemonic.substr(0, mnemonic.find('.'));
+            const std::string suffix = mnemonic.substr(mnemonic.rfind('.') + 1);
+            const auto has_component = [&mnemonic](const std::string & component)
+            {
+                const std::string dotted = "." + mnemonic + ".";
+                return dotted.find("." + component + ".") != std::string::npos;
+            };
+
+            if (opinfo.isInstTypeAnyOf(Types::LOAD, Types::STORE))
+            {
+                if (opinfo.isInstType(Types::MASK))
+                {
+                    shape.vd.kind = Kind::ONE;
+                }
+                else if (opinfo.isInstType(Types::WHOLE))
+                {
+                    shape.vd.kind = Kind::WHOLE;
+                    shape.vd.whole_regs = std::max(mnemonicNumber_(name, 2), 1u);
+                }
+                else
+                {
+                    const bool indexed =
+                        opinfo.isInstTypeAnyOf(Types::ORDERED_INDEXED, Types::UNORDERED_INDEXED);
+                    OperandShape & eew_operand = indexed ? shape.vs2 : shape.vd;
+                    eew_operand.kind = Kind::EEW;
+                    eew_operand.eew = opinfo.getDataSize();
+                    shape.vd.segment = opinfo.isInstType(Types::SEGMENT);
+                }
+                return shape;
+            }
+
+            if ((name.size() > 4) && (name.compare(0, 3, "vmv") == 0) && (name.back() == 'r'))
+            {
+                // vmv<nr>r.v
+                shape.vd.kind = shape.vs2.kind = Kind::WHOLE;
+                shape.vd.whole_regs = shape.vs2.whole_regs = std::max(mnemonicNumber_(name, 3), 1u);
+                return shape;
+            }
+            if (has_component("s"))
+            {
+                // vmv.x.s, vmv.s.x, vfmv.f.s, vfmv.s.f: element 0
+                shape.vd.kind = shape.vs1.kind = shape.vs2.kind = Kind::ONE;
+                return shape;
+            }
+
+            const bool widening = opinfo.isInstType(Types::WIDENING)
+                                  || (name.compare(0, 2, "vw") == 0)
+                                  || (name.compare(0, 3, "vfw") == 0);
+            if (widening)
+            {
+                shape.vd.log2_delta = 1;
+            }
+            if (suffix[0] == 'w')
+            {
+                // .wv, .wx, .wi, .wf, .w: 2*SEW vs2 (widening or narrowing)
+                shape.vs2.log2_delta = 1;
+            }
+            else if ((suffix.size() == 3) && (suffix.compare(0, 2, "vf") == 0))
+            {
+                // vzext/vsext.vf2/4/8
+                shape.vs2.log2_delta = -int8_t(log2_(suffix[2] - '0'));
+            }
+            else if (name == "vrgatherei16")
+            {
+                shape.vs1.kind = Kind::EEW;
+                shape.vs1.eew = 16;
+            }
+
+            if (name.find("red") != std::string::npos)
+            {
+                shape.vd.kind = shape.vs1.kind = Kind::ONE;
+            }
+            if (opinfo.isInstType(Types::MASK))
+            {
+                shape.vd.kind = Kind::ONE;
+            }
+            if ((suffix == "m") || (suffix == "mm"))
+            {
+                shape.vs1.kind = shape.vs2.kind = Kind::ONE;
+            }
+            else if (suffix == "vm")
+            {
+                // vcompress.vm
+                shape.vs1.kind = Kind::ONE;
+            }
+            else if ((suffix == "vvm") || (suffix == "vxm") || (suffix == "vim")
+                     || (suffix == "vfm"))
+            {
+                shape.uses_v0 = true;
+            }
+            return shape;
+        }
+
+        const Shape & getShape_(const OpcodeInfo & opinfo)
+        {
+            const InstructionUniqueID uid = opinfo.getInstructionUniqueID();
+            if (uid >= shapes_.size())
+            {
+                shapes_.resize(uid + 1);
+            }
+            if (!shapes_[uid].valid)
+            {
+                shapes_[uid] = makeShape_(opinfo);
+            }
+            return shapes_[uid];
+        }
+
+        // Registers of an operand at base; false if its group is illegal
+        static bool makeGroup_(const OperandShape & shape, const VType & vtype, const uint32_t nf,
+                               VectorRegGroup & group)
+        {
+            int32_t emul_log2 = vtype.lmul_log2;
+            switch (shape.kind)
+            {
+                case OperandShape::Kind::ONE:
+                    group.count = 1;
+                    return true;
+                case OperandShape::Kind::WHOLE:
+                    group.count = shape.whole_regs;
+                    return (group.base % shape.whole_regs) == 0;
+                case OperandShape::Kind::LMUL:
+                    emul_log2 += shape.log2_delta;
+                    break;
+                case OperandShape::Kind::EEW:
+                    emul_log2 += int32_t(log2_(shape.eew)) - int32_t(log2_(vtype.sew));
+                    break;
+            }
+
+            const uint32_t regs = (emul_log2 > 0) ? (1u << emul_log2) : 1;
+            group.count = regs * (shape.segment ? nf : 1);
+            return (emul_log2 >= -3) && (emul_log2 <= 3) && (group.count <= 8)
+                   && ((group.base % regs) == 0);
+        }
+
+        void expand_(const OpcodeInfo::PtrType & opinfo, const VType & vtype,
+                     VectorRegGroups & groups)
+        {
+            using FieldID = InstMetaData::OperandFieldID;
+            constexpr uint32_t NUM_VREGS = 32;
+
+            const Shape & shape = getShape_(*opinfo);
+            const uint32_t nf =
+                (shape.vd.segment ? uint32_t(opinfo->getSpecialField(ExtractorIF::SpecialField::NF))
+                                  : 0)
+                + 1;
+            groups.illegal = vtype.vill;
+
+            const auto add = [&](const OperandInfo::Element & elem, const OperandShape & oshape,
+                                 auto & list, uint64_t & mask)
+            {
+                VectorRegGroup group{elem.field_id, elem.field_value, 1};
+                if (!vtype.vill && !makeGroup_(oshape, vtype, nf, group))
+                {
+                    groups.illegal = true;
+                }
+                if (group.base + group.count > NUM_VREGS)
+                {
+                    groups.illegal = true;
+                    group.count = NUM_VREGS - group.base;
+                }
+                list.push_back(group);
+                mask |= group.getMask();
+            };
+
+            for (const auto & elem : opinfo->getSourceOpInfoList())
+            {
+                if (elem.operand_type != InstMetaData::OperandTypes::VECTOR)
+                {
+                    continue;
+                }
+                const OperandShape & oshape = (elem.field_id == FieldID::RS1)   ? shape.vs1
+                                              : (elem.field_id == FieldID::RS2) ? shape.vs2
+                                                                                : shape.vd;
+                add(elem, oshape, groups.sources, groups.source_mask);
+            }
+            for (const auto & elem : opinfo->getDestOpInfoList())
+            {
+                if (elem.operand_type == InstMetaData::OperandTypes::VECTOR)
+                {
+                    add(elem, shape.vd, groups.dests, groups.dest_mask);
+                }
+            }
+
+            bool masked = shape.uses_v0;
+            if (!masked && opinfo->isInstType(InstMetaData::InstructionTypes::MASKABLE))
+            {
+                try
+                {
+                    masked = (opinfo->getSpecialField(ExtractorIF::SpecialField::VM) == 0);
+                }
+                catch (const UnsupportedExtractorSpecialFieldID &)
+                {
+                    // vm is fixed (unmasked)
+                }
+            }
+            if (masked)
+            {
+                groups.sources.push_back({FieldID::NONE, 0, 1});
+                groups.source_mask |= 1;
+            }
+        }
+    };
+
+} // namespace mavis
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "DecoderTypes.h"
+#include "DecoderExceptions.h"
+
+namespace mavis
+{
+
+    /**
+     * \brief Opcodes seen during a run, saved to be decoded again before the next one starts
+     * (see Mavis::saveWarmCache/loadWarmCache)
+     *
+     * The file is a 24-byte header -- magic, version, the fingerprint of the decode table the
+     * opcodes were recorded from (DTable::getFingerprint), and the opcode count -- followed by the
+     * opcodes in increasing order, each as a little-endian 32-bit word. A file with another
+     * table's fingerprint is rejected with StaleWarmCacheFile.
+     */
+    class WarmCacheFile
+    {
+      public:
+        static void write(const std::string & path, const uint64_t fingerprint,
+                          std::vector<Opcode> icodes)
+        {
+            std::sort(icodes.begin(), icodes.end());
+            icodes.erase(std::unique(icodes.begin(), icodes.end()), icodes.end());
+
+            std::vector<uint8_t> bytes;
+            bytes.reserve(HEADER_SIZE + (icodes.size() * 4));
+            put_(bytes, MAGIC, 4);
+            put_(bytes, VERSION, 4);
+            put_(bytes, fingerprint, 8);
+            put_(bytes, icodes.size(), 8);
+            for (const Opcode icode : icodes)
+            {
+                if (icode > UINT32_MAX)
+                {
+                    throw BadWarmCacheFile(path, "opcode wider than 32 bits");
+                }
+                put_(bytes, icode, 4);
+            }
+
+            std::ofstream os(path, std::ios::binary | std::ios::trunc);
+            os.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            if (!os)
+            {
+                throw BadWarmCacheFile(path, "cannot write");
+            }
+        }
+
+        static std::vector<Opcode> read(const std::string & path, const uint64_t fingerprint)
+        {
+            std::ifstream is(path, std::ios::binary);
+            if (!is)
+            {
+                throw BadWarmCacheFile(path, "cannot open");
+            }
+
+            std::array<uint8_t, HEADER_SIZE> header;
+            if (!is.read(reinterpret_cast<char*>(header.data()), header.size()))
+            {
+                throw BadWarmCacheFile(path, "truncated header");
+            }
+            if ((get_(header.data(), 4) != MAGIC) || (get_(header.data() + 4, 4) != VERSION))
+            {
+                throw BadWarmCacheFile(path, "not a warm cache file (or another version)");
+            }
+            if (const uint64_t saved = get_(header.data() + 8, 8); saved != fingerprint)
+            {
+                throw StaleWarmCacheFile(path, saved, fingerprint);
+            }
+
+            // Check the size before trusting the count
+            const uint64_t count = get_(header.data() + 16, 8);
+            is.seekg(0, std::ios::end);
+            const uint64_t file_size = static_cast<uint64_t>(is.tellg());
+            if ((count > (file_size / 4)) || (file_size != (HEADER_SIZE + (count * 4))))
+            {
+                throw BadWarmCacheFile(path, "size does not match its " + std::to_string(count)
+                                                 + " opcodes");
+            }
+            is.seekg(HEADER_SIZE);
+            std::vector<uint8_t> bytes(count * 4);
+            if (!is.read(reinterpret_cast<char*>(bytes.data()), bytes.size()))
+            {
+                throw BadWarmCacheFile(path, "cannot read");
+            }
+
+            std::vector<Opcode> icodes(count);
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                icodes[i] = get_(bytes.data() + (i * 4), 4);
+            }
+            return icodes;
+        }
+
+      private:
+        static constexpr uint64_t MAGIC = 0x4357564d; // "MVWC"
+        static constexpr uint64_t VERSION = 1;
+        static constexpr size_t HEADER_SIZE = 24;
+
+        static void put_(std::vector<uint8_t> & bytes, uint64_t value, const uint32_t size)
+        {
+            for (uint32_t i = 0; i < size; ++i, value >>= 8)
+            {
+                bytes.push_back(static_cast<uint8_t>(value));
+            }
+        }
+
+        static uint64_t get_(const uint8_t* bytes, const uint32_t size)
+        {
+            uint64_t value = 0;
+            for (uint32_t i = size; i > 0; --i)
+            {
+                value = (value << 8) | bytes[i - 1];
+            }
+            return value;
+        }
+    };
+
+} // namespace mavis
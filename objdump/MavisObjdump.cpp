@@ -0,0 +1,360 @@
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elfio/elfio.hpp"
+#include "mavis/ELFText.hpp"
+#include "mavis/Mavis.h"
+#include "mavis/extension_managers/RISCVExtensionManager.hpp"
+
+//
+// mavis_objdump -- objdump-style disassembly of the executable sections of a RISC-V ELF file.
+//
+// The ISA (and so the Mavis context) is taken from the file's .riscv.attributes section, unless
+// one is given with --isa. Each executable section is split into chunks of whole instructions,
+// the chunks are disassembled in parallel (one decode table per worker thread), and the text is
+// written out in address order. Data in executable sections (between a $d mapping symbol and the
+// next $x) is shown as .word/.half/.byte, not disassembled. The throughput, in MB/s of section
+// data, is reported on stderr.
+//
+
+namespace
+{
+    // The disassembler never makes instructions, and never reads annotations
+    struct DasmInst
+    {
+        typedef std::shared_ptr<DasmInst> PtrType;
+    };
+
+    struct DasmAnnotation
+    {
+        typedef std::shared_ptr<DasmAnnotation> PtrType;
+
+        template <typename JSONType> explicit DasmAnnotation(const JSONType &) {}
+
+        template <typename JSONType> void update(const JSONType &) {}
+    };
+
+    using AnnotationAllocator = mavis::SharedPtrAllocator<DasmAnnotation>;
+    using BuilderType = mavis::IFactoryBuilder<DasmInst, DasmAnnotation, AnnotationAllocator>;
+    using DTableType = mavis::DTable<DasmInst, DasmAnnotation, AnnotationAllocator>;
+
+    // Symbol names by address (labels for the disassembly)
+    using SymbolMap = std::map<uint64_t, std::string>;
+
+    // Instructions, or data, within one executable section
+    struct Chunk
+    {
+        const ELFIO::section* section;
+        uint64_t offset; // From the start of the section
+        uint64_t size;
+        bool data; // Data, or a partial instruction at the end of code
+    };
+
+    // Splits the executable sections into chunks, in address order. The code is cut into spans
+    // of whole instructions of about chunk_bytes by a TextScanner, on num_threads threads and
+    // with no sequential length pre-scan; data is cut at multiples of 4 bytes
+    std::vector<Chunk> splitText(const mavis::ELFText & text, const uint32_t num_threads,
+                                 const uint64_t chunk_bytes)
+    {
+        const std::vector<mavis::TextRegion> & regions = text.getRegions();
+        const std::vector<mavis::TextSpan> spans =
+            mavis::TextScanner::splitRegions(regions, num_threads, chunk_bytes);
+        const uint64_t data_cut = std::max<uint64_t>(chunk_bytes & ~uint64_t(3), 4);
+
+        std::vector<Chunk> chunks;
+        const auto add_data = [&chunks, data_cut](const ELFIO::section* sec, uint64_t off,
+                                                  const uint64_t end)
+        {
+            for (; off < end; off += data_cut)
+            {
+                chunks.push_back({sec, off, std::min(data_cut, end - off), true});
+            }
+        };
+        auto span = spans.begin();
+        for (const auto & section : text.getSections())
+        {
+            const ELFIO::section* sec = section.section;
+            uint64_t off = 0; // End of the chunks so far
+            for (size_t r = section.first_region; r < section.end_region; ++r)
+            {
+                const mavis::TextRegion & region = regions[r];
+                const uint64_t start = region.address - sec->get_address();
+                add_data(sec, off, start);
+                off = start;
+                for (; (span != spans.end()) && (span->region == &region); ++span)
+                {
+                    chunks.push_back({sec, start + span->begin, span->end - span->begin, false});
+                    off = start + span->end;
+                }
+                add_data(sec, off, start + region.size);
+                off = start + region.size;
+            }
+            add_data(sec, off, sec->get_size());
+        }
+        return chunks;
+    }
+
+    // Function and label symbols in the executable sections (the mapping symbols are not labels)
+    SymbolMap readSymbols(const ELFIO::elfio & reader)
+    {
+        SymbolMap symbols;
+        mavis::forEachTextSymbol(reader,
+                                 [&symbols](const ELFIO::section*, const std::string & name,
+                                            const uint64_t value)
+                                 {
+                                     if (name[0] != '$')
+                                     {
+                                         symbols.emplace(value, name);
+                                     }
+                                 });
+        return symbols;
+    }
+
+    // Shows len (1, 2 or 4) bytes of data
+    void renderData(std::string & out, const uint64_t addr, const uint8_t* p, const uint64_t len)
+    {
+        static const char* const directives[] = {nullptr, ".byte", ".half", nullptr, ".word"};
+        uint32_t value = 0;
+        for (uint64_t i = len; i-- > 0;)
+        {
+            value = (value << 8) | p[i];
+        }
+        char line[64];
+        std::snprintf(line, sizeof(line), "%8" PRIx64 ":\t%0*" PRIx32 "\t%s\t0x%0*" PRIx32 "\n",
+                      addr, static_cast<int>(len * 2), value, directives[len],
+                      static_cast<int>(len * 2), value);
+        out += line;
+    }
+
+    std::string renderChunk(DTableType & dtable, const Chunk & chunk, const SymbolMap & symbols)
+    {
+        std::string out;
+        out.reserve(chunk.size * 16);
+
+        char line[256];
+        char dasm[160];
+        const uint64_t base = chunk.section->get_address();
+        const mavis::TextRegion text{reinterpret_cast<const uint8_t*>(chunk.section->get_data()),
+                                     chunk.section->get_size(), base};
+        const uint64_t end = chunk.offset + chunk.size;
+        auto sym = symbols.lower_bound(base + chunk.offset);
+        for (uint64_t off = chunk.offset; off < end;)
+        {
+            const uint64_t addr = base + off;
+            for (; (sym != symbols.end()) && (sym->first <= addr); ++sym)
+            {
+                std::snprintf(line, sizeof(line), "\n%016" PRIx64 " <%s>:\n", sym->first,
+                              sym->second.c_str());
+                out += line;
+            }
+
+            if (chunk.data)
+            {
+                const uint64_t remaining = end - off;
+                const uint64_t len = (remaining >= 4) ? 4 : ((remaining >= 2) ? 2 : 1);
+                renderData(out, addr, text.data + off, len);
+                off += len;
+                continue;
+            }
+
+            const mavis::Opcode icode = mavis::TextScanner::fetch(text, off);
+            const uint64_t len = mavis::TextScanner::instLength(static_cast<uint16_t>(icode));
+            try
+            {
+                dtable.dasmTo(icode, dasm, sizeof(dasm));
+            }
+            catch (const mavis::BaseException &)
+            {
+                std::snprintf(dasm, sizeof(dasm), "<unknown>");
+            }
+            std::snprintf(line, sizeof(line), "%8" PRIx64 ":\t%0*" PRIx64 "\t%s\n", addr,
+                          static_cast<int>(len * 2), icode, dasm);
+            out += line;
+            off += len;
+        }
+        return out;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    namespace po = boost::program_options;
+    po::options_description desc(
+        "mavis_objdump -- disassemble the executable sections of a RISC-V ELF file");
+    desc.add_options()("help,h", "Command line options")(
+        "isa,i", po::value<std::string>(),
+        "ISA string (default: from the ELF's .riscv.attributes section)")(
+        "spec,s", po::value<std::string>()->default_value("json/riscv_isa_spec.json"),
+        "RISC-V ISA spec JSON")(
+        "json-dir,j", po::value<std::string>()->default_value("json"), "Mavis ISA JSON directory")(
+        "threads,t", po::value<uint32_t>()->default_value(std::thread::hardware_concurrency()),
+        "Worker threads")(
+        "chunk-size,c", po::value<uint64_t>()->default_value(64 * 1024),
+        "Bytes of code per work item")(
+        "stats-only,q", "Disassemble, but print only the throughput")(
+        "elf", po::value<std::string>(), "ELF file");
+
+    po::positional_options_description pos;
+    pos.add("elf", 1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(pos).run(), vm);
+    po::notify(vm);
+
+    if (vm.count("help"))
+    {
+        std::cout << desc << "\n";
+        return 0;
+    }
+
+    if (vm.count("elf") == 0)
+    {
+        std::cerr << "ERROR: An ELF file is required" << std::endl;
+        std::cout << desc << "\n";
+        return 255;
+    }
+
+    const std::string elf = vm["elf"].as<std::string>();
+    const std::string spec = vm["spec"].as<std::string>();
+    const std::string json_dir = vm["json-dir"].as<std::string>();
+    const uint32_t num_threads = std::max(vm["threads"].as<uint32_t>(), 1u);
+    const uint64_t chunk_bytes = std::max(vm["chunk-size"].as<uint64_t>(), uint64_t(4));
+    const bool stats_only = vm.count("stats-only") != 0;
+
+    std::unique_ptr<const mavis::ELFText> text;
+    try
+    {
+        text.reset(new mavis::ELFText(elf));
+    }
+    catch (const mavis::BadELFFile & ex)
+    {
+        std::cerr << "ERROR: " << ex.what() << std::endl;
+        return 1;
+    }
+
+    using mavis::extension_manager::riscv::RISCVExtensionManager;
+    const RISCVExtensionManager extension_manager =
+        vm.count("isa") ? RISCVExtensionManager::fromISA(vm["isa"].as<std::string>(), spec, json_dir)
+                        : RISCVExtensionManager::fromELF(elf, spec, json_dir);
+
+    // A DTable is not thread safe, so each worker builds its own (with its own caches), in its
+    // own thread, streaming the ISA files: the tables are built in parallel, and their memory is
+    // local to the worker
+    const std::vector<std::string> & isa_files = extension_manager.getJSONs();
+
+    const SymbolMap symbols = readSymbols(text->getReader());
+    const std::vector<Chunk> chunks = splitText(*text, num_threads, chunk_bytes);
+    uint64_t text_bytes = 0;
+    for (const auto & section : text->getSections())
+    {
+        text_bytes += section.section->get_size();
+    }
+
+    // Workers take chunks in order, so the writer below rarely waits for one. They start once
+    // every decode table is built, so that the throughput is that of disassembly alone
+    std::vector<std::promise<std::string>> results(chunks.size());
+    std::atomic<size_t> next_chunk{0};
+    std::vector<std::future<void>> built;
+    std::promise<void> go;
+    const std::shared_future<void> started = go.get_future().share();
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < num_threads; ++t)
+    {
+        std::promise<void> built_promise;
+        built.emplace_back(built_promise.get_future());
+        workers.emplace_back(
+            [&, built_promise = std::move(built_promise)]() mutable
+            {
+                // A worker whose table fails to build reports the error for its chunks
+                std::unique_ptr<DTableType> dtable;
+                std::exception_ptr build_error;
+                try
+                {
+                    AnnotationAllocator anno_allocator;
+                    auto builder = std::make_shared<BuilderType>(mavis::FileNameListType{},
+                                                                 anno_allocator);
+                    dtable.reset(new DTableType(builder));
+                    dtable->configure(isa_files);
+                    dtable->enableDasmCache(true);
+                }
+                catch (...)
+                {
+                    build_error = std::current_exception();
+                }
+                built_promise.set_value();
+                started.wait();
+
+                for (size_t c = next_chunk++; c < chunks.size(); c = next_chunk++)
+                {
+                    try
+                    {
+                        if (build_error != nullptr)
+                        {
+                            std::rethrow_exception(build_error);
+                        }
+                        results[c].set_value(renderChunk(*dtable, chunks[c], symbols));
+                    }
+                    catch (...)
+                    {
+                        results[c].set_exception(std::current_exception());
+                    }
+                }
+            });
+    }
+    for (auto & b : built)
+    {
+        b.wait();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    go.set_value();
+
+    int rc = 0;
+    const ELFIO::section* section = nullptr;
+    for (size_t c = 0; c < chunks.size(); ++c)
+    {
+        try
+        {
+            const std::string text = results[c].get_future().get();
+            if (stats_only)
+            {
+                continue;
+            }
+            if (chunks[c].section != section)
+            {
+                section = chunks[c].section;
+                std::cout << "\nDisassembly of section " << section->get_name() << ":\n";
+            }
+            std::cout << text;
+        }
+        catch (const std::exception & ex)
+        {
+            std::cerr << "ERROR: " << ex.what() << std::endl;
+            rc = 1;
+        }
+    }
+    std::cout << std::flush;
+
+    for (auto & w : workers)
+    {
+        w.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cerr << "mavis_objdump: " << elf << ": " << text_bytes << " bytes of code in "
+              << chunks.size() << " chunks, " << num_threads << " threads, "
+              << elapsed.count() << " s ("
+              << ((elapsed.count() > 0) ? (text_bytes / 1.0e6) / elapsed.count() : 0.0)
+              << " MB/s)" << std::endl;
+    return rc;
+}
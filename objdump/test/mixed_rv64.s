@@ -0,0 +1,34 @@
+# Code and data in one executable section, with $x/$d mapping symbols (see mavis_objdump_test).
+# Assembled into mixed_rv64.o with
+#   llvm-mc -triple=riscv64 -mattr=+m,+a,+f,+d,+c -filetype=obj mixed_rv64.s -o mixed_rv64.o
+	.attribute arch, "rv64i2p0_m2p0_a2p0_f2p0_d2p0_c2p0"
+	.text
+	.globl	_start
+	.type	_start, @function
+"$x":
+_start:
+	addi	sp, sp, -16
+	sd	ra, 8(sp)
+	lui	a0, 0x12345
+	addiw	a0, a0, 0x678
+	mul	a1, a0, a0
+	c.li	a2, 3
+	fadd.d	fa0, fa1, fa2
+	call	helper
+	ld	ra, 8(sp)
+	addi	sp, sp, 16
+	ret
+	.size	_start, .-_start
+	# Data in .text: listed as .word/.half, not disassembled (the words would decode as nop/jal)
+"$d":
+table:
+	.word	0x00000013
+	.word	0xdeadbeef
+	.half	0x4082
+"$x.1":
+	.type	helper, @function
+helper:
+	c.add	a0, a1
+	amoadd.w	a0, a1, (a2)
+	ret
+	.size	helper, .-helper
@@ -1,9 +1,15 @@
 #include <iostream>
+#include <fstream>
 
 #include "mavis/Mavis.h"
+#include "mavis/FusionMatcher.hpp"
+#include "mavis/UopCracker.hpp"
+#include "mavis/VectorRegGroups.hpp"
+#include "mavis/DecodePipeline.hpp"
 #include "mavis/MatchSet.hpp"
 #include "mavis/Tag.hpp"
 #include "mavis/Pattern.hpp"
+#include "mavis/TagFilter.hpp"
 #include "mavis/ExtractorDirectImplementations.hpp"
 
 #include "Inst.h"
@@ -31,6 +37,20 @@ struct ExampleTraceInfo
 
 using MavisType = Mavis<Instruction<uArchInfo>, uArchInfo>;
 
+// Counts the annotations constructed (see the lazy annotation tests)
+struct CountingAnnotationAllocator
+{
+    using InstTypePtr = uArchInfo::PtrType;
+
+    size_t* count;
+
+    template <typename... Args> uArchInfo::PtrType operator()(Args &&... args)
+    {
+        ++*count;
+        return std::make_shared<uArchInfo>(std::forward<Args>(args)...);
+    }
+};
+
 void runTSet(MavisType & mavis_facade, const std::string & tfile,
              const std::vector<mavis::OpcodeInfo::ISAExtension> isa_list = {})
 {
@@ -1153,6 +1173,12 @@ int main()
     assert(!tset.matchAnyAll(pset));
     assert(tset.matchAllAny(pset));
     assert(!tset.matchAllAll(pset));
+    mavis::TagFilter tfilter(pset, mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"b"}));
+    assert(tfilter.isIncluded(tset));
+    assert(!tfilter.isExcluded(tset));
+    assert(!tfilter.isIncluded(mavis::MatchSet<mavis::Tag>(std::vector<std::string>{"d", "e"})));
+    assert(!tfilter.isExcluded(mavis::MatchSet<mavis::Tag>(std::vector<std::string>{"d", "e"})));
+    assert(tfilter.isExcluded(mavis::MatchSet<mavis::Tag>(std::vector<std::string>{"d", "b"})));
 
     // T0: Create a new context for testing pseudo instructions
     mavis_facade.makeContext("T0", {"uarch/isa_tagged.json"}, {}, {}, {}, {},
@@ -1171,6 +1197,17 @@ int main()
     assert(inst->hasImmediate() == true);
     assert(!inst->getTags().isMember("pf"));
 
+    // T0_SHARED: Same inputs as T0, so it shares T0's decode tables (and UIDs)
+    const mavis::InstructionUniqueID t0_ori_uid = mavis_facade.lookupInstructionUniqueID("ori");
+    mavis_facade.makeContext("T0_SHARED", {"uarch/isa_tagged.json"}, {}, {}, {}, {},
+                             mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"pf"}));
+    mavis_facade.switchContext("T0_SHARED");
+    assert(mavis_facade.lookupInstructionUniqueID("ori") == t0_ori_uid);
+    inst = mavis_facade.makeInst(0x6013, 0);
+    assert(inst != nullptr);
+    assert(inst->getMnemonic() == "ori");
+    assert(inst->getUID() == t0_ori_uid);
+
     // T1: Create a new context for testing pseudo instructions
     mavis_facade.makeContext("T1", {"uarch/isa_tagged.json"}, {}, {}, {}, {},
                              mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"c.*"}));
@@ -1224,6 +1261,45 @@ int main()
 
     mavis_facade.switchContext("BASE");
 
+    // Lazily and asynchronously built contexts
+    mavis_facade.makeContextLazy("T1_LAZY", {"uarch/isa_tagged.json"}, {}, {}, {}, {},
+                                 mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"c.*"}));
+    assert(!mavis_facade.isContextReady("T1_LAZY"));
+    mavis_facade.makeContextAsync("T0_ASYNC", {"uarch/isa_tagged.json"}, {}, {}, {}, {},
+                                  mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"pf"}));
+    mavis_facade.makeContextAsync("T3_ASYNC", {"uarch/isa_tagged.json"}, {}, {}, {},
+                                  mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"zic.*"}),
+                                  mavis::MatchSet<mavis::Pattern>(std::vector<std::string>{"c.*"}));
+
+    // BASE keeps decoding while the others build
+    inst = mavis_facade.makeInst(0x6013, 0);
+    assert(inst != nullptr);
+    assert(inst->getMnemonic() == "prefetch.i");
+
+    mavis_facade.waitForContext("T0_ASYNC");
+    assert(mavis_facade.isContextReady("T0_ASYNC"));
+    mavis_facade.switchContext("T0_ASYNC");
+    inst = mavis_facade.makeInst(0x6013, 0);
+    assert(inst != nullptr);
+    assert(inst->getMnemonic() == "ori");
+
+    mavis_facade.switchContext("T1_LAZY");
+    assert(mavis_facade.isContextReady("T1_LAZY"));
+    inst = mavis_facade.makeInst(0x6013, 0);
+    assert(inst != nullptr);
+    assert(inst->getMnemonic() == "prefetch.i");
+
+    try
+    {
+        mavis_facade.switchContext("T3_ASYNC");
+        assert(false);
+    }
+    catch (const mavis::BuildErrorOverlayBaseNotFound & ex)
+    {
+    }
+
+    mavis_facade.switchContext("BASE");
+
     // prefetch.i should map to prefetch.i here (back to BASE context)
     inst = mavis_facade.makeInst(0x6013, 0);
     assert(inst != nullptr);
@@ -1485,5 +1561,1278 @@ int main()
     assert(inst->getIntDestRegs() == 0x2ull);
     assert(inst->getImmediate() == 32ull);
 
+    //
+    // Test 32-bit Zcmp extension (cm.mva01s instruction): the dests are always a0 and a1
+    //
+    inst = mavis_facade_rv32.makeInst(0xace2, 0);
+    assert(inst->getMnemonic() == "cm.mva01s");
+    assert(inst->getIntDestRegs() == 0xc00ull);
+    assert(inst->getDestOpInfo().getFieldValue(mavis::InstMetaData::OperandFieldID::RD1) == 10);
+    assert(inst->getDestOpInfo().getFieldValue(mavis::InstMetaData::OperandFieldID::RD2) == 11);
+
+    //
+    // Streamed ISA files -- elements are handed over one at a time, and nothing may follow the
+    // array
+    //
+    {
+        const std::string path = "streamed.json";
+        std::ofstream(path) << "[ {\"a\": \"]\"}, [1, {\"b\": \",\\\"\"}], 3 ]\n";
+        std::vector<mavis::json_value> elements;
+        mavis::forEachJSONArrayElement(path, [&elements](mavis::json_value & elem)
+                                       { elements.emplace_back(std::move(elem)); });
+        assert(elements.size() == 3);
+        assert(JSON_GET(elements[0], "a", std::string) == "]");
+        assert(elements[1].is_array());
+        assert(JSON_CAST(elements[2], int) == 3);
+
+        // Only a top-level array streams
+        for (const char* not_array : {"{\"a\": [1]}", "3", ""})
+        {
+            std::ofstream(path) << not_array;
+            try
+            {
+                mavis::forEachJSONArrayElement(path, [](mavis::json_value &) { assert(false); });
+                assert(false);
+            }
+            catch (const std::runtime_error &)
+            {
+            }
+        }
+
+        bool rejected = false;
+        std::ofstream(path) << "[ {\"a\": 1} ] {\"b\": 2}\n";
+        try
+        {
+            mavis::forEachJSONArrayElement(path, [](mavis::json_value &) {});
+        }
+        catch (const std::runtime_error &)
+        {
+            rejected = true;
+        }
+        assert(rejected);
+
+        // Contexts are built by streaming their ISA files, so the same goes for them
+        rejected = false;
+        std::ofstream(path) << std::ifstream("json/isa_rv64i.json").rdbuf() << "]\n";
+        try
+        {
+            MavisType junk_facade(mavis::FileNameListType{path}, {"uarch/uarch_rv64g.json"},
+                                  mavis::InstUIDList{});
+        }
+        catch (const std::runtime_error &)
+        {
+            rejected = true;
+        }
+        assert(rejected);
+        std::remove(path.c_str());
+    }
+
+    //
+    // Lazy annotations -- constructed on first lookup, with the same merge/override results
+    //
+    {
+        const mavis::FileNameListType lazy_isa_files = {"json/isa_rv64i.json", "json/isa_rv64m.json",
+                                                        "json/isa_rv64zmmul.json", "json/isa_rv64zca.json"};
+        const mavis::MatchSet<mavis::Pattern> no_patterns;
+        MavisType eager_facade(lazy_isa_files, {"uarch/uarch_rv64g.json"}, uid_init, anno_overrides,
+                               no_patterns, no_patterns);
+        MavisType lazy_facade(lazy_isa_files, {"uarch/uarch_rv64g.json"}, uid_init, anno_overrides,
+                              no_patterns, no_patterns,
+                              mavis::SharedPtrAllocator<Instruction<uArchInfo>>(),
+                              mavis::SharedPtrAllocator<uArchInfo>(), mavis::AnnotationLoadMode::LAZY);
+
+        const auto anno_string = [](MavisType & facade, const mavis::Opcode icode)
+        {
+            std::ostringstream os;
+            os << *facade.makeInst(icode, 0)->getuArchInfo();
+            return os.str();
+        };
+        // add, srai, mul, c.addi
+        for (const mavis::Opcode icode : {0x003100b3ull, 0x4020d093ull, 0x023100b3ull, 0x0505ull})
+        {
+            assert(anno_string(eager_facade, icode) == anno_string(lazy_facade, icode));
+        }
+        assert(lazy_facade.makeInst(0x4020d093, 0)->getuArchInfo()->isROBGrpStart());
+
+        using AnnoRegistry = mavis::AnnotationRegistry<uArchInfo, mavis::SharedPtrAllocator<uArchInfo>>;
+        mavis::SharedPtrAllocator<uArchInfo> anno_allocator;
+        AnnoRegistry lazy_registry({"uarch/uarch_rv64g.json"}, anno_allocator, {},
+                                   mavis::AnnotationLoadMode::LAZY);
+        assert(lazy_registry.isPopulated());
+        const auto anno_add = lazy_registry.findAnnotation("add");
+        assert(anno_add != nullptr);
+        assert(lazy_registry.findAnnotation("add") == anno_add);
+        assert(lazy_registry.findAnnotation("not_an_instruction", true) == nullptr);
+
+        // Building a context does not look up the annotations of its instructions: a leaf
+        // factory looks up each instruction's annotation the first time it decodes it
+        size_t constructed = 0;
+        Mavis<Instruction<uArchInfo>, uArchInfo, mavis::SharedPtrAllocator<Instruction<uArchInfo>>,
+              CountingAnnotationAllocator>
+            counted_facade(lazy_isa_files, {"uarch/uarch_rv64g.json"}, uid_init, anno_overrides,
+                           no_patterns, no_patterns,
+                           mavis::SharedPtrAllocator<Instruction<uArchInfo>>(),
+                           CountingAnnotationAllocator{&constructed},
+                           mavis::AnnotationLoadMode::LAZY);
+        const size_t built = constructed;
+        assert(built < 8);
+        const auto add_anno = counted_facade.makeInst(0x003100b3, 0)->getuArchInfo();
+        assert(constructed == (built + 1));
+        assert(counted_facade.makeInst(0x003100b3, 0)->getuArchInfo() == add_anno);
+        counted_facade.makeInst(0x403100b3, 0); // sub
+        assert(constructed == (built + 2));
+        assert(anno_string(eager_facade, 0x403100b3) == [&]
+               {
+                   std::ostringstream os;
+                   os << *counted_facade.makeInst(0x403100b3, 0)->getuArchInfo();
+                   return os.str();
+               }());
+    }
+
+    //
+    // DecodedView -- same decode information as the instruction, without allocation
+    //
+    {
+        MavisType view_facade({"json/isa_rv64i.json", "json/isa_rv64m.json", "json/isa_rv64zca.json",
+                               "json/isa_rv64zve32x.json"},
+                              {"uarch/uarch_rv64g.json"});
+        // add, lw, c.addi, jalr (return), vadd.vv
+        for (const mavis::Opcode icode : {0x003100b3ull, 0x0082a303ull, 0x0505ull, 0x00008067ull,
+                                          0x022080d7ull})
+        {
+            const auto inst = view_facade.makeInst(icode, 0);
+            const mavis::DecodedView<uArchInfo> view = view_facade.getDecodedView(icode);
+            assert(view.getOpcode() == icode);
+            assert(view.getInstructionUniqueID() == inst->getUID());
+            assert(view.getIntSourceRegs() == inst->getIntSourceRegs().to_ullong());
+            assert(view.getIntDestRegs() == inst->getIntDestRegs().to_ullong());
+            assert(view.getVectorSourceRegs() == inst->getVectorSourceRegs().to_ullong());
+            assert(view.hasImmediate() == inst->hasImmediate());
+            assert(!view.hasImmediate() || (view.getImmediate() == inst->getImmediate()));
+            assert(view.getAnnotation() == inst->getuArchInfo().get());
+            assert(view.numSourceOperands() == inst->getSourceOpInfoList().size());
+            assert(view.numDestOperands() == inst->getDestOpInfoList().size());
+            for (uint32_t i = 0; i < view.numSourceOperands(); ++i)
+            {
+                assert(view.getSourceOperand(i).field_value == inst->getSourceOpInfoList()[i].field_value);
+            }
+            assert(view_facade.getDecodedView(icode).getOpcode() == icode);
+        }
+        assert(view_facade.getDecodedView(0x00008067).isExtractedInstType(
+            mavis::OpcodeInfo::ExtractedInstTypes::RETURN));
+
+        // Views are handles into the view cache: one held across a context switch stays valid,
+        // and goes stale once its line is reused for another opcode, or after a flush
+        static_assert(sizeof(mavis::DecodedView<uArchInfo>) == 2 * sizeof(uint64_t));
+        const auto held_view = view_facade.getDecodedView(0x003100b3);
+        view_facade.makeContext("VIEW_ALT", {"json/isa_rv64i.json"}, {"uarch/uarch_rv64g.json"});
+        view_facade.switchContext("VIEW_ALT");
+        view_facade.switchContext("BASE");
+        assert(held_view.isValid() && (held_view.getOpcode() == 0x003100b3));
+        const mavis::Opcode same_line = 0x00330033; // add x0,x6,x3: the same line (mod 1023)
+        assert(view_facade.getDecodedView(same_line).getOpcode() == same_line);
+        assert(!held_view.isValid());
+        const auto refetched_view = view_facade.getDecodedView(0x003100b3);
+        assert(refetched_view.isValid() && (refetched_view.getIntSourceRegs() == 0xc));
+        view_facade.flushCaches();
+        assert(!refetched_view.isValid());
+        assert(view_facade.getDecodedView(0x003100b3).isValid());
+    }
+
+    //
+    // Opcode classification -- UID and type bits agree with the full decode
+    //
+    {
+        // add, lw, sw, beq, jalr (call), c.addi, c.ld
+        for (const mavis::Opcode icode : {0x003100b3ull, 0x0082a303ull, 0x0062a423ull, 0x00208463ull,
+                                          0x000280e7ull, 0x0505ull, 0x6398ull})
+        {
+            const auto info = mavis_facade.getInfo(icode);
+            const mavis::OpcodeClass & oclass = mavis_facade.getOpcodeClass(icode);
+            assert(oclass.icode == icode);
+            assert(oclass.uid == info->opinfo->getInstructionUniqueID());
+            assert(mavis_facade.lookupOpcodeUniqueID(icode) == info->opinfo->getInstructionUniqueID());
+            assert(oclass.inst_types == info->opinfo->getInstType());
+            for (const auto itype : {MavisType::InstructionType::LOAD, MavisType::InstructionType::STORE,
+                                     MavisType::InstructionType::BRANCH, MavisType::InstructionType::JALR})
+            {
+                assert(mavis_facade.isOpcodeInstType(icode, itype) == info->opinfo->isInstType(itype));
+            }
+            assert(mavis_facade.isOpcodeExtractedInstType(icode, MavisType::ExtractedInstType::CALL)
+                   == info->opinfo->isExtractedInstType(MavisType::ExtractedInstType::CALL));
+        }
+        assert(mavis_facade.lookupOpcodeUniqueID(0x003100b3) == mavis_facade.lookupInstructionUniqueID("add"));
+    }
+
+    //
+    // Prepared direct-creation handles -- same instructions as the unprepared calls
+    //
+    {
+        const auto prepared_add = mavis_facade.prepareInstDirectly("add");
+        const auto prepared_sw = mavis_facade.prepareInstDirectly(mavis_facade.lookupInstructionUniqueID("sw"));
+        for (uint32_t r = 1; r < 4; ++r)
+        {
+            const mavis::ExtractorDirectInfo add_info("add", {r, r + 1}, {r + 2});
+            const auto expected = mavis_facade.makeInstDirectly(add_info, 0);
+            const auto actual = mavis_facade.makeInstDirectly(prepared_add, add_info, 0);
+            assert(actual->dasmString() == expected->dasmString());
+            assert(actual->getUID() == expected->getUID());
+            assert(actual->getuArchInfo() == expected->getuArchInfo());
+            assert(actual->getIntSourceRegs() == expected->getIntSourceRegs());
+
+            const mavis::ExtractorDirectInfo_Stores sw_info("sw", {r}, {r + 1});
+            assert(mavis_facade.makeInstDirectly(prepared_sw, sw_info, 0)->dasmString()
+                   == mavis_facade.makeInstDirectly(sw_info, 0)->dasmString());
+        }
+
+        // The decoded info of a freed instruction is reused by the next one
+        const mavis::ExtractorDirectInfo recycled_info("add", {5, 6}, {7});
+        auto recycled = mavis_facade.makeInstDirectly(prepared_add, recycled_info, 0);
+        const mavis::OpcodeInfo* recycled_opinfo = recycled->getOpInfo().get();
+        recycled.reset();
+        recycled = mavis_facade.makeInstDirectly(prepared_add, recycled_info, 0);
+        assert(recycled->getOpInfo().get() == recycled_opinfo);
+        assert(recycled->dasmString() == mavis_facade.makeInstDirectly(recycled_info, 0)->dasmString());
+
+        mavis_facade.switchContext("PSEUDO");
+        const auto prepared_p0 = mavis_facade.preparePseudoInst("P0");
+        const mavis::ExtractorDirectInfo p0_info("P0", {1, 2}, {3});
+        const auto p0 = mavis_facade.makePseudoInst(prepared_p0, p0_info, 0);
+        assert(p0->dasmString() == mavis_facade.makePseudoInst(p0_info, 0)->dasmString());
+        assert(p0->getSourceOpInfo().getFieldType(mavis::InstMetaData::OperandFieldID::RS2)
+               == mavis::OpcodeInfo::OperandTypes::DOUBLE);
+        try
+        {
+            mavis_facade.preparePseudoInst("not_a_pseudo_inst");
+            assert(false);
+        }
+        catch (const mavis::UnknownPseudoMnemonic &)
+        {
+        }
+        mavis_facade.switchContext("BASE");
+    }
+
+    //
+    // Trace mismatches -- resolved once per (opcode, trace mnemonic), and the decode of the opcode
+    // itself is unaffected
+    //
+    {
+        ExampleTraceInfo trace_add{"add", 0x003100b3};
+        ExampleTraceInfo trace_sub{"sub", 0x003100b3};
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            const auto matched = mavis_facade.makeInstFromTrace(trace_add, 0);
+            assert(matched->getMnemonic() == "add");
+            const auto mismatched = mavis_facade.makeInstFromTrace(trace_sub, 0);
+            assert(mismatched->getMnemonic() == "sub");
+            assert(mismatched->getUID() == mavis_facade.lookupInstructionUniqueID("sub"));
+            assert(mavis_facade.makeInst(0x003100b3, 0)->getMnemonic() == "add");
+        }
+
+        // Each record of a mismatch has its own operands; a Symbol mnemonic works as well
+        struct SymbolTraceInfo
+        {
+            mavis::Symbol mnemonic;
+            uint64_t opcode;
+            uint64_t dests;
+
+            const mavis::Symbol & getMnemonic() const { return mnemonic; }
+
+            uint64_t getOpcode() const { return opcode; }
+
+            uint64_t getFunction() const { return 0; }
+
+            uint64_t getSourceRegs() const { return 0x6; }
+
+            uint64_t getDestRegs() const { return dests; }
+
+            uint64_t getImmediate() const { return 0; }
+        };
+        for (const uint32_t rd : {1, 5, 1})
+        {
+            const auto sub = mavis_facade.makeInstFromTrace(
+                SymbolTraceInfo{mavis::Symbol("sub"), 0x003100b3, 1ull << rd}, 0);
+            assert(sub->getMnemonic() == "sub");
+            assert(sub->getDestOpInfoList().size() == 1);
+            assert(sub->getDestOpInfoList()[0].field_value == rd);
+            assert(sub->getOpInfo()->getOpcode() == 0x003100b3);
+        }
+    }
+
+    //
+    // Interned mnemonics and perfect-hash name lookups
+    //
+    {
+        const mavis::Symbol add_sym("add");
+        assert(add_sym == mavis::Symbol(std::string("add")));
+        assert(&add_sym.str() == &mavis::Symbol(std::string_view("add")).str());
+        assert((add_sym != mavis::Symbol("sub")) && (add_sym == "add") && (add_sym != "sub"));
+
+        // Every decode of an add shares the one interned mnemonic
+        const auto add_a = mavis_facade.makeInst(0x003100b3, 0);
+        const auto add_b = mavis_facade.makeInst(0x00628233, 0);
+        assert(&add_a->getOpInfo()->getMnemonic() == &add_b->getOpInfo()->getMnemonic());
+        assert(&add_a->getOpInfo()->getMnemonic() == &add_sym.str());
+
+        const std::string_view sub_name = std::string_view("subtract").substr(0, 3);
+        assert(mavis_facade.lookupInstructionUniqueID(sub_name) == mavis_facade.lookupInstructionUniqueID("sub"));
+        assert(mavis_facade.lookupInstructionUniqueID("not_an_inst") == mavis::INVALID_UID);
+
+        std::map<std::string, uint32_t, std::less<>> names;
+        for (uint32_t i = 0; i < 500; ++i)
+        {
+            names.emplace("inst" + std::to_string(i), i);
+        }
+        mavis::PerfectHashIndex<uint32_t> index;
+        assert(!index.isBuilt() && (index.find("inst0") == nullptr));
+        index.build(names);
+        for (const auto & [name, value] : names)
+        {
+            assert((index.find(name) != nullptr) && (*index.find(name) == value));
+        }
+        assert((index.find("inst500") == nullptr) && (index.find("") == nullptr));
+    }
+
+    //
+    // Disassembly into caller buffers -- same text as dasmString(), with and without the
+    // per-opcode cache
+    //
+    {
+        const std::vector<mavis::Opcode> opcodes = {0x003100b3, 0xd3ad, 0xe152, 0x4081, 0x0d0572d7};
+        char buf[128];
+        for (uint32_t pass = 0; pass < 3; ++pass)
+        {
+            mavis_facade.enableDasmCache(pass != 0);
+            for (const auto icode : opcodes)
+            {
+                const std::string expected = mavis_facade.makeInst(icode, 0)->dasmString();
+                assert(mavis_facade.dasmTo(icode, buf, sizeof(buf)) == expected.size());
+                assert(expected == buf);
+            }
+        }
+
+        // Truncation: snprintf semantics
+        const std::string add_dasm = mavis_facade.makeInst(0x003100b3, 0)->dasmString();
+        assert(mavis_facade.dasmTo(0x003100b3, buf, 4) == add_dasm.size());
+        assert(add_dasm.substr(0, 3) == buf);
+        assert(mavis_facade.dasmTo(0x003100b3, nullptr, 0) == add_dasm.size());
+        mavis_facade.enableDasmCache(false);
+
+        mavis::DasmWriter os(buf, sizeof(buf));
+        os << "x" << 10 << std::hex << " 0x" << 255 << " " << int64_t(-1) << std::dec << " "
+           << int64_t(-12);
+        assert(os.view() == "x10 0xff ffffffffffffffff -12");
+    }
+
+    //
+    // Inline operand and register lists
+    //
+    {
+        // cm.push {ra, s0-s11}: the longest operand list
+        mavis_facade_rv32.switchContext("ZCMP_ZCMT");
+        const auto push = mavis_facade_rv32.makeInst(0xb8f2, 0);
+        assert(push->getMnemonic() == "cm.push");
+        const auto & push_srcs = push->getOpInfo()->getSourceOpInfoList();
+        assert(&push_srcs == &push->getOpInfo()->getSourceOpInfo().getElements());
+        assert((push_srcs.size() == 14) && (push_srcs.size() <= push_srcs.inline_capacity()));
+        assert(push_srcs.at(0).field_id == mavis::InstMetaData::OperandFieldID::RS1);
+
+        // A DecodedView holds the longest operand list too
+        const auto push_view = mavis_facade_rv32.getDecodedView(0xb8f2);
+        assert(push_view.numSourceOperands() == push_srcs.size());
+        for (uint32_t i = 0; i < push_view.numSourceOperands(); ++i)
+        {
+            assert(push_view.getSourceOperand(i).field_value == push_srcs[i].field_value);
+        }
+        assert(push_view.getIntSourceRegs() == push->getIntSourceRegs().to_ullong());
+
+        mavis::ExtractorIF::RegListType regs = {1, 8};
+        const mavis::ExtractorIF::RegListType more_regs = {2, 9};
+        mavis::ExtractorIF::RegListType merged;
+        std::merge(regs.begin(), regs.end(), more_regs.begin(), more_regs.end(),
+                   std::back_inserter(merged));
+        assert((merged == mavis::ExtractorIF::RegListType{1, 2, 8, 9}) && (merged != regs));
+        regs = merged;
+        assert((regs.size() == 4) && (regs.back() == 9));
+
+        // Past the inline capacity, a list moves to the heap
+        for (uint32_t i = 0; i <= regs.inline_capacity(); ++i)
+        {
+            regs.push_back(regs[i]);
+        }
+        assert((regs.size() == 21) && (regs.capacity() > regs.inline_capacity()));
+        assert((regs[4] == 1) && (regs[7] == 9) && (regs[20] == 1));
+        const mavis::ExtractorIF::RegListType regs_copy = regs;
+        assert(regs_copy == regs);
+        mavis::ExtractorIF::RegListType regs_moved = std::move(merged);
+        regs_moved = std::move(regs);
+        assert((regs_moved == regs_copy) && regs.empty());
+
+        // Direct instructions with register masks wider than the inline lists
+        const auto wide = mavis_facade.makeInstDirectly(
+            mavis::ExtractorDirectInfoBitMask("add", 0xfffffffffffffffeull, 0x8), 0);
+        assert(wide->getSourceOpInfoList().size() == 63);
+        assert(wide->getSourceOpInfoList()[62].field_value == 63);
+        assert(wide->getIntSourceRegs().to_ullong() == 0xfffffffffffffffeull);
+        const auto wide_stores = mavis_facade.makeInstDirectly(
+            mavis::ExtractorDirectInfoBitMask_Stores("sd", 0x3fffeull, 0x3fffe0000ull), 0);
+        assert(wide_stores->getSourceOpInfoList().size() == 34);
+    }
+
+    //
+    // Decoded basic-block cache
+    //
+    {
+        // addi x1,x0,1; c.addi x1,1; add x3,x1,x2; beq x1,x2,+8 | ret
+        std::vector<uint16_t> code = {0x0093, 0x0010, 0x0085, 0x81b3, 0x0020,
+                                      0x8463, 0x0020, 0x8067, 0x0000};
+        const uint64_t base = 0x1000;
+        uint32_t fetches = 0;
+        const auto fetch = [&](uint64_t addr) -> uint32_t
+        {
+            ++fetches;
+            const uint64_t idx = (addr - base) / 2;
+            return code.at(idx) | ((idx + 1 < code.size()) ? (uint32_t(code[idx + 1]) << 16) : 0);
+        };
+
+        const auto & block = mavis_facade.getBlock(base, fetch, 0);
+        assert((block.pc == base) && (block.insts.size() == 4) && (fetches == 4));
+        assert((block.insts[1].offset == 4) && (block.insts[1].size == 2));
+        assert(block.insts[2].inst->getMnemonic() == "add");
+        assert(block.ends_in_control_flow && block.has_target);
+        assert((block.getFallThrough() == 0x100e) && (block.getTarget() == 0x1012));
+
+        const auto & ret_block = mavis_facade.getBlock(block.getFallThrough(), fetch, 0);
+        assert((ret_block.insts.size() == 1) && ret_block.ends_in_control_flow);
+        assert(!ret_block.has_target);
+
+        // Hits fetch nothing
+        assert(&mavis_facade.getBlock(base, fetch, 0) == &block);
+        assert(fetches == 5);
+
+        // Rewrite the add into a sub: only the block holding it is invalidated
+        code[4] = 0x4020;
+        mavis_facade.invalidateBlocks(0x1006, 0x100a);
+        assert(&mavis_facade.getBlock(0x100e, fetch, 0) == &ret_block);
+        assert(mavis_facade.getBlock(base, fetch, 0).insts[2].inst->getMnemonic() == "sub");
+        assert(fetches == 9);
+
+        // Blocks are per context: without C, the block ends before the c.addi
+        mavis_facade.switchContext("PSEUDO");
+        const auto & rv64i_block = mavis_facade.getBlock(base, fetch, 0);
+        assert((rv64i_block.insts.size() == 1) && !rv64i_block.ends_in_control_flow);
+        mavis_facade.switchContext("BASE");
+        assert(mavis_facade.getBlock(base, fetch, 0).insts.size() == 4);
+
+        mavis_facade.flushBlocks();
+        fetches = 0;
+        mavis_facade.getBlock(base, fetch, 0);
+        assert(fetches == 4);
+    }
+
+    //
+    // Macro-op fusion
+    //
+    {
+        mavis_facade.makeContext("FUSION", {"json/isa_rv64i.json", "uarch/isa_fusion.json"},
+                                 {"uarch/uarch_rv64g.json", "uarch/uarch_fusion.json"});
+        mavis_facade.switchContext("FUSION");
+        const mavis::FusionMatcher<MavisType> fusion(mavis_facade, "uarch/fusion_rv64.json");
+
+        // c_mv_add: not in this context (no C)
+        assert(fusion.numRules() == 3);
+
+        // lui x5,0x12345; addi x5,x5,0x678; ld x10,0(x2); ld x11,8(x2); slli x6,x6,32;
+        // srli x6,x6,32; add x7,x5,x6
+        std::vector<MavisType::InstPtrType> insts;
+        for (const mavis::Opcode icode : {0x123452b7, 0x67828293, 0x00013503, 0x00813583,
+                                          0x02031313, 0x02035313, 0x006283b3})
+        {
+            insts.emplace_back(mavis_facade.makeInst(icode, 0));
+        }
+
+        const auto lui_addi = fusion.match(insts.begin(), insts.end(), 0);
+        assert((lui_addi.inst != nullptr) && (lui_addi.length == 2));
+        assert(*lui_addi.name == "lui_addi");
+        assert(lui_addi.inst->getMnemonic() == "fused.lui_addi");
+        assert(lui_addi.inst->getDestOpInfo().getFieldValue(mavis::InstMetaData::OperandFieldID::RD)
+               == 5);
+        assert(lui_addi.inst->getSourceOpInfoList().empty());
+        assert(lui_addi.inst->getOpInfo()->getImmediate() == 0x12345678);
+        // lui x5,0x12345; addi x5,x5,-1
+        const std::vector<MavisType::InstPtrType> lui_addi_neg = {
+            mavis_facade.makeInst(0x123452b7, 0), mavis_facade.makeInst(0xfff28293, 0)};
+        assert(fusion.match(lui_addi_neg.begin(), lui_addi_neg.end(), 0)
+                   .inst->getOpInfo()
+                   ->getImmediate()
+               == 0x12344fff);
+
+        // addi x5,x5,0x678 does not start a rule
+        assert(fusion.match(insts.begin() + 1, insts.end(), 0).inst == nullptr);
+
+        const auto ld_pair = fusion.match(insts.begin() + 2, insts.end(), 0);
+        assert((ld_pair.length == 2) && (*ld_pair.name == "ld_pair"));
+        assert(ld_pair.inst->getDestOpInfoList().size() == 2);
+        assert(ld_pair.inst->getDestOpInfo().getFieldValue(mavis::InstMetaData::OperandFieldID::RD)
+               == 11);
+        assert(ld_pair.inst->getDestOpInfo().getFieldValue(
+                   mavis::InstMetaData::OperandFieldID::FUSED_RD_0)
+               == 10);
+        assert((ld_pair.inst->getSourceOpInfoList().size() == 1)
+               && (ld_pair.inst->getSourceOpInfoList()[0].field_value == 2));
+        assert(ld_pair.inst->getOpInfo()->getImmediate() == 0);
+        // ld x10,8(x2); ld x11,16(x2) fuses at offset 8; ld x10,0(x2); ld x11,100(x2) and
+        // ld x10,8(x2); ld x11,0(x2) are not adjacent doublewords
+        const auto ld_ld = [&mavis_facade, &fusion](mavis::Opcode icode0, mavis::Opcode icode1)
+        {
+            const std::vector<MavisType::InstPtrType> pair = {mavis_facade.makeInst(icode0, 0),
+                                                              mavis_facade.makeInst(icode1, 0)};
+            return fusion.match(pair.begin(), pair.end(), 0);
+        };
+        assert(ld_ld(0x00813503, 0x01013583).inst->getOpInfo()->getImmediate() == 8);
+        assert(ld_ld(0x00013503, 0x06413583).inst == nullptr);
+        assert(ld_ld(0x00813503, 0x00013583).inst == nullptr);
+
+        const auto fused = fusion.fuse(insts, 0);
+        assert(fused.size() == 4);
+        assert(fused[2]->getMnemonic() == "fused.zext_w");
+        assert(fused[2]->getSourceOpInfo().getFieldValue(mavis::InstMetaData::OperandFieldID::RS1)
+               == 6);
+        assert(fused[3] == insts[6]);
+
+        // Register checks: ld x2,0(x2) overwrites the base of the second load
+        insts[2] = mavis_facade.makeInst(0x00013103, 0);
+        assert(fusion.match(insts.begin() + 2, insts.end(), 0).inst == nullptr);
+        // srli by 31 is not zext.w
+        insts[5] = mavis_facade.makeInst(0x01f35313, 0);
+        assert(fusion.fuse(insts, 0).size() == 6);
+
+        mavis_facade.switchContext("BASE");
+    }
+
+    //
+    // Micro-op cracking
+    //
+    {
+        mavis_facade_rv32.switchContext("ZCMP_ZCMT");
+        mavis::UopCracker<MavisType> cracker(mavis_facade_rv32, "uarch/crack_rv32.json");
+        assert(cracker.numRules() == 4);
+        const auto reg = [](const mavis::OperandInfo & oi, mavis::InstMetaData::OperandFieldID fid)
+        { return oi.getFieldValue(fid); };
+        using FieldID = mavis::InstMetaData::OperandFieldID;
+
+        // cm.push {ra, s0}, -32: sw ra,-8(sp); sw s0,-4(sp); addi sp,sp,-32
+        const auto & push = cracker.crack(0xb856);
+        assert(push.size() == 3);
+        assert((push[0]->getMnemonic() == "sw") && (push[0]->getSignedOffset() == -8));
+        assert(reg(push[0]->getSourceOpInfo(), FieldID::RS2) == 1);
+        assert(push[0]->getSourceOpInfo().getElements()[1].is_store_data);
+        assert((reg(push[1]->getSourceOpInfo(), FieldID::RS2) == 8)
+               && (push[1]->getSignedOffset() == -4));
+        assert((push[2]->getMnemonic() == "addi") && (push[2]->getSignedOffset() == -32));
+        assert(reg(push[2]->getDestOpInfo(), FieldID::RD) == 2);
+
+        // Cached per opcode
+        assert(&cracker.crack(0xb856) == &push);
+        assert(&cracker.crack(mavis_facade_rv32.makeInst(0xb856, 0)->getOpInfo()) == &push);
+
+        // cm.popretz {ra, s0}, 16: lw ra,8(sp); lw s0,12(sp); addi sp,sp,16; li a0,0; ret
+        const auto & popretz = cracker.crack(0xbc52);
+        assert(popretz.size() == 5);
+        assert((reg(popretz[1]->getDestOpInfo(), FieldID::RD) == 8)
+               && (popretz[1]->getSignedOffset() == 12));
+        assert(popretz[2]->getSignedOffset() == 16);
+        assert(reg(popretz[3]->getDestOpInfo(), FieldID::RD) == 10);
+        assert(popretz[4]->getMnemonic() == "jalr");
+
+        // cm.mva01s s1, s0: mv a0,s1; mv a1,s0
+        const auto & mva01s = cracker.crack(0xace2);
+        assert(mva01s.size() == 2);
+        assert(mavis_facade_rv32.makeInst(0xace2, 0)->getIntDestRegs() == 0xc00);
+        assert((reg(mva01s[1]->getSourceOpInfo(), FieldID::RS1) == 8)
+               && (reg(mva01s[1]->getDestOpInfo(), FieldID::RD) == 11));
+
+        // Instructions made directly (all with opcode 0) are cracked every time
+        const auto direct_mva01s = [&](const uint32_t r1s, const uint32_t r2s)
+        {
+            const mavis::ExtractorDirectInfo ex_info("cm.mva01s", {r1s, r2s}, {10, 11});
+            return mavis_facade_rv32.makeInstDirectly(ex_info, 0)->getOpInfo();
+        };
+        assert(reg(cracker.crack(direct_mva01s(9, 8))[0]->getSourceOpInfo(), FieldID::RS1) == 9);
+        assert(reg(cracker.crack(direct_mva01s(18, 19))[0]->getSourceOpInfo(), FieldID::RS1)
+               == 18);
+
+        // Zilsd ld x10, 8(x2): lw x10,8(x2); lw x11,12(x2)
+        const auto & ld_pair = cracker.crack(0x00813503);
+        assert((ld_pair.size() == 2) && (ld_pair[1]->getSignedOffset() == 12));
+        assert(reg(ld_pair[1]->getDestOpInfo(), FieldID::RD) == 11);
+
+        // add x1, x2, x3 is not cracked
+        assert(cracker.crack(0x003100b3).empty());
+
+        // vlseg3e8.v v4, (x5): a load per field
+        mavis::UopCracker<MavisType> vcracker(mavis_facade, "uarch/crack_rv64.json");
+        const auto & vlseg = vcracker.crack(0x42028207);
+        assert(vlseg.size() == 3);
+        assert(reg(vlseg[2]->getDestOpInfo(), FieldID::RD) == 6);
+        assert(vcracker.crack(0x02028207).size() == 1);
+
+        vcracker.clear();
+        assert(vcracker.crack(0x42028207).size() == 3);
+
+        // A rule that fails when cracking caches nothing: it fails again (add has no rs3)
+        const std::string bad_rules = "crack_bad.json";
+        std::ofstream(bad_rules) << "[ {\"crack\" : \"add\", \"uops\" : [ {\"uop\" : \"addi\", "
+                                    "\"sources\" : [[\"rs1\", \"rs3\"]], \"dests\" : [[\"rd\", \"rd\"]]} ] } ]\n";
+        mavis::UopCracker<MavisType> bad_cracker(mavis_facade, bad_rules);
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            bool caught = false;
+            try
+            {
+                bad_cracker.crack(0x003100b3);
+            }
+            catch (const mavis::BadCrackRule &)
+            {
+                caught = true;
+            }
+            assert(caught);
+        }
+        std::remove(bad_rules.c_str());
+    }
+
+    //
+    // vtype-aware vector register groups
+    //
+    {
+        mavis_facade.switchContext("BASE");
+        mavis::VectorRegGroupExpander expander;
+
+        // vsetvli x5, x6, e16,m2,ta,ma
+        const auto vsetvli = mavis_facade.makeInst(0x0c9372d7, 0);
+        const mavis::VType e16m2 = mavis::VType::fromImmediate(vsetvli->getOpInfo()->getImmediate());
+        assert((e16m2.sew == 16) && (e16m2.lmul_log2 == 1) && e16m2.ta && e16m2.ma);
+        assert(mavis::VType::fromImmediate(e16m2.encode()).encode() == e16m2.encode());
+        const mavis::VType e8m8 = mavis::VType::fromImmediate(0x3);
+        const mavis::VType e32mf2 = mavis::VType::fromImmediate(0x17);
+        assert((e32mf2.sew == 32) && (e32mf2.lmul_log2 == -1));
+
+        const auto groups = [&](mavis::Opcode icode, const mavis::VType & vtype)
+        { return expander.expand(mavis_facade.getInfo(icode)->opinfo, vtype); };
+
+        // vadd.vv v4, v8, v16
+        auto g = groups(0x02880257, e16m2);
+        assert(!g.illegal && (g.sources.size() == 2) && (g.dests.size() == 1));
+        assert((g.source_mask == 0x30300) && (g.dest_mask == 0x30));
+        assert(g.dests[0].field_id == mavis::InstMetaData::OperandFieldID::RD);
+
+        // vwadd.wv v4, v8, v16: 2*SEW vd and vs2
+        g = groups(0xd6882257, e16m2);
+        assert((g.dest_mask == 0xf0) && (g.source_mask == 0x30f00));
+
+        // vnsrl.wv v4, v8, v16: 2*SEW vs2
+        g = groups(0xb2880257, e16m2);
+        assert((g.dest_mask == 0x30) && (g.source_mask == 0x30f00));
+
+        // vzext.vf4 v4, v8: EMUL 1/2
+        g = groups(0x4a822257, e16m2);
+        assert((g.dest_mask == 0x30) && (g.source_mask == 0x100));
+
+        // vmseq.vv v4, v8, v16, v0.t: mask dest, and v0
+        g = groups(0x60880257, e16m2);
+        assert((g.dest_mask == 0x10) && (g.source_mask == 0x30301) && (g.sources.size() == 3));
+
+        // vredsum.vs v4, v8, v16
+        g = groups(0x02882257, e16m2);
+        assert((g.dest_mask == 0x10) && (g.source_mask == 0x10300));
+
+        // vle16.v v4, (x16): EEW 16; vlseg3e16.v: three fields
+        assert(groups(0x02085207, e16m2).dest_mask == 0x30);
+        assert(groups(0x02085207, e32mf2).dest_mask == 0x10);
+        assert(groups(0x42085207, e16m2).dest_mask == 0x3f0);
+
+        // vluxei16.v v4, (x16), v8: EEW 16 index, SEW data
+        g = groups(0x06885207, e32mf2);
+        assert((g.source_mask == 0x100) && (g.dest_mask == 0x10));
+
+        // vl2re16.v v4, (x16) and vmv2r.v v4, v8: whatever the vtype
+        assert(groups(0x22885207, e32mf2).dest_mask == 0x30);
+        g = groups(0x9e80b257, e8m8);
+        assert(!g.illegal && (g.dest_mask == 0x30) && (g.source_mask == 0x300));
+
+        // EMUL 16, misaligned groups, and vill
+        assert(groups(0xd6882257, e8m8).illegal);
+        assert(groups(0x02880257, e8m8).illegal);
+        assert(mavis::VType::fromImmediate(0x4).vill);
+        assert(groups(0x02880257, mavis::VType::fromImmediate(0x4)).illegal);
+
+        // Scalar instructions have no groups
+        g = groups(0x003100b3, e16m2);
+        assert(g.sources.empty() && g.dests.empty() && !g.illegal);
+    }
+
+    //
+    // Shared decode nodes: contexts with different ISA files share their equal leaves, subtrees
+    // and metadata
+    //
+    {
+        const mavis::FileNameListType rv64i_files = {"json/isa_rv64i.json"};
+        const mavis::FileNameListType rv64im_files = {"json/isa_rv64i.json", "json/isa_rv64m.json"};
+        MavisType share_facade(rv64i_files, {"uarch/uarch_rv64g.json"}, mavis::InstUIDList{});
+        assert(share_facade.getNumSharedDecodeNodes() == 0);
+
+        // With UIDs of its own, a context only shares metadata
+        share_facade.makeContext("OWN_UIDS", rv64im_files, {"uarch/uarch_rv64g.json"});
+        const size_t num_metas = share_facade.getNumSharedDecodeNodes();
+        assert(num_metas > 0);
+
+        // With the same UIDs, the rv64i leaves and subtrees are shared too
+        share_facade.makeContext("SAME_UIDS", rv64im_files, {"uarch/uarch_rv64g.json"},
+                                 share_facade.getInstUIDList());
+        assert((share_facade.getNumSharedDecodeNodes() - num_metas) > (2 * num_metas));
+
+        // Shared or not, every context decodes as one built on its own
+        MavisType own_facade(rv64im_files, {"uarch/uarch_rv64g.json"}, mavis::InstUIDList{});
+        const auto decode = [](MavisType & facade, const mavis::Opcode icode)
+        {
+            std::ostringstream os;
+            const auto inst = facade.makeInst(icode, 0);
+            os << inst->dasmString() << " " << *inst->getuArchInfo();
+            return os.str();
+        };
+        // add, addi, mv, lw, sd, beq, div, remw
+        for (const mavis::Opcode icode : {0x003100b3ull, 0x00110093ull, 0x00010093ull, 0x0082a303ull,
+                                          0x00b13423ull, 0x00208463ull, 0x0220c0b3ull, 0x0220e0bbull})
+        {
+            for (const char* context : {"OWN_UIDS", "SAME_UIDS"})
+            {
+                share_facade.switchContext(context);
+                assert(decode(share_facade, icode) == decode(own_facade, icode));
+            }
+        }
+        const mavis::Opcode add = 0x003100b3;
+        const auto add_uid = share_facade.makeInst(add, 0)->getUID();
+        share_facade.switchContext("BASE");
+        assert(share_facade.makeInst(add, 0)->getUID() == add_uid);
+        assert(share_facade.lookupInstructionUniqueID("add") == add_uid);
+        share_facade.switchContext("OWN_UIDS");
+        assert(share_facade.makeInst(add, 0)->getUID() != add_uid);
+
+        // Fingerprints do not depend on UIDs
+        const uint64_t fingerprint = share_facade.getContextFingerprint();
+        share_facade.switchContext("SAME_UIDS");
+        assert(share_facade.getContextFingerprint() == fingerprint);
+    }
+
+    //
+    // Per-hart context handles: decode in a context without switching to it, and switch by handle
+    //
+    {
+        const mavis::ContextHandle base = mavis_facade.getContextHandle("BASE");
+        const mavis::ContextHandle pseudo = mavis_facade.getContextHandle("PSEUDO");
+        assert(base.isValid() && pseudo.isValid() && (base != pseudo));
+        assert(mavis_facade.getContextHandle("BASE") == base);
+        assert(mavis_facade.getCurrentContext() == base);
+
+        // c.addi x1, 1 is only in BASE; add x1, x2, x3 is in both
+        ExampleTraceInfo trace_add{"add", 0x003100b3};
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            assert(mavis_facade.makeInst(base, 0x0085, 0)->getMnemonic() == "c.addi");
+            assert(mavis_facade.makeInst(pseudo, 0x003100b3, 0)->getMnemonic() == "add");
+            assert(mavis_facade.makeInstFromTrace(pseudo, trace_add, 0)->getMnemonic() == "add");
+            assert(mavis_facade.getInfo(base, 0x0085)->opinfo->getMnemonic() == "c.addi");
+            bool caught = false;
+            try
+            {
+                mavis_facade.makeInst(pseudo, 0x0085, 0);
+            }
+            catch (const mavis::UnknownOpcode &)
+            {
+                caught = true;
+            }
+            assert(caught);
+        }
+        char buf[64];
+        mavis_facade.dasmTo(pseudo, 0x003100b3, buf, sizeof(buf));
+        std::cout << "Context handles: " << buf << std::endl;
+
+        // The current context is untouched by the handle-taking calls
+        assert(mavis_facade.getCurrentContext() == base);
+
+        mavis_facade.switchContext(pseudo);
+        assert(mavis_facade.getCurrentContext() == pseudo);
+        assert(mavis_facade.lookupInstructionUniqueID("c.addi") == mavis::INVALID_UID);
+        mavis_facade.switchContext(base);
+        assert(mavis_facade.makeInst(0x0085, 0)->getMnemonic() == "c.addi");
+        // Switching to the current context leaves it as it is
+        mavis_facade.switchContext(base);
+        assert(mavis_facade.getCurrentContext() == base);
+        assert(mavis_facade.makeInst(0x0085, 0)->getMnemonic() == "c.addi");
+
+        bool caught = false;
+        try
+        {
+            mavis_facade.switchContext(mavis::ContextHandle{});
+        }
+        catch (const mavis::UnknownContext &)
+        {
+            caught = true;
+        }
+        assert(caught && (mavis_facade.getCurrentContext() == base));
+    }
+
+    //
+    // Selective cache invalidation
+    //
+    {
+        // add x1,x2,x3; sub x1,x2,x3; addi x1,x2,1 (overlaid as mv when the immediate is 0)
+        const mavis::Opcode add = 0x003100b3, sub = 0x403100b3, addi = 0x00110093, mv = 0x00010093;
+        // Held, so that a new decode cannot reuse an old one's address
+        using InfoMap = std::map<mavis::Opcode, decltype(mavis_facade.getInfo(add))>;
+        const auto info = [&](mavis::Opcode icode) { return mavis_facade.getInfo(icode); };
+        const auto warm = [&]()
+        {
+            InfoMap infos;
+            for (const auto icode : {add, sub, addi, mv})
+            {
+                infos[icode] = info(icode);
+                mavis_facade.getOpcodeClass(icode);
+                mavis_facade.makeInst(icode, 0);
+            }
+            return infos;
+        };
+        const auto still_warm = [&](const InfoMap & infos,
+                                    std::initializer_list<mavis::Opcode> icodes)
+        {
+            for (const auto icode : icodes)
+            {
+                assert(info(icode) == infos.at(icode));
+            }
+        };
+        const auto gone_cold = [&](const InfoMap & infos,
+                                   std::initializer_list<mavis::Opcode> icodes)
+        {
+            for (const auto icode : icodes)
+            {
+                assert(info(icode) != infos.at(icode));
+            }
+        };
+
+        auto infos = warm();
+        mavis_facade.invalidateOpcode(add);
+        still_warm(infos, {sub, addi, mv});
+        gone_cold(infos, {add});
+        assert(mavis_facade.makeInst(add, 0)->getMnemonic() == "add");
+
+        // funct7 == 0x20 (sub, sra, ...)
+        infos = warm();
+        mavis_facade.invalidateOpcodes(0xfe000000, 0x40000000);
+        still_warm(infos, {add, addi, mv});
+        gone_cold(infos, {sub});
+
+        // By UID: the mv overlay is a different instruction from addi
+        infos = warm();
+        mavis_facade.invalidateInst("mv");
+        still_warm(infos, {add, sub, addi});
+        gone_cold(infos, {mv});
+        assert(mavis_facade.makeInst(mv, 0)->getMnemonic() == "mv");
+        infos = warm();
+        mavis_facade.invalidateInst(mavis_facade.lookupInstructionUniqueID("addi"));
+        still_warm(infos, {add, sub, mv});
+        gone_cold(infos, {addi});
+
+        // Annotations only: the decodes stay
+        infos = warm();
+        mavis_facade.invalidateAnnotations("add");
+        mavis_facade.invalidateAnnotations();
+        still_warm(infos, {add, sub, addi, mv});
+        assert(mavis_facade.makeInst(add, 0)->getMnemonic() == "add");
+
+        bool caught = false;
+        try
+        {
+            mavis_facade.invalidateInst("not.an.inst");
+        }
+        catch (const mavis::UnknownMnemonic &)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        // Blocks holding an invalidated instruction are dropped, the others stay
+        std::vector<uint32_t> code = {add, 0x00008067, sub, 0x00008067};
+        uint32_t fetches = 0;
+        const auto fetch = [&](uint64_t addr) -> uint32_t
+        {
+            ++fetches;
+            return code.at((addr - 0x2000) / 4);
+        };
+        mavis_facade.flushBlocks();
+        mavis_facade.getBlock(0x2000, fetch, 0);
+        mavis_facade.getBlock(0x2008, fetch, 0);
+        assert(fetches == 4);
+        mavis_facade.invalidateInst("sub");
+        mavis_facade.getBlock(0x2000, fetch, 0);
+        assert(fetches == 4);
+        mavis_facade.getBlock(0x2008, fetch, 0);
+        assert(fetches == 6);
+        std::cout << "Selective invalidation: OK" << std::endl;
+    }
+
+    //
+    // Warm decode caches: opcodes recorded in one run are saved, and decoded again by the next
+    //
+    {
+        const std::string path = "warm_cache.bin";
+        const std::vector<mavis::Opcode> icodes = {0x0085, 0x00110093, 0x003100b3, 0x403100b3};
+
+        mavis_facade.recordOpcodes();
+        for (uint32_t i = 0; i < 2; ++i)
+        {
+            for (const auto icode : icodes)
+            {
+                mavis_facade.makeInst(icode, 0);
+            }
+        }
+        mavis_facade.saveWarmCache(path);
+        mavis_facade.recordOpcodes(false);
+        assert(std::ifstream(path, std::ios::binary | std::ios::ate).tellg() == (24 + (4 * 4)));
+
+        // The next run: everything in the file is decoded (and recorded again)
+        mavis_facade.flushCaches();
+        mavis_facade.recordOpcodes();
+        assert(mavis_facade.loadWarmCache(path, 0) == icodes.size());
+        const std::string resaved = path + ".2";
+        mavis_facade.saveWarmCache(resaved);
+        mavis_facade.recordOpcodes(false);
+        std::ifstream a(path, std::ios::binary), b(resaved, std::ios::binary);
+        assert(std::equal(std::istreambuf_iterator<char>(a), std::istreambuf_iterator<char>(),
+                          std::istreambuf_iterator<char>(b)));
+
+        // Another decode table rejects the file
+        mavis_facade.switchContext("PSEUDO");
+        assert(mavis_facade.getContextFingerprint() != 0);
+        bool stale = false;
+        try
+        {
+            mavis_facade.loadWarmCache(path, 0);
+        }
+        catch (const mavis::StaleWarmCacheFile &)
+        {
+            stale = true;
+        }
+        assert(stale);
+        mavis_facade.switchContext("BASE");
+
+        // A file whose size does not match its header
+        std::ofstream(resaved, std::ios::binary) << std::ifstream(path, std::ios::binary).rdbuf();
+        std::ofstream(resaved, std::ios::binary | std::ios::app) << 'x';
+        bool bad = false;
+        try
+        {
+            mavis_facade.loadWarmCache(resaved, 0);
+        }
+        catch (const mavis::BadWarmCacheFile & ex)
+        {
+            std::cout << "Warm cache: " << ex.what() << std::endl;
+            bad = true;
+        }
+        assert(bad);
+        std::remove(path.c_str());
+        std::remove(resaved.c_str());
+    }
+
+    //
+    // Prewarming the decode caches from text
+    //
+    {
+        // addi; c.addi; add; (undecodable); beq; c.jr; add; c.jr; half of an addi
+        const std::vector<uint16_t> halves = {0x0093, 0x0010, 0x0085, 0x81b3, 0x0020,
+                                              0xffff, 0xffff, 0x8463, 0x0020, 0x8082,
+                                              0x81b3, 0x0020, 0x8082, 0x0093};
+        std::vector<uint8_t> text;
+        for (const uint16_t half : halves)
+        {
+            text.push_back(half & 0xff);
+            text.push_back(half >> 8);
+        }
+        const uint64_t base = 0x4000;
+
+        for (const uint32_t threads : {1, 3})
+        {
+            mavis_facade.flushCaches();
+            mavis::PrewarmOptions options;
+            options.threads = threads;
+            options.chunk_bytes = 4;
+            const mavis::PrewarmStats stats =
+                mavis_facade.prewarm(text.data(), text.size(), base, options, 0);
+            std::cout << "Prewarm (" << threads << " threads): " << stats.insts << " insts, "
+                      << stats.opcodes << " opcodes, " << stats.illegal << " illegal, "
+                      << stats.blocks << " blocks" << std::endl;
+            assert((stats.insts == 8) && (stats.opcodes == 5) && (stats.illegal == 1));
+            assert(stats.blocks == 4);
+        }
+
+        // Chunks cut at fixed offsets, in parallel, sweep the same instructions as one sweep
+        {
+            std::vector<uint8_t> random_text(4096 + 3);
+            uint32_t lcg = 1;
+            for (auto & byte : random_text)
+            {
+                lcg = lcg * 1664525 + 1013904223;
+                byte = lcg >> 24;
+            }
+            const std::vector<mavis::TextRegion> regions = {
+                {random_text.data(), random_text.size(), 0}, {random_text.data() + 1, 999, 0x10000}};
+            uint64_t one_insts = 0;
+            const auto one = mavis::TextScanner::collectOpcodes(regions, 1, ~0ull, one_insts);
+            for (const uint64_t chunk_bytes : {4, 6, 64})
+            {
+                uint64_t insts = 0;
+                assert(mavis::TextScanner::collectOpcodes(regions, 4, chunk_bytes, insts) == one);
+                assert(insts == one_insts);
+
+                // The spans follow each other from the start of each region, over whole
+                // instructions
+                const auto spans = mavis::TextScanner::splitRegions(regions, 4, chunk_bytes);
+                uint64_t span_insts = 0;
+                for (size_t s = 0; s < spans.size(); ++s)
+                {
+                    const bool first = (s == 0) || (spans[s - 1].region != spans[s].region);
+                    assert(spans[s].begin == (first ? 0 : spans[s - 1].end));
+                    for (uint64_t off = spans[s].begin; off < spans[s].end; ++span_insts)
+                    {
+                        off += mavis::TextScanner::instLength(
+                            mavis::TextScanner::readU16(spans[s].region->data + off));
+                    }
+                    assert(spans[s].end <= spans[s].region->size);
+                }
+                assert(span_insts == one_insts);
+            }
+        }
+
+        // Blocks along the sweep are cached
+        uint32_t fetches = 0;
+        const auto fetch = [&](uint64_t addr) -> uint32_t
+        {
+            ++fetches;
+            return mavis::TextScanner::fetch({text.data(), text.size(), base}, addr - base);
+        };
+        assert(mavis_facade.getBlock(base, fetch, 0).insts.size() == 3);
+        assert(mavis_facade.getBlock(base + 14, fetch, 0).ends_in_control_flow);
+        assert(fetches == 0);
+
+        // Undecodable opcodes are negatively cached, and keep throwing the same exception. The
+        // cache is direct mapped: the second opcode evicts the first, which throws again
+        for (const mavis::Opcode icode : {0xffffffffu, 0xffffffffu, 0xfffe007fu, 0xffffffffu})
+        {
+            bool caught = false;
+            try
+            {
+                mavis_facade.makeInst(icode, 0);
+            }
+            catch (const mavis::UnknownOpcode &)
+            {
+                caught = true;
+            }
+            assert(caught);
+        }
+        mavis_facade.flushCaches();
+    }
+
+    //
+    // Decode pipeline: batches decoded on worker threads, and taken back in order
+    //
+    {
+        using PipelineType = mavis::DecodePipeline<MavisType>;
+        const auto make_decoder = [](const mavis::InstUIDList & uid_list)
+        {
+            return std::make_unique<MavisType>(mavis::FileNameListType{"json/isa_rv64i.json"},
+                                               mavis::FileNameListType{"uarch/uarch_rv64g.json"},
+                                               uid_list);
+        };
+        const auto decode = [](MavisType & m, mavis::Opcode icode) { return m.makeInst(icode, 0); };
+
+        // Batch b is addi x1, x2, b+1 (and an undecodable opcode every 8th batch)
+        const uint32_t num_batches = 200;
+        const auto make_batch = [](uint32_t b)
+        {
+            std::vector<mavis::Opcode> icodes(4, (mavis::Opcode(b + 1) << 20) | 0x10093);
+            if ((b % 8) == 0)
+            {
+                icodes.push_back(0xffffffff);
+            }
+            return icodes;
+        };
+
+        // The consumer's own decoder: the SPIN run is given its UIDs
+        const auto consumer_decoder = make_decoder({});
+        const mavis::InstructionUniqueID consumer_addi_uid =
+            consumer_decoder->lookupInstructionUniqueID("addi");
+
+        for (const auto wait : {mavis::WaitPolicy::BLOCK, mavis::WaitPolicy::SPIN})
+        {
+            PipelineType::Options options;
+            options.workers = 3;
+            options.ring_capacity = 2;
+            options.wait = wait;
+            if (wait == mavis::WaitPolicy::SPIN)
+            {
+                options.uid_list = consumer_decoder->getInstUIDList();
+            }
+            PipelineType pipeline(make_decoder, decode, options);
+
+            std::thread producer(
+                [&]()
+                {
+                    for (uint32_t b = 0; b < num_batches; ++b)
+                    {
+                        pipeline.submit(make_batch(b));
+                    }
+                    pipeline.close();
+                });
+
+            PipelineType::DecodedBatch batch;
+            uint32_t taken = 0;
+            uint32_t undecodable = 0;
+            mavis::InstructionUniqueID addi_uid = mavis::INVALID_UID;
+            while (pipeline.next(batch))
+            {
+                assert(batch.icodes == make_batch(taken));
+                assert(batch.insts.size() == batch.icodes.size());
+                for (size_t i = 0; i < batch.insts.size(); ++i)
+                {
+                    if (batch.icodes[i] == 0xffffffff)
+                    {
+                        assert(batch.insts[i] == nullptr);
+                        ++undecodable;
+                    }
+                    else
+                    {
+                        assert(batch.insts[i]->getMnemonic() == "addi");
+
+                        // Every worker numbers addi the same
+                        if (addi_uid == mavis::INVALID_UID)
+                        {
+                            addi_uid = batch.insts[i]->getUID();
+                        }
+                        assert(batch.insts[i]->getUID() == addi_uid);
+                    }
+                }
+                ++taken;
+            }
+            producer.join();
+            assert((taken == num_batches) && (undecodable == (num_batches / 8)));
+            assert((addi_uid == consumer_addi_uid) == (wait == mavis::WaitPolicy::SPIN));
+        }
+
+        // A decoder build error is reported by the constructor
+        bool build_failed = false;
+        try
+        {
+            PipelineType::Options options;
+            options.workers = 2;
+            PipelineType bad_pipeline(
+                [](const mavis::InstUIDList & uid_list)
+                {
+                    return std::make_unique<MavisType>(
+                        mavis::FileNameListType{"json/no_such_isa.json"},
+                        mavis::FileNameListType{"uarch/uarch_rv64g.json"}, uid_list);
+                },
+                decode, options);
+        }
+        catch (const std::exception &)
+        {
+            build_failed = true;
+        }
+        assert(build_failed);
+
+        // Backpressure: with no consumer, submissions fail once the rings are full
+        PipelineType::Options options;
+        options.ring_capacity = 1;
+        PipelineType pipeline(make_decoder, decode, options);
+        uint32_t accepted = 0;
+        for (uint32_t b = 0; b < 16; ++b)
+        {
+            std::vector<mavis::Opcode> icodes = make_batch(b);
+            accepted += pipeline.trySubmit(icodes);
+        }
+        assert((accepted >= 1) && (accepted <= 3));
+        std::cout << "Decode pipeline: OK" << std::endl;
+    }
+
+    // Instruction-mix histogram
+    {
+        using MixMavisType = Mavis<Instruction<uArchInfo>, uArchInfo,
+                                   mavis::SharedPtrAllocator<Instruction<uArchInfo>>,
+                                   mavis::SharedPtrAllocator<uArchInfo>, mavis::InstMixEnabled>;
+        const MixMavisType::FileNameListType isa_files{"json/isa_rv64i.json",
+                                                       "json/isa_rv64m.json"};
+        const MixMavisType::FileNameListType anno_files{"uarch/uarch_rv64g.json"};
+        MixMavisType mix_facade(isa_files, anno_files, MixMavisType::InstUIDList{});
+
+        const mavis::Opcode add_icode = 0x003100b3; // add x1, x2, x3
+        const mavis::Opcode sub_icode = 0x403100b3; // sub x1, x2, x3
+        const mavis::Opcode div_icode = 0x0220c0b3; // div x1, x1, x2
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            mix_facade.makeInst(add_icode, 0);
+        }
+        mix_facade.makeInst(sub_icode, 0);
+        mix_facade.getInfo(div_icode);
+        mix_facade.makeInst(mix_facade.getCurrentContext(), div_icode, 0);
+        try
+        {
+            mix_facade.makeInst(0xffffffff, 0);
+            assert(false);
+        }
+        catch (const mavis::UnknownOpcode &)
+        {
+        }
+
+        // Cache fills are not counted
+        const std::vector<uint32_t> text = {add_icode, sub_icode, div_icode};
+        mix_facade.prewarm(reinterpret_cast<const uint8_t*>(text.data()), text.size() * 4, 0x1000,
+                           mavis::PrewarmOptions(), 0);
+
+        mavis::InstMix mix = mix_facade.getInstMix();
+        assert(mix.getTotal() == 6);
+        assert(mix.getCount("add") == 3);
+        assert(mix.getCount("sub") == 1);
+        assert(mix.getCount("div") == 2);
+        assert(mix.getEntries().at("add").uid
+               == mix_facade.lookupInstructionUniqueID("add"));
+        assert(mix.byInstType().at("int") == 6);
+        assert(mix.byInstType().at("div") == 2);
+        assert(mix.byTag().at("m") == 2);
+
+        // Another thread's decoder: merged by mnemonic
+        MixMavisType other_facade(isa_files, anno_files, MixMavisType::InstUIDList{});
+        std::thread([&other_facade, add_icode]
+                    { other_facade.makeInst(add_icode, 0); })
+            .join();
+        mix.merge(other_facade.getInstMix());
+        assert(mix.getTotal() == 7);
+        assert(mix.getCount("add") == 4);
+
+        // The ISA JSON has no "isa" stanzas, so there are no extensions to aggregate by
+        std::ostringstream json;
+        mix.writeJSON(json);
+        assert(json.str().find("\"types\": {\"arith\": 5, \"div\": 2, \"int\": 7}")
+               != std::string::npos);
+        assert(json.str().find("\"tags\": {\"g\": 7, \"i\": 5, \"m\": 2}")
+               != std::string::npos);
+        std::ostringstream csv;
+        mix.writeCSV(csv);
+        assert(csv.str().find("div," + std::to_string(mix.getEntries().at("div").uid)
+                              + ",2,,div int,g m\n")
+               != std::string::npos);
+
+        mix_facade.resetInstMix();
+        assert(mix_facade.getInstMix().getTotal() == 0);
+        std::cout << "Instruction mix: OK" << std::endl;
+    }
+
     return 0;
 }
@@ -1,6 +1,13 @@
 // Defining this enables additional circular dependency sanity checking via boost::graph
 #define ENABLE_GRAPH_SANITY_CHECKER
 #include "mavis/extension_managers/RISCVExtensionManager.hpp"
+#include "mavis/Mavis.h"
+#include "mavis/ELFText.hpp"
+
+#include "Inst.h"
+#include "uArchInfo.h"
+
+using MavisType = Mavis<Instruction<uArchInfo>, uArchInfo>;
 
 template <typename ExpectedExceptionType, typename Callback>
 void testException(Callback && callback)
@@ -66,6 +73,38 @@ int main(int argc, char* argv[])
             "hello", "json/riscv_isa_spec.json", "json");
     }
 
+    {
+        // Test prewarming a decoder from the executable sections of an ELF: chunks scanned in
+        // parallel find the same instructions as one sweep
+        const auto elf_man = mavis::extension_manager::riscv::RISCVExtensionManager::fromELF(
+            "hello", "json/riscv_isa_spec.json", "json");
+        const mavis::ELFText text("hello");
+        assert(!text.getRegions().empty());
+
+        MavisType one_mavis(elf_man.getJSONs(), {"uarch/uarch_rv64g.json"});
+        const mavis::PrewarmStats one = one_mavis.prewarm(text.getRegions(), {}, 0);
+        assert((one.insts > 0) && (one.opcodes > 0) && (one.blocks > 0));
+
+        MavisType mavis(elf_man.getJSONs(), {"uarch/uarch_rv64g.json"});
+        mavis::PrewarmOptions options;
+        options.threads = 4;
+        options.chunk_bytes = 64;
+        const mavis::PrewarmStats stats = mavis::prewarmFromELF(mavis, "hello", options, 0);
+        assert((stats.insts == one.insts) && (stats.opcodes == one.opcodes)
+               && (stats.illegal == one.illegal) && (stats.blocks == one.blocks));
+
+        testException<mavis::BadELFFile>([]() { mavis::ELFText("hello.c"); });
+
+        // Data in an executable section (from $d to the next $x) is not text: .text of
+        // mixed_rv64.o is code, 10 bytes of data, and code again
+        const mavis::ELFText mixed("mixed_rv64.o");
+        const std::vector<mavis::TextRegion> & regions = mixed.getRegions();
+        assert((mixed.getSections().size() == 1) && (regions.size() == 2));
+        assert(regions[1].address == (regions[0].address + regions[0].size + 10));
+        assert(regions[1].data == (regions[0].data + regions[0].size + 10));
+        assert(mixed.getSections()[0].map.isData(regions[0].address + regions[0].size));
+    }
+
     {
         // Test reusing the same object with a new ISA string
         auto rv_generic_man =